@@ -460,12 +460,48 @@ macro(dune_probe_functions)
     "sys/types.h;sys/select.h;winsock2.h"
     DUNE_SYS_HAS_SELECT)
 
+  dune_test_function(epoll_create1
+    "int"
+    "int"
+    "sys/epoll.h"
+    DUNE_SYS_HAS_EPOLL_CREATE1)
+
+  dune_test_function(timerfd_create
+    "int"
+    "int;int"
+    "sys/timerfd.h"
+    DUNE_SYS_HAS_TIMERFD_CREATE)
+
+  dune_test_function(eventfd
+    "int"
+    "unsigned int;int"
+    "sys/eventfd.h"
+    DUNE_SYS_HAS_EVENTFD)
+
   dune_test_function(sendfile
     "ssize_t"
     "int;int;off_t*;size_t"
     "sys/sendfile.h"
     DUNE_SYS_HAS_LINUX_SENDFILE)
 
+  dune_test_function(sendmsg
+    "ssize_t"
+    "int;struct msghdr*;int"
+    "sys/types.h;sys/socket.h"
+    DUNE_SYS_HAS_SENDMSG)
+
+  dune_test_function(sendmmsg
+    "int"
+    "int;struct mmsghdr*;unsigned int;int"
+    "sys/types.h;sys/socket.h"
+    DUNE_SYS_HAS_SENDMMSG)
+
+  dune_test_function(recvmmsg
+    "int"
+    "int;struct mmsghdr*;unsigned int;int;struct timespec*"
+    "sys/types.h;sys/socket.h"
+    DUNE_SYS_HAS_RECVMMSG)
+
   dune_test_function(settimeofday
     "int"
     "struct timeval*;struct timezone*"
@@ -700,6 +736,30 @@ macro(dune_probe_functions)
     ""
     DUNE_SYS_HAS___SYNC_SUB_AND_FETCH)
 
+  dune_test_function(__sync_bool_compare_and_swap
+    "bool"
+    "long*;long;long"
+    ""
+    DUNE_SYS_HAS___SYNC_BOOL_COMPARE_AND_SWAP)
+
+  dune_test_function(__sync_synchronize
+    "void"
+    ""
+    ""
+    DUNE_SYS_HAS___SYNC_SYNCHRONIZE)
+
+  dune_test_function(fsync
+    "int"
+    "int"
+    "unistd.h"
+    DUNE_SYS_HAS_FSYNC)
+
+  dune_test_function(fdatasync
+    "int"
+    "int"
+    "unistd.h"
+    DUNE_SYS_HAS_FDATASYNC)
+
   dune_test_function(fork
     "pid_t"
     ""
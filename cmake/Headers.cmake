@@ -130,6 +130,9 @@ macro(dune_probe_headers)
   dune_test_header(sys/vfs.h)
   dune_test_header(sys/statvfs.h)
   dune_test_header(sys/syscall.h)
+  dune_test_header(sys/eventfd.h)
+  dune_test_header(sys/epoll.h)
+  dune_test_header(sys/timerfd.h)
   dune_test_header(termios.h)
   dune_test_header(unistd.h)
   dune_test_header(windows.h)
@@ -159,6 +162,7 @@ macro(dune_probe_headers)
   dune_test_header_deps(sys/sysctl.h "sys/types.h")
   dune_test_header_deps(sys/resource.h "sys/types.h")
   dune_test_header_deps(sys/mman.h "sys/types.h")
+  dune_test_header_deps(sys/uio.h "sys/types.h")
   dune_test_header_deps(net/if.h "sys/types.h;sys/socket.h")
   dune_test_header_deps(timepps.h "unistd.h")
   dune_test_header_deps(iphlpapi.h "windows.h")
@@ -0,0 +1,191 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+// Benchmark of message bus dispatch cost versus fan-out width.             *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+using DUNE_NAMESPACES;
+
+//! Minimal task that owns a recipient queue.
+class Sink: public Tasks::AbstractTask
+{
+public:
+  Sink(Tasks::Context& ctx, unsigned capacity):
+    m_recipient(this, ctx),
+    m_count(0)
+  {
+    m_recipient.setCapacity(capacity);
+    m_recipient.bind(IMC::EstimatedState::getIdStatic(),
+                     new Tasks::Consumer<Sink, IMC::EstimatedState>(*this, &Sink::consume));
+    m_recipient.bind(IMC::CompressedImage::getIdStatic(),
+                     new Tasks::Consumer<Sink, IMC::CompressedImage>(*this, &Sink::consume));
+  }
+
+  ~Sink(void)
+  {
+    m_recipient.unbindAll();
+  }
+
+  void
+  receive(const IMC::Message* msg)
+  {
+    m_recipient.put(msg);
+  }
+
+  void
+  receive(const IMC::SharedMessage& msg)
+  {
+    m_recipient.put(msg);
+  }
+
+  void
+  consume(const IMC::EstimatedState* msg)
+  {
+    m_count += (msg->x != 0.0);
+  }
+
+  void
+  consume(const IMC::CompressedImage* msg)
+  {
+    m_count += msg->data.size();
+  }
+
+  void
+  drain(void)
+  {
+    m_recipient.runCallBacks();
+  }
+
+  const char*
+  getName(void) const
+  {
+    return "Sink";
+  }
+
+  void inf(const char*, ...) { }
+  void war(const char*, ...) { }
+  void err(const char*, ...) { }
+  void cri(const char*, ...) { }
+  void debug(const char*, ...) { }
+  void trace(const char*, ...) { }
+  void spew(const char*, ...) { }
+
+private:
+  Tasks::Recipient m_recipient;
+  uint64_t m_count;
+
+  void
+  run(void)
+  { }
+};
+
+//! Deliver a message the way the bus did before shared messages:
+//! one private copy per recipient.
+static void
+dispatchCopy(std::vector<Sink*>& sinks, const IMC::Message* msg)
+{
+  for (unsigned i = 0; i < sinks.size(); ++i)
+    sinks[i]->receive(msg);
+}
+
+static double
+measure(Tasks::Context& ctx, std::vector<Sink*>& sinks, const IMC::Message* msg,
+        unsigned count, bool shared)
+{
+  uint64_t start = Clock::getNsec();
+
+  for (unsigned i = 0; i < count; ++i)
+  {
+    if (shared)
+      ctx.mbus.dispatch(msg);
+    else
+      dispatchCopy(sinks, msg);
+  }
+
+  for (unsigned i = 0; i < sinks.size(); ++i)
+    sinks[i]->drain();
+
+  return (Clock::getNsec() - start) / (double)count;
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned count = 20000;
+  if (argc > 1)
+    count = std::atoi(argv[1]);
+
+  Tasks::Context ctx;
+
+  IMC::EstimatedState state;
+  state.x = 1.0;
+  state.setTimeStamp();
+
+  IMC::CompressedImage image;
+  image.data.resize(32 * 1024, 'x');
+  image.setTimeStamp();
+
+  const unsigned c_widths[] = {1, 2, 4, 8, 16, 32, 64};
+  const unsigned c_widths_count = sizeof(c_widths) / sizeof(c_widths[0]);
+
+  std::cout << std::setw(8) << "fan-out"
+            << std::setw(16) << "state/copy"
+            << std::setw(16) << "state/shared"
+            << std::setw(16) << "image/copy"
+            << std::setw(16) << "image/shared"
+            << "  (ns per publish)" << std::endl;
+
+  for (unsigned w = 0; w < c_widths_count; ++w)
+  {
+    std::vector<Sink*> sinks;
+    for (unsigned i = 0; i < c_widths[w]; ++i)
+      sinks.push_back(new Sink(ctx, count));
+
+    std::cout << std::setw(8) << c_widths[w]
+              << std::fixed << std::setprecision(0)
+              << std::setw(16) << measure(ctx, sinks, &state, count, false)
+              << std::setw(16) << measure(ctx, sinks, &state, count, true)
+              << std::setw(16) << measure(ctx, sinks, &image, count / 10, false)
+              << std::setw(16) << measure(ctx, sinks, &image, count / 10, true)
+              << std::endl;
+
+    for (unsigned i = 0; i < sinks.size(); ++i)
+      delete sinks[i];
+  }
+
+  return 0;
+}
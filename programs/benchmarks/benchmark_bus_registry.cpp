@@ -0,0 +1,242 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+// Benchmark of message bus recipient lookup under concurrent publishers.   *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <list>
+#include <map>
+#include <vector>
+#include <cstdlib>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+using DUNE_NAMESPACES;
+
+//! Task that discards everything it receives, so that only the cost
+//! of looking up recipients is measured.
+class NullTask: public Tasks::AbstractTask
+{
+public:
+  void receive(const IMC::Message*) { }
+  void receive(const IMC::SharedMessage&) { }
+
+  const char*
+  getName(void) const
+  {
+    return "NullTask";
+  }
+
+  void inf(const char*, ...) { }
+  void war(const char*, ...) { }
+  void err(const char*, ...) { }
+  void cri(const char*, ...) { }
+  void debug(const char*, ...) { }
+  void trace(const char*, ...) { }
+  void spew(const char*, ...) { }
+
+private:
+  void
+  run(void)
+  { }
+};
+
+//! Recipient registry as implemented by the bus before the flat
+//! table: a map of lists protected by a read-write lock.
+class LegacyRegistry
+{
+public:
+  LegacyRegistry(void):
+    m_paused(false)
+  { }
+
+  void
+  registerRecipient(Tasks::AbstractTask* task, uint16_t id)
+  {
+    Concurrency::ScopedRWLock l(m_lock, true);
+    m_recipients[id].push_back(task);
+  }
+
+  void
+  dispatch(const IMC::SharedMessage& msg, Tasks::AbstractTask* task)
+  {
+    {
+      Concurrency::ScopedMutex lock(m_paused_lock);
+      if (m_paused)
+        return;
+    }
+
+    Concurrency::ScopedRWLock l(m_lock);
+    std::map<uint16_t, TaskList>::iterator itr = m_recipients.find(msg->getId());
+    if (itr == m_recipients.end())
+      return;
+
+    for (TaskList::iterator t = itr->second.begin(); t != itr->second.end(); ++t)
+    {
+      if (*t != task)
+        (*t)->receive(msg);
+    }
+  }
+
+private:
+  typedef std::list<Tasks::AbstractTask*> TaskList;
+  std::map<uint16_t, TaskList> m_recipients;
+  Concurrency::RWLock m_lock;
+  //! The old bus checked its pause flag under a mutex on every
+  //! dispatch.
+  Concurrency::Mutex m_paused_lock;
+  bool m_paused;
+};
+
+//! Thread that publishes the same message a fixed number of times.
+class Publisher: public Concurrency::Thread
+{
+public:
+  Publisher(IMC::Bus* bus, LegacyRegistry* legacy, Concurrency::Barrier& barrier,
+            const IMC::SharedMessage& msg, unsigned count):
+    m_bus(bus),
+    m_legacy(legacy),
+    m_barrier(barrier),
+    m_msg(msg),
+    m_count(count)
+  { }
+
+private:
+  IMC::Bus* m_bus;
+  LegacyRegistry* m_legacy;
+  Concurrency::Barrier& m_barrier;
+  IMC::SharedMessage m_msg;
+  unsigned m_count;
+
+  void
+  run(void)
+  {
+    m_barrier.wait();
+
+    if (m_bus != NULL)
+    {
+      for (unsigned i = 0; i < m_count; ++i)
+        m_bus->dispatch(m_msg);
+    }
+    else
+    {
+      for (unsigned i = 0; i < m_count; ++i)
+        m_legacy->dispatch(m_msg, NULL);
+    }
+  }
+};
+
+//! Run publishers concurrently and return the average wall clock
+//! time per dispatch, in nanoseconds.
+static double
+measure(IMC::Bus* bus, LegacyRegistry* legacy, const std::vector<IMC::SharedMessage>& msgs,
+        unsigned threads, unsigned count)
+{
+  Concurrency::Barrier barrier(threads + 1);
+  std::vector<Publisher*> publishers;
+
+  for (unsigned i = 0; i < threads; ++i)
+  {
+    publishers.push_back(new Publisher(bus, legacy, barrier, msgs[i % msgs.size()], count));
+    publishers.back()->start();
+  }
+
+  barrier.wait();
+  uint64_t start = Clock::getNsec();
+
+  for (unsigned i = 0; i < threads; ++i)
+  {
+    publishers[i]->join();
+    delete publishers[i];
+  }
+
+  return (Clock::getNsec() - start) / ((double)count * threads);
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned count = 200000;
+  if (argc > 1)
+    count = std::atoi(argv[1]);
+
+  // Typical subscription profile: many message types, a few
+  // subscribers each.
+  const unsigned c_ids = 64;
+  const unsigned c_subscribers = 4;
+
+  std::vector<NullTask*> tasks;
+  for (unsigned i = 0; i < c_subscribers; ++i)
+    tasks.push_back(new NullTask);
+
+  IMC::Bus bus;
+  LegacyRegistry legacy;
+  std::vector<IMC::SharedMessage> msgs;
+
+  std::vector<uint32_t> ids;
+  IMC::Factory::getIds(ids);
+  for (unsigned i = 0; i < ids.size() && i < c_ids; ++i)
+  {
+    for (unsigned j = 0; j < c_subscribers; ++j)
+    {
+      bus.registerRecipient(tasks[j], ids[i]);
+      legacy.registerRecipient(tasks[j], ids[i]);
+    }
+
+    msgs.push_back(IMC::SharedMessage(IMC::Factory::produce(ids[i])));
+  }
+
+  const unsigned c_threads[] = {1, 8, 32};
+  const unsigned c_threads_count = sizeof(c_threads) / sizeof(c_threads[0]);
+
+  std::cout << std::setw(10) << "threads"
+            << std::setw(16) << "legacy"
+            << std::setw(16) << "flat table"
+            << "  (ns per dispatch)" << std::endl;
+
+  for (unsigned t = 0; t < c_threads_count; ++t)
+  {
+    unsigned per_thread = count / c_threads[t];
+
+    std::cout << std::setw(10) << c_threads[t]
+              << std::fixed << std::setprecision(1)
+              << std::setw(16) << measure(NULL, &legacy, msgs, c_threads[t], per_thread)
+              << std::setw(16) << measure(&bus, NULL, msgs, c_threads[t], per_thread)
+              << std::endl;
+  }
+
+  for (unsigned i = 0; i < tasks.size(); ++i)
+    delete tasks[i];
+
+  return 0;
+}
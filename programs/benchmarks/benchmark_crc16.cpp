@@ -0,0 +1,106 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+// Throughput of CRC-16-IBM computation versus buffer size.                 *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+using DUNE_NAMESPACES;
+
+//! Byte-wise CRC, as computed before slicing-by-8.
+static uint16_t
+computeBytewise(const uint8_t* buffer, uint16_t len, uint16_t crc)
+{
+  while (len--)
+    crc = Algorithms::CRC16::compute(*buffer++, crc);
+
+  return crc;
+}
+
+//! Measure throughput, in MiB/s.
+static double
+measure(const std::vector<uint8_t>& data, uint16_t size, uint64_t total, bool sliced, uint16_t& crc)
+{
+  unsigned rounds = (unsigned)(total / size) + 1;
+  uint64_t start = Clock::getNsec();
+
+  for (unsigned i = 0; i < rounds; ++i)
+  {
+    if (sliced)
+      crc = Algorithms::CRC16::compute(&data[0], size, crc);
+    else
+      crc = computeBytewise(&data[0], size, crc);
+  }
+
+  double elapsed = (Clock::getNsec() - start) / 1e9;
+  return ((double)rounds * size) / (elapsed * 1024 * 1024);
+}
+
+int
+main(int argc, char** argv)
+{
+  // Amount of data processed for each size.
+  uint64_t total = 256 * 1024 * 1024;
+  if (argc > 1)
+    total = std::atoi(argv[1]) * 1024 * 1024;
+
+  std::vector<uint8_t> data(65535);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = (uint8_t)(i * 131 + 7);
+
+  std::cout << std::setw(8) << "size"
+            << std::setw(14) << "byte-wise"
+            << std::setw(14) << "sliced"
+            << std::setw(10) << "speedup"
+            << "  (MiB/s)" << std::endl;
+
+  uint16_t crc = 0;
+  for (uint32_t size = 32; size <= 65536; size *= 2)
+  {
+    uint16_t len = (uint16_t)std::min(size, (uint32_t)data.size());
+    double bytewise = measure(data, len, total, false, crc);
+    double sliced = measure(data, len, total, true, crc);
+
+    std::cout << std::setw(8) << len
+              << std::fixed << std::setprecision(1)
+              << std::setw(14) << bytewise
+              << std::setw(14) << sliced
+              << std::setw(9) << sliced / bytewise << "x"
+              << std::endl;
+  }
+
+  return crc == 0xffff;
+}
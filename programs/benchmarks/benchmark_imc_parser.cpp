@@ -0,0 +1,126 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+// Throughput of IMC stream parsing, byte by byte and in blocks.            *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+using DUNE_NAMESPACES;
+
+//! Build a stream of serialized messages.
+static void
+buildStream(std::vector<uint8_t>& stream, size_t payload, size_t size)
+{
+  IMC::EstimatedState state;
+  IMC::CompressedImage image;
+  image.data.assign(payload, 'x');
+
+  while (stream.size() < size)
+  {
+    const IMC::Message* msg = &state;
+    if (payload > 0 && (stream.size() / 4096) % 2)
+      msg = &image;
+
+    std::vector<uint8_t> bfr(msg->getSerializationSize());
+    IMC::Packet::serialize(msg, &bfr[0], bfr.size());
+    stream.insert(stream.end(), bfr.begin(), bfr.end());
+  }
+}
+
+//! Parse a stream in reads of a given size, return MiB/s.
+static double
+measure(const std::vector<uint8_t>& stream, size_t chunk, bool block)
+{
+  IMC::Parser parser;
+  std::vector<IMC::Message*> msgs;
+  uint64_t start = Clock::getNsec();
+
+  for (size_t i = 0; i < stream.size(); i += chunk)
+  {
+    size_t n = std::min(chunk, stream.size() - i);
+
+    if (block)
+    {
+      parser.parse(&stream[i], n, msgs);
+      for (size_t j = 0; j < msgs.size(); ++j)
+        delete msgs[j];
+      msgs.clear();
+    }
+    else
+    {
+      for (size_t j = 0; j < n; ++j)
+        delete parser.parse(stream[i + j]);
+    }
+  }
+
+  double elapsed = (Clock::getNsec() - start) / 1e9;
+  return stream.size() / (elapsed * 1024 * 1024);
+}
+
+int
+main(int argc, char** argv)
+{
+  size_t size = 64 * 1024 * 1024;
+  if (argc > 1)
+    size = std::atoi(argv[1]) * 1024 * 1024;
+
+  std::cout << std::setw(12) << "payload"
+            << std::setw(14) << "byte-wise"
+            << std::setw(14) << "block"
+            << "  (MiB/s, 4 KiB reads)" << std::endl;
+
+  const size_t c_payloads[] = {0, 1024, 16384};
+  for (unsigned i = 0; i < sizeof(c_payloads) / sizeof(c_payloads[0]); ++i)
+  {
+    std::vector<uint8_t> stream;
+    buildStream(stream, c_payloads[i], size);
+
+    std::ostringstream label;
+    if (c_payloads[i])
+      label << "mixed/" << c_payloads[i];
+    else
+      label << "state";
+
+    std::cout << std::setw(12) << label.str()
+              << std::fixed << std::setprecision(1)
+              << std::setw(14) << measure(stream, 4096, false)
+              << std::setw(14) << measure(stream, 4096, true)
+              << std::endl;
+  }
+
+  return 0;
+}
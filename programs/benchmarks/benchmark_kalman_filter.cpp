@@ -0,0 +1,181 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+// Kalman filter predict and update cycle time.                             *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+using DUNE_NAMESPACES;
+
+//! Number of filter states.
+static const unsigned c_states = 9;
+//! Number of filter outputs.
+static const unsigned c_outputs = 4;
+
+//! Fill state transition, observation and noise matrices.
+static void
+setup(Math::Matrix& a, Math::Matrix& c, Math::Matrix& q, Math::Matrix& r)
+{
+  a.resizeAndFill(c_states, c_states, 0.0);
+  a.identity();
+  for (unsigned i = 0; i + 1 < c_states; ++i)
+    a(i, i + 1) = 0.01;
+
+  c.resizeAndFill(c_outputs, c_states, 0.0);
+  for (unsigned i = 0; i < c_outputs; ++i)
+    c(i, i * 2) = 1.0;
+
+  q.resizeAndFill(c_states, c_states, 0.0);
+  r.resizeAndFill(c_outputs, c_outputs, 0.0);
+  for (unsigned i = 0; i < c_states; ++i)
+    q(i, i) = 1e-3;
+  for (unsigned i = 0; i < c_outputs; ++i)
+    r(i, i) = 1e-1;
+}
+
+//! Filter cycle written with dynamically sized matrix expressions,
+//! as computed by the filter before in-place prediction.
+static double
+measureMatrix(unsigned rounds)
+{
+  Math::Matrix a, c, q, r;
+  setup(a, c, q, r);
+  Math::Matrix x(c_states, 1, 0.0);
+  Math::Matrix p(c_states);
+  Math::Matrix innov(c_outputs, 1, 0.01);
+
+  uint64_t start = Clock::getNsec();
+
+  for (unsigned i = 0; i < rounds; ++i)
+  {
+    x = a * x;
+    p = a * p * transpose(a) + q;
+
+    Math::Matrix S = (c * p * transpose(c)) + r;
+    Math::Matrix S_1 = inverse(S);
+    Math::Matrix K = p * transpose(c) * S_1;
+    x = x + K * innov;
+    p = p - K * c * p;
+  }
+
+  return (Clock::getNsec() - start) / (1e3 * rounds);
+}
+
+//! Filter cycle of the navigation Kalman filter.
+static double
+measureFilter(unsigned rounds)
+{
+  Math::Matrix a, c, q, r;
+  setup(a, c, q, r);
+
+  Navigation::KalmanFilter kal;
+  kal.reset(c_states, c_outputs);
+  kal.setTransitions(a);
+  for (unsigned i = 0; i < c_states; ++i)
+  {
+    kal.setCovariance(i, 1.0);
+    kal.setProcessNoise(i, q(i, i));
+  }
+
+  for (unsigned i = 0; i < c_outputs; ++i)
+  {
+    kal.setObservation(i, i * 2, 1.0);
+    kal.setMeasurementNoise(i, r(i, i));
+    kal.setInnovation(i, 0.01);
+  }
+
+  uint64_t start = Clock::getNsec();
+
+  for (unsigned i = 0; i < rounds; ++i)
+  {
+    kal.predict();
+    kal.update(0);
+  }
+
+  return (Clock::getNsec() - start) / (1e3 * rounds);
+}
+
+//! Filter cycle written with fixed-size matrices.
+static double
+measureFixed(unsigned rounds)
+{
+  Math::Matrix ma, mc, mq, mr;
+  setup(ma, mc, mq, mr);
+
+  Math::FixedMatrix<c_states, c_states> a(ma);
+  Math::FixedMatrix<c_outputs, c_states> c(mc);
+  Math::FixedMatrix<c_states, c_states> q(mq);
+  Math::FixedMatrix<c_outputs, c_outputs> r(mr);
+  Math::FixedMatrix<c_states, 1> x;
+  Math::FixedMatrix<c_states, c_states> p;
+  Math::FixedMatrix<c_outputs, 1> innov(0.01);
+  p.identity();
+
+  uint64_t start = Clock::getNsec();
+
+  for (unsigned i = 0; i < rounds; ++i)
+  {
+    x = a * x;
+    p = congruence(a, p, q);
+
+    Math::FixedMatrix<c_outputs, c_outputs> S_1 = inverse(congruence(c, p, r));
+    Math::FixedMatrix<c_states, c_outputs> K = p * transpose(c) * S_1;
+    x += K * innov;
+    p -= K * (c * p);
+  }
+
+  return (Clock::getNsec() - start) / (1e3 * rounds);
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned rounds = 100000;
+  if (argc > 1)
+    rounds = std::atoi(argv[1]);
+
+  double matrix = measureMatrix(rounds);
+  double filter = measureFilter(rounds);
+  double fixed = measureFixed(rounds);
+
+  std::cout << c_states << " states, " << c_outputs << " outputs, "
+            << rounds << " cycles (us per cycle)" << std::endl
+            << std::fixed << std::setprecision(3)
+            << std::setw(24) << "matrix expressions" << std::setw(10) << matrix << std::endl
+            << std::setw(24) << "KalmanFilter" << std::setw(10) << filter << std::endl
+            << std::setw(24) << "FixedMatrix" << std::setw(10) << fixed << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,152 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+// Accuracy and throughput of local tangent plane conversions.              *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+using DUNE_NAMESPACES;
+
+//! Reference latitude (rad).
+static const double c_lat = 0.7188;
+//! Reference longitude (rad).
+static const double c_lon = -0.1532;
+//! Reference height (m).
+static const double c_hae = 50.0;
+//! Radius of the area around the reference (m).
+static const double c_radius = 10000.0;
+
+//! Length of a NED error vector.
+static double
+length(double n, double e, double d)
+{
+  return std::sqrt(n * n + e * e + d * d);
+}
+
+//! Convert elapsed time to nanoseconds per conversion.
+static double
+perPoint(uint64_t start, size_t count)
+{
+  return (double)(Clock::getNsec() - start) / count;
+}
+
+int
+main(int argc, char** argv)
+{
+  size_t count = 1000000;
+  if (argc > 1)
+    count = std::atoi(argv[1]);
+
+  Math::Random::Generator* rng = Math::Random::Factory::create(Math::Random::Factory::c_default, 1);
+
+  std::vector<double> n(count), e(count), d(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    n[i] = rng->uniform(-c_radius, c_radius);
+    e[i] = rng->uniform(-c_radius, c_radius);
+    d[i] = rng->uniform(-100.0, 100.0);
+  }
+
+  delete rng;
+
+  Coordinates::LocalTangentPlane ltp(c_lat, c_lon, c_hae);
+  std::vector<double> lat(count), lon(count), hae(count);
+  std::vector<double> lat1(count), lon1(count), hae1(count);
+  std::vector<double> n1(count), e1(count), d1(count);
+
+  // Inverse conversion.
+  uint64_t start = Clock::getNsec();
+  for (size_t i = 0; i < count; ++i)
+  {
+    lat[i] = c_lat;
+    lon[i] = c_lon;
+    hae[i] = c_hae;
+    WGS84::displace(n[i], e[i], d[i], &lat[i], &lon[i], &hae[i]);
+  }
+  double displace = perPoint(start, count);
+
+  start = Clock::getNsec();
+  for (size_t i = 0; i < count; ++i)
+    ltp.fromNED(n[i], e[i], d[i], &lat1[i], &lon1[i], &hae1[i]);
+  double from_ned = perPoint(start, count);
+
+  start = Clock::getNsec();
+  ltp.fromNED(&n[0], &e[0], &d[0], count, &lat1[0], &lon1[0], &hae1[0]);
+  double from_ned_batch = perPoint(start, count);
+
+  // Forward conversion of the points found by the tangent plane.
+  start = Clock::getNsec();
+  for (size_t i = 0; i < count; ++i)
+    WGS84::displacement(c_lat, c_lon, c_hae, lat1[i], lon1[i], hae1[i], &n1[i], &e1[i], &d1[i]);
+  double displacement = perPoint(start, count);
+
+  start = Clock::getNsec();
+  for (size_t i = 0; i < count; ++i)
+    ltp.toNED(lat1[i], lon1[i], hae1[i], &n1[i], &e1[i], &d1[i]);
+  double to_ned = perPoint(start, count);
+
+  start = Clock::getNsec();
+  ltp.toNED(&lat1[0], &lon1[0], &hae1[0], count, &n1[0], &e1[0], &d1[0]);
+  double to_ned_batch = perPoint(start, count);
+
+  // Round trip errors (m).
+  double ltp_error = 0;
+  double wgs84_error = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    ltp_error = std::max(ltp_error, length(n1[i] - n[i], e1[i] - e[i], d1[i] - d[i]));
+
+    double dn, de, dd;
+    WGS84::displacement(c_lat, c_lon, c_hae, lat[i], lon[i], hae[i], &dn, &de, &dd);
+    wgs84_error = std::max(wgs84_error, length(dn - n[i], de - e[i], dd - d[i]));
+  }
+
+  std::cout << count << " points within " << c_radius << " m (ns per point)" << std::endl
+            << std::fixed << std::setprecision(1)
+            << std::setw(28) << "WGS84::displace" << std::setw(10) << displace << std::endl
+            << std::setw(28) << "fromNED" << std::setw(10) << from_ned << std::endl
+            << std::setw(28) << "fromNED (batch)" << std::setw(10) << from_ned_batch << std::endl
+            << std::setw(28) << "WGS84::displacement" << std::setw(10) << displacement << std::endl
+            << std::setw(28) << "toNED" << std::setw(10) << to_ned << std::endl
+            << std::setw(28) << "toNED (batch)" << std::setw(10) << to_ned_batch << std::endl
+            << "maximum round trip error (m)" << std::endl
+            << std::scientific << std::setprecision(3)
+            << std::setw(28) << "displace/displacement" << std::setw(12) << wgs84_error << std::endl
+            << std::setw(28) << "fromNED/toNED" << std::setw(12) << ltp_error << std::endl;
+
+  return 0;
+}
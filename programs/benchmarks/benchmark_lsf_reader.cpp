@@ -0,0 +1,216 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+// Throughput of LSF log reading: streams against memory mapped logs.       *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+using DUNE_NAMESPACES;
+
+//! Write a log of a given size with the usual mix of small and large
+//! messages.
+static void
+buildLog(const std::string& file, uint64_t size)
+{
+  std::ofstream ofs(file.c_str(), std::ios::binary);
+  IMC::EstimatedState state;
+  IMC::Temperature temp;
+  IMC::CompressedImage image;
+  image.data.assign(8192, 'x');
+  ByteBuffer bfr;
+
+  for (uint64_t written = 0, i = 0; written < size; ++i)
+  {
+    const IMC::Message* msg = &state;
+    if (i % 10 == 0)
+      msg = &temp;
+    else if (i % 50 == 0)
+      msg = &image;
+
+    IMC::Packet::serialize(msg, bfr);
+    ofs.write(bfr.getBufferSigned(), bfr.getSize());
+    written += bfr.getSize();
+  }
+}
+
+//! Count Temperature messages in a range of a memory mapped log.
+class TemperatureCounter: public Concurrency::Thread
+{
+public:
+  TemperatureCounter(const IMC::LsfReader& reader, const IMC::LsfReader::Range& range):
+    count(0),
+    m_reader(reader),
+    m_range(range)
+  { }
+
+  void
+  scan(void)
+  {
+    IMC::PacketView pkt;
+    uint64_t offset = m_range.first;
+    while (m_reader.next(offset, m_range.second, pkt))
+    {
+      if (pkt.getId() == DUNE_IMC_TEMPERATURE)
+        ++count;
+    }
+  }
+
+  unsigned count;
+
+private:
+  const IMC::LsfReader& m_reader;
+  IMC::LsfReader::Range m_range;
+
+  void
+  run(void)
+  {
+    scan();
+  }
+};
+
+//! Deserialize every packet from a stream, like the tools used to.
+static unsigned
+readStream(const std::string& file)
+{
+  std::ifstream ifs(file.c_str(), std::ios::binary);
+  unsigned count = 0;
+  IMC::Message* msg = NULL;
+  while ((msg = IMC::Packet::deserialize(ifs)) != NULL)
+  {
+    if (msg->getId() == DUNE_IMC_TEMPERATURE)
+      ++count;
+    delete msg;
+  }
+
+  return count;
+}
+
+//! Read packet headers from a stream.
+static unsigned
+readViews(const std::string& file)
+{
+  std::ifstream ifs(file.c_str(), std::ios::binary);
+  unsigned count = 0;
+  IMC::PacketView pkt;
+  while (pkt.read(ifs))
+  {
+    if (pkt.getId() == DUNE_IMC_TEMPERATURE)
+      ++count;
+  }
+
+  return count;
+}
+
+//! Scan a memory mapped log with a number of threads.
+static unsigned
+readMapped(const std::string& file, unsigned threads)
+{
+  IMC::LsfReader reader(file);
+  std::vector<IMC::LsfReader::Range> chunks;
+  reader.split(threads, chunks);
+
+  std::vector<TemperatureCounter*> counters;
+  for (size_t i = 0; i < chunks.size(); ++i)
+  {
+    counters.push_back(new TemperatureCounter(reader, chunks[i]));
+    if (chunks.size() == 1)
+      counters.back()->scan();
+    else
+      counters.back()->start();
+  }
+
+  unsigned count = 0;
+  for (size_t i = 0; i < counters.size(); ++i)
+  {
+    if (chunks.size() > 1)
+      counters[i]->join();
+    count += counters[i]->count;
+    delete counters[i];
+  }
+
+  return count;
+}
+
+//! Print the throughput of a reading method.
+static void
+report(const char* label, uint64_t size, uint64_t start, unsigned count)
+{
+  double elapsed = (Clock::getNsec() - start) / 1e9;
+  std::cout << std::setw(24) << label
+            << std::fixed << std::setprecision(1)
+            << std::setw(12) << size / (elapsed * 1024 * 1024) << " MiB/s"
+            << std::setw(12) << count << std::endl;
+}
+
+int
+main(int argc, char** argv)
+{
+  uint64_t size = 2048ULL * 1024 * 1024;
+  if (argc > 1)
+    size = std::atoi(argv[1]) * 1024ULL * 1024;
+
+  std::string file = "benchmark_lsf_reader.lsf";
+  if (argc > 2)
+    file = argv[2];
+
+  buildLog(file, size);
+
+  unsigned cpus = System::Resources::getProcessorCount();
+  std::cout << "log of " << (size >> 20) << " MiB, " << cpus << " processors" << std::endl;
+
+  uint64_t start = Clock::getNsec();
+  unsigned count = readStream(file);
+  report("stream deserialize", size, start, count);
+
+  start = Clock::getNsec();
+  count = readViews(file);
+  report("stream headers", size, start, count);
+
+  start = Clock::getNsec();
+  count = readMapped(file, 1);
+  report("mapped", size, start, count);
+
+  start = Clock::getNsec();
+  count = readMapped(file, cpus);
+  report("mapped parallel", size, start, count);
+
+  std::remove(file.c_str());
+
+  return 0;
+}
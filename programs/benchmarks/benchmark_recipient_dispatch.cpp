@@ -0,0 +1,261 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+// Benchmark of message callback dispatch in a high-rate task.              *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <vector>
+#include <cstdlib>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+using DUNE_NAMESPACES;
+
+//! Message delivery as implemented by the recipient before the
+//! dispatch table: callbacks found in a map for each message and
+//! invoked through the virtual consume(). Queueing is the same as in
+//! the current recipient.
+class LegacyRecipient
+{
+public:
+  LegacyRecipient(void):
+    m_mqueue(1024)
+  { }
+
+  ~LegacyRecipient(void)
+  {
+    std::map<uint32_t, std::vector<Tasks::AbstractConsumer*> >::iterator itr = m_cbacks.begin();
+    for (; itr != m_cbacks.end(); ++itr)
+    {
+      for (size_t i = 0; i < itr->second.size(); ++i)
+        delete itr->second[i];
+    }
+  }
+
+  void
+  bind(uint32_t id, Tasks::AbstractConsumer* consumer)
+  {
+    m_cbacks[id].push_back(consumer);
+  }
+
+  void
+  put(const IMC::SharedMessage& msg)
+  {
+    m_mqueue.push(msg);
+    m_ready.signal();
+  }
+
+  void
+  runCallBacks(void)
+  {
+    m_mqueue.pop(m_batch, m_mqueue.size());
+    m_room.signal();
+
+    for (size_t i = 0; i < m_batch.size(); ++i)
+    {
+      const IMC::Message* msg = m_batch[i].get();
+      uint32_t id = msg->getId();
+      for (size_t j = 0; j < m_cbacks[id].size(); ++j)
+        m_cbacks[id][j]->consume(msg);
+    }
+
+    m_batch.clear();
+  }
+
+private:
+  std::map<uint32_t, std::vector<Tasks::AbstractConsumer*> > m_cbacks;
+  Concurrency::LockFreeQueue<IMC::SharedMessage> m_mqueue;
+  Concurrency::Event m_ready;
+  Concurrency::Event m_room;
+  std::vector<IMC::SharedMessage> m_batch;
+};
+
+//! Task consuming the same messages as the navigation tasks.
+class NavigationSink: public Tasks::AbstractTask
+{
+public:
+  NavigationSink(Tasks::Context& ctx):
+    m_recipient(this, ctx),
+    m_count(0)
+  {
+    bind<IMC::Acceleration>();
+    bind<IMC::AngularVelocity>();
+    bind<IMC::DataSanity>();
+    bind<IMC::Depth>();
+    bind<IMC::DepthOffset>();
+    bind<IMC::Distance>();
+    bind<IMC::EulerAngles>();
+    bind<IMC::EulerAnglesDelta>();
+    bind<IMC::GpsFix>();
+    bind<IMC::GroundVelocity>();
+    bind<IMC::LblConfig>();
+    bind<IMC::LblRange>();
+    bind<IMC::Rpm>();
+    bind<IMC::UsblFixExtended>();
+    bind<IMC::WaterVelocity>();
+  }
+
+  ~NavigationSink(void)
+  {
+    m_recipient.unbindAll();
+  }
+
+  template <typename M>
+  void
+  consume(const M* msg)
+  {
+    m_count += msg->getTimeStamp() > 0;
+  }
+
+  void receive(const IMC::Message*) { }
+  void receive(const IMC::SharedMessage&) { }
+
+  const char*
+  getName(void) const
+  {
+    return "NavigationSink";
+  }
+
+  void inf(const char*, ...) { }
+  void war(const char*, ...) { }
+  void err(const char*, ...) { }
+  void cri(const char*, ...) { }
+  void debug(const char*, ...) { }
+  void trace(const char*, ...) { }
+  void spew(const char*, ...) { }
+
+  Tasks::Recipient m_recipient;
+  LegacyRecipient m_legacy;
+  uint64_t m_count;
+
+private:
+  template <typename M>
+  void
+  bind(void)
+  {
+    m_recipient.bind(M::getIdStatic(), new Tasks::Consumer<NavigationSink, M>(*this, &NavigationSink::consume<M>));
+    m_legacy.bind(M::getIdStatic(), new Tasks::Consumer<NavigationSink, M>(*this, &NavigationSink::consume<M>));
+  }
+
+  void
+  run(void)
+  { }
+};
+
+int
+main(int argc, char** argv)
+{
+  unsigned seconds = 600;
+  if (argc > 1)
+    seconds = std::atoi(argv[1]);
+
+  // Sensor messages at 100 Hz, the rest at 1 Hz, consumed by a task
+  // running at 100 Hz.
+  const char* c_fast[] = {"Acceleration", "AngularVelocity", "EulerAngles",
+                          "EulerAnglesDelta", "Depth", "Rpm"};
+  const char* c_slow[] = {"GpsFix", "GroundVelocity", "WaterVelocity", "Distance"};
+  const unsigned c_rate = 100;
+
+  std::vector<IMC::SharedMessage> fast;
+  for (unsigned i = 0; i < sizeof(c_fast) / sizeof(c_fast[0]); ++i)
+  {
+    IMC::Message* msg = IMC::Factory::produce(c_fast[i]);
+    msg->setTimeStamp();
+    fast.push_back(IMC::SharedMessage(msg));
+  }
+
+  std::vector<IMC::SharedMessage> slow;
+  for (unsigned i = 0; i < sizeof(c_slow) / sizeof(c_slow[0]); ++i)
+  {
+    IMC::Message* msg = IMC::Factory::produce(c_slow[i]);
+    msg->setTimeStamp();
+    slow.push_back(IMC::SharedMessage(msg));
+  }
+
+  Tasks::Context ctx;
+  NavigationSink task(ctx);
+
+  uint64_t elapsed[2] = {0, 0};
+  uint64_t messages = 0;
+
+  for (unsigned s = 0; s < seconds; ++s)
+  {
+    for (unsigned tick = 0; tick < c_rate; ++tick)
+    {
+      for (unsigned k = 0; k < 2; ++k)
+      {
+        uint64_t start = Clock::getNsec();
+
+        for (unsigned i = 0; i < fast.size(); ++i)
+        {
+          if (k == 0)
+            task.m_legacy.put(fast[i]);
+          else
+            task.m_recipient.put(fast[i]);
+        }
+
+        if (tick == 0)
+        {
+          for (unsigned i = 0; i < slow.size(); ++i)
+          {
+            if (k == 0)
+              task.m_legacy.put(slow[i]);
+            else
+              task.m_recipient.put(slow[i]);
+          }
+        }
+
+        if (k == 0)
+          task.m_legacy.runCallBacks();
+        else
+          task.m_recipient.runCallBacks();
+
+        elapsed[k] += Clock::getNsec() - start;
+      }
+
+      messages += fast.size() + (tick == 0 ? slow.size() : 0);
+    }
+  }
+
+  std::cout << "simulated " << seconds << " s, "
+            << messages << " messages per recipient" << std::endl
+            << std::fixed << std::setprecision(1)
+            << std::setw(14) << "legacy: "
+            << std::setw(8) << elapsed[0] / (double)messages << " ns/msg "
+            << std::setw(8) << elapsed[0] / (1e3 * seconds) << " us/s" << std::endl
+            << std::setw(14) << "jump table: "
+            << std::setw(8) << elapsed[1] / (double)messages << " ns/msg "
+            << std::setw(8) << elapsed[1] / (1e3 * seconds) << " us/s" << std::endl;
+
+  return task.m_count == 0;
+}
@@ -35,12 +35,222 @@
 #include <cstring>
 #include <cstdlib>
 #include <map>
+#include <set>
+#include <vector>
+#include <cfloat>
 
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
 
 using DUNE_NAMESPACES;
 
+//! Place an empty EstimatedState message in the log.
+//! @param[in] lsf output stream.
+//! @param[in] timestamp time stamp of the message.
+static void
+writeFirst(std::ostream& lsf, double timestamp)
+{
+  ByteBuffer buffer;
+  IMC::EstimatedState state;
+  state.setTimeStamp(timestamp);
+  IMC::Packet::serialize(&state, buffer);
+  lsf.write(buffer.getBufferSigned(), buffer.getSize());
+}
+
+//! Read the ranges of a log containing given messages from its index.
+//! An index that does not match the size of the log, e.g., because
+//! the log was modified after being indexed, is ignored.
+//! @param[in] file log file.
+//! @param[in] size log size, 0 if unknown.
+//! @param[in] ids identification numbers.
+//! @param[out] index log index.
+//! @param[out] ranges ranges of the log.
+//! @return true if the log has a valid index, false otherwise.
+static bool
+readIndex(const char* file, uint64_t size, const std::set<uint32_t>& ids,
+          IMC::LsfIndex& index, std::vector<IMC::LsfIndex::Range>& ranges)
+{
+  try
+  {
+    index.read(IMC::LsfIndex::getPath(file));
+  }
+  catch (std::runtime_error&)
+  {
+    return false;
+  }
+
+  if (size != 0 && index.getLogSize() != size)
+  {
+    std::cerr << "WARNING: index of " << file << " does not match the log, reading the whole log" << std::endl;
+    index.clear();
+    return false;
+  }
+
+  std::set<uint16_t> wanted(ids.begin(), ids.end());
+  index.getRanges(wanted, index.getStartTime(), DBL_MAX, ranges);
+  return true;
+}
+
+//! Finds packets with given identification numbers in a range of a
+//! memory mapped log.
+class Scanner: public Concurrency::Thread
+{
+public:
+  Scanner(const IMC::LsfReader& reader, const IMC::LsfReader::Range& range,
+          const std::set<uint32_t>& ids):
+    m_reader(reader),
+    m_range(range),
+    m_ids(ids)
+  { }
+
+  //! Scan the range.
+  void
+  scan(void)
+  {
+    IMC::PacketView pkt;
+    uint64_t offset = m_range.first;
+
+    while (m_reader.next(offset, m_range.second, pkt))
+    {
+      if (m_ids.find(pkt.getId()) != m_ids.end())
+        packets.push_back(IMC::LsfReader::Range(offset - pkt.getSize(), offset));
+    }
+  }
+
+  //! Packets found.
+  std::vector<IMC::LsfReader::Range> packets;
+
+private:
+  const IMC::LsfReader& m_reader;
+  IMC::LsfReader::Range m_range;
+  const std::set<uint32_t>& m_ids;
+
+  void
+  run(void)
+  {
+    scan();
+  }
+};
+
+//! Read packets with given identification numbers from an
+//! uncompressed log. If the log has an index, only the parts of the
+//! log that contain such packets are read, otherwise the whole log is
+//! scanned in parallel.
+//! @param[in] file log file.
+//! @param[in] ids identification numbers.
+//! @param[in] lsf output stream.
+//! @param[in,out] done_first true if the first packet was logged.
+//! @return number of packets written.
+static uint32_t
+filterMapped(const char* file, const std::set<uint32_t>& ids,
+             std::ostream& lsf, bool& done_first)
+{
+  IMC::LsfReader reader(file);
+
+  if (!done_first)
+  {
+    IMC::PacketView pkt;
+    uint64_t offset = 0;
+    if (reader.next(offset, pkt))
+    {
+      writeFirst(lsf, pkt.getTimeStamp());
+      done_first = true;
+    }
+  }
+
+  IMC::LsfIndex index;
+  std::vector<IMC::LsfReader::Range> ranges;
+  bool indexed = readIndex(file, reader.getSize(), ids, index, ranges);
+  if (!indexed)
+    reader.split(System::Resources::getProcessorCount(), ranges);
+
+  std::vector<Scanner*> scanners;
+  for (size_t i = 0; i < ranges.size(); ++i)
+  {
+    scanners.push_back(new Scanner(reader, ranges[i], ids));
+    if (indexed)
+      scanners.back()->scan();
+    else
+      scanners.back()->start();
+  }
+
+  uint32_t count = 0;
+  for (size_t i = 0; i < scanners.size(); ++i)
+  {
+    if (!indexed)
+      scanners[i]->join();
+
+    const std::vector<IMC::LsfReader::Range>& packets = scanners[i]->packets;
+    for (size_t j = 0; j < packets.size(); ++j)
+    {
+      // Copy the packet verbatim, no need to deserialize it.
+      lsf.write((const char*)reader.getData() + packets[j].first, packets[j].second - packets[j].first);
+    }
+
+    count += packets.size();
+    delete scanners[i];
+  }
+
+  return count;
+}
+
+//! Read packets with given identification numbers from a compressed
+//! log. If the log has an index, only the parts of the log that
+//! contain such packets are decoded.
+//! @param[in] file log file.
+//! @param[in] is log stream.
+//! @param[in] ids identification numbers.
+//! @param[in] lsf output stream.
+//! @param[in,out] done_first true if the first packet was logged.
+//! @return number of packets written.
+static uint32_t
+filterStream(const char* file, std::istream& is, const std::set<uint32_t>& ids,
+             std::ostream& lsf, bool& done_first)
+{
+  IMC::LsfIndex index;
+  std::vector<IMC::LsfIndex::Range> ranges;
+
+  // Without an index, read the whole log. The size of a compressed
+  // log is only known after decoding it, so the index is trusted.
+  if (!readIndex(file, 0, ids, index, ranges))
+    ranges.push_back(IMC::LsfIndex::Range(0, UINT64_MAX));
+
+  IMC::PacketView pkt;
+  uint64_t offset = 0;
+  uint32_t i = 0;
+
+  for (size_t r = 0; r < ranges.size(); ++r)
+  {
+    // Skip to the start of the range.
+    if (ranges[r].first > offset)
+    {
+      is.ignore(ranges[r].first - offset);
+      offset = ranges[r].first;
+    }
+
+    while (offset < ranges[r].second && pkt.read(is))
+    {
+      offset += pkt.getSize();
+
+      if (!done_first)
+      {
+        writeFirst(lsf, index.getStartTime() >= 0 ? index.getStartTime() : pkt.getTimeStamp());
+        done_first = true;
+      }
+
+      if (ids.find(pkt.getId()) != ids.end())
+      {
+        // Copy the packet verbatim, no need to deserialize it.
+        lsf.write((const char*)pkt.getData(), pkt.getSize());
+
+        ++i;
+      }
+    }
+  }
+
+  return i;
+}
+
 int
 main(int32_t argc, char** argv)
 {
@@ -55,11 +265,8 @@ main(int32_t argc, char** argv)
     return 1;
   }
 
-  ByteBuffer buffer;
   std::ofstream lsf("FilteredData.lsf", std::ios::binary);
 
-  IMC::Message* msg;
-
   uint32_t accum = 0;
 
   bool done_first = false;
@@ -76,44 +283,22 @@ main(int32_t argc, char** argv)
 
   for (uint32_t j = 2; j < (uint32_t)argc; ++j)
   {
-    std::istream* is = 0;
-    Compression::Methods method = Compression::Factory::detect(argv[j]);
-    if (method == METHOD_UNKNOWN)
-      is = new std::ifstream(argv[j], std::ios::binary);
-    else
-      is = new Compression::FileInput(argv[j], method);
-
     uint32_t i = 0;
 
     try
     {
-      while ((msg = IMC::Packet::deserialize(*is)) != 0)
+      Compression::Methods method = Compression::Factory::detect(argv[j]);
+      if (method == METHOD_UNKNOWN)
+      {
+        i = filterMapped(argv[j], ids, lsf, done_first);
+      }
+      else
       {
-        if (!done_first)
-        {
-          // place an empty estimatedstate message in the log
-          IMC::EstimatedState state;
-          state.setTimeStamp(msg->getTimeStamp());
-          IMC::Packet::serialize(&state, buffer);
-          lsf.write(buffer.getBufferSigned(), buffer.getSize());
-          done_first = true;
-        }
-
-        std::set<uint32_t>::const_iterator it;
-        it = ids.find(msg->getId());
-
-        if (it != ids.end())
-        {
-          IMC::Packet::serialize(msg, buffer);
-          lsf.write(buffer.getBufferSigned(), buffer.getSize());
-
-          ++i;
-        }
-
-        delete msg;
+        Compression::FileInput is(argv[j], method);
+        i = filterStream(argv[j], is, ids, lsf, done_first);
       }
     }
-    catch (std::runtime_error& e)
+    catch (std::exception& e)
     {
       std::cerr << "ERROR: " << e.what() << std::endl;
       return -1;
@@ -121,8 +306,6 @@ main(int32_t argc, char** argv)
 
     std::cerr << i << " messages in " << argv[j] << std::endl;
     accum += i;
-
-    delete is;
   }
 
   lsf.close();
@@ -0,0 +1,260 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cstdarg>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE;
+
+//! Task that counts received messages and can hold producers back,
+//! like a task with a full inbox and the Block overflow policy.
+class FakeTask: public Tasks::AbstractTask
+{
+public:
+  FakeTask(void):
+    m_blocking(false)
+  { }
+
+  void
+  receive(const IMC::Message* msg)
+  {
+    receive(IMC::SharedMessage::copy(msg));
+  }
+
+  void
+  receive(const IMC::SharedMessage& msg)
+  {
+    (void)msg;
+    m_received.add(1);
+    m_entered.signal();
+    while (m_blocking)
+      Time::Delay::wait(0.001);
+  }
+
+  const char*
+  getName(void) const
+  {
+    return "FakeTask";
+  }
+
+  void inf(const char*, ...) { }
+  void war(const char*, ...) { }
+  void err(const char*, ...) { }
+  void cri(const char*, ...) { }
+  void debug(const char*, ...) { }
+  void trace(const char*, ...) { }
+  void spew(const char*, ...) { }
+
+  Concurrency::AtomicCounter m_received;
+  Concurrency::Event m_entered;
+  volatile bool m_blocking;
+
+private:
+  void
+  run(void)
+  { }
+};
+
+//! Task with a small inbox that consumes messages slowly.
+class SlowTask: public FakeTask
+{
+public:
+  SlowTask(Tasks::Context& ctx):
+    m_recipient(this, ctx)
+  {
+    m_recipient.setCapacity(16);
+    m_recipient.bind(IMC::Heartbeat::getIdStatic(),
+                     new Tasks::Consumer<SlowTask, IMC::Heartbeat>(*this, &SlowTask::consume));
+  }
+
+  ~SlowTask(void)
+  {
+    m_recipient.unbindAll();
+  }
+
+  using FakeTask::receive;
+
+  void
+  receive(const IMC::SharedMessage& msg)
+  {
+    m_recipient.put(msg);
+  }
+
+  void
+  receive(const IMC::SharedMessage& msg, IMC::DeliveryStatistics& stats)
+  {
+    m_recipient.put(msg, &stats);
+  }
+
+  bool
+  isIdle(void)
+  {
+    return m_recipient.isIdle();
+  }
+
+  bool
+  waitIdle(uint64_t deadline)
+  {
+    return m_recipient.waitIdle(deadline);
+  }
+
+  void
+  consume(const IMC::Heartbeat* msg)
+  {
+    (void)msg;
+    m_consumed.add(1);
+    Time::Delay::wait(0.0001);
+  }
+
+  Tasks::Recipient m_recipient;
+  Concurrency::AtomicCounter m_consumed;
+
+private:
+  void
+  run(void)
+  {
+    while (!isStopping())
+      m_recipient.waitForMessages(0.1);
+  }
+};
+
+//! Thread that dispatches one message.
+class Producer: public Concurrency::Thread
+{
+public:
+  Producer(IMC::Bus& bus):
+    m_bus(bus)
+  { }
+
+private:
+  IMC::Bus& m_bus;
+
+  void
+  run(void)
+  {
+    IMC::Heartbeat msg;
+    m_bus.dispatch(&msg);
+  }
+};
+
+int
+main(void)
+{
+  Test test("IMC::Bus");
+
+  IMC::Bus bus;
+  bus.resume();
+
+  FakeTask a;
+  FakeTask b;
+  IMC::Heartbeat hb;
+
+  {
+    bus.registerRecipient(&a, hb.getId());
+    bus.registerRecipient(&b, hb.getId());
+    bus.dispatch(&hb);
+    test.boolean("dispatch()", a.m_received.add(0) == 1 && b.m_received.add(0) == 1);
+
+    bus.dispatch(&hb, &a);
+    test.boolean("dispatch() (excluded task)", a.m_received.add(0) == 1 && b.m_received.add(0) == 2);
+
+    bus.unregisterRecipient(&b, hb.getId());
+    bus.dispatch(&hb);
+    test.boolean("unregisterRecipient()", a.m_received.add(0) == 2 && b.m_received.add(0) == 2);
+  }
+
+  {
+    // Subscriptions must not wait for a producer blocked on a
+    // recipient.
+    a.m_blocking = true;
+    a.m_entered.prepareWait();
+    Producer producer(bus);
+    producer.start();
+    a.m_entered.wait(5.0);
+
+    double start = Time::Clock::getReal();
+    bus.registerRecipient(&b, hb.getId());
+    bus.unregisterRecipient(&a, IMC::Abort::getIdStatic());
+    bus.registerRecipient(&a, IMC::Abort::getIdStatic());
+    test.boolean("registerRecipient() while delivering",
+                 Time::Clock::getReal() - start < 1.0);
+
+    a.m_blocking = false;
+    producer.join();
+
+    bus.dispatch(&hb);
+    test.boolean("dispatch() after update", a.m_received.add(0) == 4 && b.m_received.add(0) == 3);
+  }
+
+  {
+    // Stepping a virtual clock must not outrun consumers.
+    Tasks::Context ctx;
+    ctx.mbus.resume();
+    SlowTask slow(ctx);
+    slow.start();
+
+    Time::Clock::startVirtual(1000.0, 0.0);
+    bool idle = true;
+    for (unsigned i = 0; i < 500; ++i)
+    {
+      Time::Clock::setVirtual(1000.0 + i * 0.01);
+      idle = ctx.mbus.waitIdle(5.0) && idle;
+      ctx.mbus.dispatch(&hb);
+    }
+    idle = ctx.mbus.waitIdle(5.0) && idle;
+    Time::Clock::stopVirtual();
+
+    slow.stopAndJoin();
+    test.boolean("waitIdle() (stepped delivery)",
+                 idle && slow.m_consumed.add(0) == 500 && slow.m_recipient.getDropCount() == 0);
+  }
+
+  {
+    // Queue depth is sampled when messages are queued.
+    Tasks::Context ctx;
+    ctx.mbus.resume();
+    SlowTask slow(ctx);
+
+    for (unsigned i = 0; i < 10; ++i)
+      ctx.mbus.dispatch(&hb);
+
+    std::vector<const IMC::DeliveryStatistics*> stats;
+    ctx.mbus.getStatistics(stats);
+    test.boolean("getMaxDepth()", stats.size() == 1 && stats[0]->getEnqueued() == 10
+                 && stats[0]->getMaxDepth() == 10);
+  }
+
+  return test.getReturnValue();
+}
@@ -0,0 +1,87 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cstring>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Algorithms/CRC16.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE;
+
+//! Reference byte-wise implementation.
+static uint16_t
+computeBytewise(const uint8_t* buffer, uint16_t len, uint16_t crc)
+{
+  while (len--)
+    crc = Algorithms::CRC16::compute(*buffer++, crc);
+
+  return crc;
+}
+
+int
+main(void)
+{
+  Test test("Algorithms::CRC16");
+
+  {
+    const char* check = "123456789";
+    uint16_t crc = Algorithms::CRC16::compute((const uint8_t*)check, std::strlen(check));
+    test.boolean("check value", crc == 0xBB3D);
+  }
+
+  {
+    std::vector<uint8_t> data(4096);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+      seed = seed * 1103515245 + 12345;
+      data[i] = (uint8_t)(seed >> 16);
+    }
+
+    bool same = true;
+    for (unsigned len = 0; len < 600; ++len)
+    {
+      uint16_t init = (uint16_t)(len * 0x9e37);
+      same = same && (Algorithms::CRC16::computeSliced(&data[len], len, init)
+                      == computeBytewise(&data[len], len, init));
+    }
+
+    same = same && (Algorithms::CRC16::compute(&data[0], data.size())
+                    == computeBytewise(&data[0], data.size(), 0));
+
+    test.boolean("slicing-by-8 matches byte-wise", same);
+  }
+
+  return test.getReturnValue();
+}
@@ -0,0 +1,111 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+// ISO C++ 98 headers.
+#include <iostream>
+#include <cmath>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE::Time;
+
+//! Thread that moves a stepped virtual clock forward.
+class Stepper: public DUNE::Concurrency::Thread
+{
+private:
+  void
+  run(void)
+  {
+    while (!isStopping())
+    {
+      Clock::setVirtual(Clock::getSinceEpoch() + 0.5);
+      DUNE::Concurrency::Scheduler::yield();
+    }
+  }
+};
+
+int
+main(void)
+{
+  Test test("Time::Clock");
+
+  {
+    double mono = Clock::get();
+    Clock::startVirtual(1000.0, 10.0);
+    test.boolean("isVirtual()", Clock::isVirtual());
+    test.boolean("getSpeed()", Clock::getSpeed() == 10.0);
+    test.boolean("get() is monotonic", Clock::get() >= mono);
+    test.boolean("getSinceEpoch()", std::fabs(Clock::getSinceEpoch() - 1000.0) < 0.1);
+
+    double real = Clock::getReal();
+    double start = Clock::getSinceEpoch();
+    Clock::waitVirtual(1.0);
+    double elapsed = Clock::getSinceEpoch() - start;
+    test.boolean("scaled waitVirtual()", elapsed >= 1.0 && elapsed < 1.5);
+    test.boolean("scaled waitVirtual() real time", Clock::getReal() - real < 0.5);
+  }
+
+  {
+    Clock::startVirtual(2000.0, 0.0);
+    test.boolean("getSpeed() stepped", Clock::getSpeed() == 0.0);
+    double a = Clock::getSinceEpoch();
+    double real = Clock::getReal();
+    Delay::wait(0.1);
+    test.boolean("stepped clock is frozen", Clock::getSinceEpoch() == a);
+    test.boolean("Delay::wait() uses the real clock", Clock::getReal() - real >= 0.1);
+
+    Clock::setVirtual(2005.0);
+    test.boolean("setVirtual()", Clock::getSinceEpoch() == 2005.0);
+    Clock::setVirtual(2001.0);
+    test.boolean("setVirtual() ignores the past", Clock::getSinceEpoch() == 2005.0);
+  }
+
+  {
+    Clock::startVirtual(3000.0, 0.0);
+    Stepper stepper;
+    stepper.start();
+    double start = Clock::getSinceEpoch();
+    Clock::waitVirtual(5.0);
+    test.boolean("stepped waitVirtual()", Clock::getSinceEpoch() - start >= 5.0);
+    stepper.stopAndJoin();
+  }
+
+  {
+    Clock::stopVirtual();
+    test.boolean("stopVirtual()", !Clock::isVirtual());
+    test.boolean("getSpeed() real", Clock::getSpeed() == 1.0);
+    test.boolean("getSinceEpoch() real",
+                 std::fabs(Clock::getSinceEpoch() - Clock::getRealSinceEpoch()) < 0.1);
+  }
+
+  return test.getReturnValue();
+}
@@ -0,0 +1,124 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE::Math;
+
+//! Check if a fixed-size matrix matches a dynamically sized one.
+template <unsigned R, unsigned C>
+static bool
+equal(const FixedMatrix<R, C>& a, const Matrix& b)
+{
+  if ((unsigned)b.rows() != R || (unsigned)b.columns() != C)
+    return false;
+
+  for (unsigned i = 0; i < R; ++i)
+  {
+    for (unsigned j = 0; j < C; ++j)
+    {
+      if (std::fabs(a(i, j) - b(i, j)) > 1e-9)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+int
+main(void)
+{
+  Test test("Math::FixedMatrix");
+
+  const double a_data[] = {4.0, 1.0, 0.5, 1.0, 3.0, 0.2, 0.5, 0.2, 2.0};
+  const double b_data[] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  const double q_data[] = {0.1, 0.0, 0.0, 0.1};
+
+  FixedMatrix<3, 3> a(a_data);
+  FixedMatrix<3, 2> b(b_data);
+  FixedMatrix<2, 2> q(q_data);
+  Matrix ma(a_data, 3, 3);
+  Matrix mb(b_data, 3, 2);
+  Matrix mq(q_data, 2, 2);
+
+  {
+    FixedMatrix<3, 3> c(ma);
+    test.boolean("conversion", equal(c, ma) && equal(a, a.toMatrix()));
+  }
+
+  {
+    bool thrown = false;
+    try
+    {
+      FixedMatrix<2, 3> c(ma);
+    }
+    catch (Matrix::Error&)
+    {
+      thrown = true;
+    }
+    test.boolean("conversion (invalid dimensions)", thrown);
+  }
+
+  test.boolean("multiplication", equal(a * b, ma * mb));
+  test.boolean("transpose", equal(transpose(b), transpose(mb)));
+  test.boolean("addition", equal(a + a * 2.0, ma + ma * 2.0));
+
+  {
+    FixedMatrix<2, 3> bt = transpose(b);
+    test.boolean("congruence", equal(congruence(bt, a, q), transpose(mb) * ma * mb + mq));
+  }
+
+  {
+    FixedMatrix<3, 3> i;
+    i.identity();
+    test.boolean("inverse", equal(inverse(a), inverse(ma)) && equal(a * inverse(a), i.toMatrix()));
+  }
+
+  {
+    bool thrown = false;
+    try
+    {
+      inverse(FixedMatrix<2, 2>(1.0));
+    }
+    catch (Matrix::Error&)
+    {
+      thrown = true;
+    }
+    test.boolean("inverse (singular)", thrown);
+  }
+
+  return test.getReturnValue();
+}
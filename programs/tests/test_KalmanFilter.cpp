@@ -0,0 +1,183 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+// ISO C++ 98 headers.
+#include <cmath>
+#include <stdexcept>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE;
+
+//! Number of filter states.
+static const unsigned c_states = 5;
+//! Number of filter outputs.
+static const unsigned c_outputs = 3;
+
+//! Initialize a filter with a correlated covariance.
+static void
+setup(Navigation::KalmanFilter& kal, Math::Matrix& p)
+{
+  kal.reset(c_states, c_outputs);
+  p.resizeAndFill(c_states, c_states, 0.0);
+
+  for (unsigned i = 0; i < c_states; ++i)
+  {
+    for (unsigned j = 0; j < c_states; ++j)
+      p(i, j) = (i == j) ? 1.0 + i : 0.1;
+
+    kal.setState(i, 0.5 * i);
+  }
+
+  for (unsigned i = 0; i < c_states; ++i)
+  {
+    for (unsigned j = 0; j < c_states; ++j)
+      kal.setCovariance(i, j, p(i, j));
+  }
+
+  // Position fix on states 0 and 1, speed on state 3, no range.
+  kal.setObservation(0, 0, 1.0);
+  kal.setObservation(1, 1, 1.0);
+  kal.setObservation(2, 3, 0.5);
+  kal.setMeasurementNoise(0, 0.2);
+  kal.setMeasurementNoise(1, 0.2);
+  kal.setMeasurementNoise(2, 0.1);
+  kal.setInnovation(0, 0.3);
+  kal.setInnovation(1, -0.2);
+  kal.setInnovation(2, 0.4);
+}
+
+//! Check if state and covariance of a filter match the batch update.
+static bool
+matches(const Navigation::KalmanFilter& kal, const Math::Matrix& x, const Math::Matrix& p)
+{
+  for (unsigned i = 0; i < c_states; ++i)
+  {
+    if (std::fabs(kal.getState(i) - x(i)) > 1e-9)
+      return false;
+
+    for (unsigned j = 0; j < c_states; ++j)
+    {
+      if (std::fabs(kal.getCovariance(i, j) - p(i, j)) > 1e-9)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+int
+main(void)
+{
+  Test test("Navigation::KalmanFilter");
+
+  Navigation::KalmanFilter kal;
+  Math::Matrix p;
+  setup(kal, p);
+
+  // Reference batch update.
+  Math::Matrix c = kal.getObservation();
+  Math::Matrix innov(c_outputs, 1);
+  for (unsigned i = 0; i < c_outputs; ++i)
+    innov(i) = kal.getInnovation(i);
+  Math::Matrix r(c_outputs, c_outputs, 0.0);
+  r(0, 0) = 0.2;
+  r(1, 1) = 0.2;
+  r(2, 2) = 0.1;
+
+  Math::Matrix S_1 = inverse(c * p * transpose(c) + r);
+  Math::Matrix K = p * transpose(c) * S_1;
+  Math::Matrix x = kal.getState() + K * innov;
+  Math::Matrix p1 = p - K * c * p;
+  double level = (transpose(innov) * S_1 * innov)(0);
+
+  {
+    int rv = kal.update(0);
+    test.boolean("sequential update", rv == 0 && matches(kal, x, p1));
+  }
+
+  {
+    setup(kal, p);
+    Math::Matrix x0 = kal.getState();
+    int rv = kal.update(level * 0.99);
+    test.boolean("sequential update (rejected)", rv == -1 && matches(kal, x0, p));
+
+    rv = kal.update(level * 1.01);
+    test.boolean("sequential update (accepted)", rv == 0 && matches(kal, x, p1));
+  }
+
+  {
+    setup(kal, p);
+    kal.setObservation(2, 3, 0.0);
+    kal.update(0);
+
+    // Speed observation applied after the position fix.
+    unsigned state = 3;
+    double h = 0.5;
+    kal.update(&state, &h, 1, 0.4 - h * (kal.getState(3) - 1.5), 0.1, 0);
+    test.boolean("scalar update", matches(kal, x, p1));
+  }
+
+  {
+    // Last output fails after the first ones were applied.
+    setup(kal, p);
+    kal.setMeasurementNoise(2, -10.0);
+    Math::Matrix x0 = kal.getState();
+    bool thrown = false;
+    try
+    {
+      kal.update(0);
+    }
+    catch (std::runtime_error&)
+    {
+      thrown = true;
+    }
+    test.boolean("sequential update (failed)", thrown && matches(kal, x0, p));
+  }
+
+  {
+    setup(kal, p);
+    kal.setMeasurementNoise(0, 1, 0.05);
+    kal.setMeasurementNoise(1, 0, 0.05);
+    r(0, 1) = r(1, 0) = 0.05;
+
+    S_1 = inverse(c * p * transpose(c) + r);
+    K = p * transpose(c) * S_1;
+    x = kal.getState() + K * innov;
+    p1 = p - K * c * p;
+
+    int rv = kal.update(0);
+    test.boolean("batch update (correlated noise)", rv == 0 && matches(kal, x, p1));
+  }
+
+  return test.getReturnValue();
+}
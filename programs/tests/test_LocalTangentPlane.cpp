@@ -0,0 +1,113 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+// ISO C++ 98 headers.
+#include <cmath>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE;
+using DUNE::Coordinates::LocalTangentPlane;
+using DUNE::Coordinates::WGS84;
+
+int
+main(void)
+{
+  Test test("Coordinates::LocalTangentPlane");
+
+  const double origins[][3] =
+  {
+    {0.7188, -0.1532, 50.0},
+    {-1.2, 2.9, -20.0},
+    {0.0, 0.0, 0.0},
+    {1.5, -3.0, 1000.0}
+  };
+
+  double ned_error = 0;
+  double round_trip_error = 0;
+  double height_error = 0;
+
+  for (unsigned o = 0; o < sizeof(origins) / sizeof(origins[0]); ++o)
+  {
+    LocalTangentPlane ltp(origins[o][0], origins[o][1], origins[o][2]);
+
+    for (int i = -5; i <= 5; ++i)
+    {
+      for (int j = -5; j <= 5; ++j)
+      {
+        double lat = origins[o][0] + i * 1e-3;
+        double lon = origins[o][1] + j * 1e-3;
+        double hae = origins[o][2] + i * j * 10.0;
+
+        double n0, e0, d0;
+        WGS84::displacement(origins[o][0], origins[o][1], origins[o][2],
+                            lat, lon, hae, &n0, &e0, &d0);
+
+        double n, e, d;
+        ltp.toNED(lat, lon, hae, &n, &e, &d);
+        ned_error = std::max(ned_error, std::fabs(n - n0) + std::fabs(e - e0) + std::fabs(d - d0));
+
+        double lat1, lon1, hae1;
+        ltp.fromNED(n, e, d, &lat1, &lon1, &hae1);
+        round_trip_error = std::max(round_trip_error, std::fabs(lat1 - lat) + std::fabs(lon1 - lon));
+        height_error = std::max(height_error, std::fabs(hae1 - hae));
+      }
+    }
+  }
+
+  test.boolean("toNED()", ned_error < 1e-6);
+  test.boolean("fromNED() (latitude, longitude)", round_trip_error < 1e-12);
+  test.boolean("fromNED() (height)", height_error < 1e-4);
+
+  {
+    LocalTangentPlane ltp(origins[0][0], origins[0][1], origins[0][2]);
+    double n[] = {100.0, -2500.0, 0.0};
+    double e[] = {-40.0, 1300.0, 0.0};
+    double d[] = {5.0, 0.0, -30.0};
+    double lat[3], lon[3], hae[3];
+    ltp.fromNED(n, e, d, 3, lat, lon, hae);
+
+    double n1[3], e1[3], d1[3];
+    ltp.toNED(lat, lon, hae, 3, n1, e1, d1);
+
+    bool ok = true;
+    for (unsigned i = 0; i < 3; ++i)
+    {
+      if (std::fabs(n1[i] - n[i]) + std::fabs(e1[i] - e[i]) + std::fabs(d1[i] - d[i]) > 1e-6)
+        ok = false;
+    }
+
+    test.boolean("batch conversion", ok);
+  }
+
+  return test.getReturnValue();
+}
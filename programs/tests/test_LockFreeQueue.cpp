@@ -0,0 +1,163 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE::Concurrency;
+
+//! Number of elements pushed by each producer.
+static const unsigned c_count = 100000;
+//! Number of producers.
+static const unsigned c_producers = 4;
+
+class Producer: public Thread
+{
+public:
+  Producer(LockFreeQueue<unsigned>& queue, Event& event, unsigned id):
+    m_queue(queue),
+    m_event(event),
+    m_id(id)
+  { }
+
+  void
+  run(void)
+  {
+    for (unsigned i = 0; i < c_count; ++i)
+    {
+      unsigned value = m_id * c_count + i;
+      while (!m_queue.push(value))
+        DUNE::Time::Delay::wait(0.0001);
+      m_event.signal();
+    }
+  }
+
+private:
+  LockFreeQueue<unsigned>& m_queue;
+  Event& m_event;
+  unsigned m_id;
+};
+
+int
+main(void)
+{
+  Test test("Concurrency::LockFreeQueue");
+
+  {
+    LockFreeQueue<unsigned> queue(5);
+    test.boolean("capacity()", queue.capacity() == 8);
+    test.boolean("empty()", queue.empty());
+
+    unsigned i = 0;
+    while (queue.push(i))
+      ++i;
+    test.boolean("push() (full)", i == 8 && queue.size() == 8);
+
+    std::vector<unsigned> batch;
+    test.boolean("pop() (batch)", queue.pop(batch, 3) == 3 && batch[0] == 0 && batch[2] == 2);
+
+    unsigned v = 0;
+    bool ordered = true;
+    for (i = 3; i < 8; ++i)
+      ordered = ordered && queue.pop(v) && v == i;
+    test.boolean("pop() (order)", ordered && !queue.pop(v));
+  }
+
+  {
+    LockFreeQueue<unsigned> queue(1024);
+    Event event;
+    std::vector<Producer*> producers;
+    for (unsigned i = 0; i < c_producers; ++i)
+    {
+      producers.push_back(new Producer(queue, event, i));
+      producers.back()->start();
+    }
+
+    std::vector<unsigned> last(c_producers, 0);
+    std::vector<bool> seen(c_producers, false);
+    unsigned received = 0;
+    bool ordered = true;
+    std::vector<unsigned> batch;
+
+    while (received < c_producers * c_count)
+    {
+      event.prepareWait();
+      if (queue.empty())
+        event.wait(1.0);
+      else
+        event.cancelWait();
+
+      batch.clear();
+      queue.pop(batch, queue.capacity());
+
+      for (unsigned i = 0; i < batch.size(); ++i)
+      {
+        unsigned id = batch[i] / c_count;
+        unsigned seq = batch[i] % c_count;
+        if (seen[id] && seq != last[id] + 1)
+          ordered = false;
+        seen[id] = true;
+        last[id] = seq;
+        ++received;
+      }
+    }
+
+    for (unsigned i = 0; i < producers.size(); ++i)
+    {
+      producers[i]->join();
+      delete producers[i];
+    }
+
+    test.boolean("multiple producers (count)", received == c_producers * c_count);
+    test.boolean("multiple producers (order)", ordered);
+  }
+
+  {
+    Event event;
+    uint64_t start = DUNE::Time::Clock::getRealNsec();
+    event.prepareWait();
+    bool signaled = event.waitUntil(start + 50000000);
+    uint64_t elapsed = DUNE::Time::Clock::getRealNsec() - start;
+    test.boolean("Event::waitUntil() (deadline)", !signaled && elapsed >= 45000000);
+
+    event.prepareWait();
+    event.signal();
+    start = DUNE::Time::Clock::getRealNsec();
+    test.boolean("Event::waitUntil() (signaled)",
+                 event.waitUntil(start + 5000000000ULL));
+  }
+
+  return test.getReturnValue();
+}
@@ -0,0 +1,121 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/IMC.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE;
+
+//! Count messages of a given type in ranges of a log.
+static unsigned
+countInRanges(const std::vector<uint8_t>& log, const std::vector<IMC::LsfIndex::Range>& ranges, uint16_t id)
+{
+  unsigned count = 0;
+  IMC::PacketView pkt;
+
+  for (size_t i = 0; i < ranges.size(); ++i)
+  {
+    uint64_t offset = ranges[i].first;
+    while (offset < ranges[i].second)
+    {
+      pkt.set(&log[offset], log.size() - offset);
+      if (pkt.getId() == id)
+        ++count;
+      offset += pkt.getSize();
+    }
+  }
+
+  return count;
+}
+
+int
+main(void)
+{
+  Test test("IMC::LsfIndex");
+
+  // Ten seconds of EstimatedState at 10 Hz and a few GpsFix messages.
+  std::vector<uint8_t> log;
+  IMC::LsfIndex index(1.0);
+  for (unsigned i = 0; i < 100; ++i)
+  {
+    IMC::EstimatedState state;
+    IMC::GpsFix fix;
+    IMC::Message* msg = &state;
+    if (i == 15 || i == 16 || i == 72)
+      msg = &fix;
+
+    msg->setTimeStamp(1000.0 + i * 0.1);
+
+    std::vector<uint8_t> bfr(msg->getSerializationSize());
+    IMC::Packet::serialize(msg, &bfr[0], bfr.size());
+    index.add(msg->getId(), msg->getTimeStamp(), log.size(), bfr.size());
+    log.insert(log.end(), bfr.begin(), bfr.end());
+  }
+
+  std::string file = "test_LsfIndex.idx";
+  index.write(file);
+  IMC::LsfIndex copy;
+  copy.read(file);
+  std::remove(file.c_str());
+
+  test.boolean("period", copy.getPeriod() == 1.0);
+  test.boolean("log size", copy.getLogSize() == log.size());
+  test.boolean("start time", copy.getStartTime() == 1000.0);
+  test.boolean("message count", copy.getCount(DUNE_IMC_GPSFIX) == 3 && copy.getCount(DUNE_IMC_ESTIMATEDSTATE) == 97);
+
+  std::set<uint16_t> ids;
+  std::vector<IMC::LsfIndex::Range> ranges;
+  copy.getRanges(ids, 0, 2000, ranges);
+  test.boolean("whole log", ranges.size() == 1 && ranges[0].first == 0 && ranges[0].second == log.size());
+
+  ids.insert(DUNE_IMC_GPSFIX);
+  copy.getRanges(ids, 0, 2000, ranges);
+  uint64_t bytes = 0;
+  for (size_t i = 0; i < ranges.size(); ++i)
+    bytes += ranges[i].second - ranges[i].first;
+  test.boolean("selected messages", ranges.size() == 2 && countInRanges(log, ranges, DUNE_IMC_GPSFIX) == 3);
+  test.boolean("selected ranges", bytes < log.size() / 4);
+
+  copy.getRanges(ids, 1005.0, 2000, ranges);
+  test.boolean("time window", ranges.size() == 1 && countInRanges(log, ranges, DUNE_IMC_GPSFIX) == 1);
+
+  test.boolean("index path", IMC::LsfIndex::getPath("log/Data.lsf.gz") == "log/Data.lsf.idx"
+               && IMC::LsfIndex::getPath("Data.lsf") == "Data.lsf.idx");
+
+  return test.getReturnValue();
+}
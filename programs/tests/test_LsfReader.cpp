@@ -0,0 +1,125 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/IMC.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE;
+
+//! Scan a range of a log, return the time stamps of the packets found.
+static void
+scan(const IMC::LsfReader& reader, const IMC::LsfReader::Range& range, std::vector<double>& stamps)
+{
+  IMC::PacketView pkt;
+  uint64_t offset = range.first;
+  while (reader.next(offset, range.second, pkt))
+    stamps.push_back(pkt.getTimeStamp());
+}
+
+int
+main(void)
+{
+  Test test("IMC::LsfReader");
+
+  // Build a log with corrupted packets, garbage between packets and
+  // packets embedded in the payload of other packets.
+  std::string file = "test_LsfReader.lsf";
+  std::vector<double> expected;
+  {
+    IMC::EstimatedState inner;
+    inner.setTimeStamp(-1.0);
+    std::vector<uint8_t> embedded(inner.getSerializationSize());
+    IMC::Packet::serialize(&inner, &embedded[0], embedded.size());
+
+    std::ofstream ofs(file.c_str(), std::ios::binary);
+    for (unsigned i = 0; i < 500; ++i)
+    {
+      IMC::EstimatedState state;
+      IMC::CompressedImage image;
+      if (i % 37 == 0)
+        image.data.assign(i * 3, 'x');
+      else
+        for (unsigned j = 0; j < i; ++j)
+          image.data.insert(image.data.end(), embedded.begin(), embedded.end());
+      IMC::Message* msg = (i % 4 == 0) ? (IMC::Message*)&image : &state;
+      msg->setTimeStamp(i);
+
+      std::vector<uint8_t> bfr(msg->getSerializationSize());
+      IMC::Packet::serialize(msg, &bfr[0], bfr.size());
+
+      if (i % 37 == 0)
+        bfr[bfr.size() / 2] ^= 0x55;
+      else
+        expected.push_back(i);
+
+      ofs.write((const char*)&bfr[0], bfr.size());
+
+      if (i % 11 == 0)
+        ofs.write("\xfe\x54\x01\x54\xfe", 5);
+    }
+  }
+
+  {
+    IMC::LsfReader reader(file);
+
+    std::vector<double> stamps;
+    scan(reader, IMC::LsfReader::Range(0, reader.getSize()), stamps);
+    test.boolean("sequential scan", stamps == expected);
+
+    const unsigned c_counts[] = {2, 7, 64};
+    for (unsigned i = 0; i < sizeof(c_counts) / sizeof(c_counts[0]); ++i)
+    {
+      std::vector<IMC::LsfReader::Range> chunks;
+      reader.split(c_counts[i], chunks);
+
+      bool contiguous = !chunks.empty() && chunks.front().first == 0 && chunks.back().second == reader.getSize();
+      stamps.clear();
+      for (size_t j = 0; j < chunks.size(); ++j)
+      {
+        contiguous = contiguous && (j == 0 || chunks[j].first == chunks[j - 1].second);
+        scan(reader, chunks[j], stamps);
+      }
+
+      test.boolean("split scan", contiguous && chunks.size() <= c_counts[i] && stamps == expected);
+    }
+  }
+
+  std::remove(file.c_str());
+
+  return test.getReturnValue();
+}
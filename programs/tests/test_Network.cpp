@@ -29,8 +29,11 @@
 
 // ISO C++ 98 headers.
 #include <iostream>
+#include <cstring>
+#include <vector>
 
 // DUNE headers.
+#include <DUNE/IO/Poll.hpp>
 #include <DUNE/Network.hpp>
 
 // Local headers.
@@ -86,5 +89,66 @@ main(void)
     test.boolean("IP address resolution", a.resolve());
   }
 
+  {
+    TCPSocket server;
+    server.bind(0, Address::Loopback);
+    server.listen(1);
+
+    TCPSocket client;
+    client.connect(Address::Loopback, server.getBoundPort());
+    TCPSocket* peer = server.accept();
+
+    const uint8_t* bfrs[] = {(const uint8_t*)"abc", (const uint8_t*)"defg"};
+    size_t sizes[] = {3, 4};
+    test.boolean("TCPSocket::writeNonBlocking()", client.writeNonBlocking(bfrs, sizes, 2) == 7);
+
+    uint8_t data[7] = {0};
+    size_t n = 0;
+    while (n < sizeof(data))
+      n += peer->read(data + n, sizeof(data) - n);
+    test.boolean("TCPSocket::writeNonBlocking() (order)", std::memcmp(data, "abcdefg", 7) == 0);
+
+    std::vector<uint8_t> block(65536);
+    const uint8_t* bbfrs[] = {&block[0]};
+    size_t bsizes[] = {block.size()};
+    unsigned i = 0;
+    while (i < 10000 && client.writeNonBlocking(bbfrs, bsizes, 1) > 0)
+      ++i;
+    test.boolean("TCPSocket::writeNonBlocking() (full)", i < 10000);
+
+    delete peer;
+  }
+
+  {
+    UDPSocket rx;
+    rx.bind(19877, Address::Loopback);
+    UDPSocket tx;
+
+    const uint8_t* bfrs[] = {(const uint8_t*)"abc", (const uint8_t*)"defg", (const uint8_t*)"h"};
+    size_t sizes[] = {3, 4, 1};
+    Address addrs[] = {Address::Loopback, Address::Loopback, Address::Loopback};
+    uint16_t ports[] = {19877, 19877, 19877};
+    test.boolean("UDPSocket::writeBatch()", tx.writeBatch(bfrs, sizes, addrs, ports, 3) == 3);
+
+    uint8_t data[4][16];
+    uint8_t* rbfrs[] = {data[0], data[1], data[2], data[3]};
+    size_t rsizes[] = {16, 16, 16, 16};
+    Address raddrs[4];
+    size_t n = 0;
+    for (unsigned i = 0; i < 100 && n < 3; ++i)
+    {
+      if (DUNE::IO::Poll::poll(rx, 0.1))
+        n += rx.readBatch(rbfrs + n, rsizes + n, raddrs + n, NULL, 4 - n);
+    }
+
+    bool ok = n == 3
+      && rsizes[0] == 3 && std::memcmp(data[0], "abc", 3) == 0
+      && rsizes[1] == 4 && std::memcmp(data[1], "defg", 4) == 0
+      && rsizes[2] == 1 && data[2][0] == 'h'
+      && raddrs[0] == Address::Loopback;
+    test.boolean("UDPSocket::readBatch()", ok);
+    test.boolean("UDPSocket::readBatch() (empty)", rx.readBatch(rbfrs, rsizes, NULL, NULL, 4) == 0);
+  }
+
   return 0;
 }
@@ -0,0 +1,138 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <sstream>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Algorithms/CRC16.hpp>
+#include <DUNE/IMC.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE;
+
+int
+main(void)
+{
+  Test test("IMC::PacketView");
+
+  std::ostringstream os;
+  std::vector<IMC::Message*> msgs;
+  for (unsigned i = 0; i < 10; ++i)
+  {
+    IMC::Message* msg;
+    if (i % 2 == 0)
+    {
+      IMC::CompressedImage* img = new IMC::CompressedImage;
+      img->data.assign(100 + i * 37, (char)i);
+      msg = img;
+    }
+    else
+    {
+      msg = new IMC::EstimatedState;
+    }
+
+    msg->setTimeStamp(i);
+    msg->setSource(0x1000 + i);
+    msg->setSourceEntity(i);
+    msgs.push_back(msg);
+    IMC::Packet::serialize(msg, os);
+  }
+
+  std::istringstream is(os.str());
+  IMC::PacketView pkt;
+  bool headers = true;
+  bool payloads = true;
+  size_t count = 0;
+
+  while (pkt.read(is))
+  {
+    const IMC::Message* msg = msgs[count];
+    headers = headers && pkt.getId() == msg->getId()
+    && pkt.getTimeStamp() == msg->getTimeStamp()
+    && pkt.getSource() == msg->getSource()
+    && pkt.getSourceEntity() == msg->getSourceEntity()
+    && pkt.getPayloadSize() == msg->getPayloadSerializationSize()
+    && pkt.getSize() == msg->getSerializationSize();
+
+    IMC::Message* copy = pkt.materialize();
+    payloads = payloads && *copy == *msg;
+    delete copy;
+    ++count;
+  }
+
+  test.boolean("read all packets", count == msgs.size());
+  test.boolean("header fields", headers);
+  test.boolean("materialized messages", payloads);
+
+  {
+    std::string data = os.str();
+    IMC::PacketView view((const uint8_t*)data.data(), data.size());
+    IMC::Message* msg = view.materialize();
+    test.boolean("view of buffer", *msg == *msgs[0]);
+    delete msg;
+
+    bool thrown = false;
+    try
+    {
+      view.set((const uint8_t*)data.data(), view.getSize() - 1);
+    }
+    catch (IMC::BufferTooShort&)
+    {
+      thrown = true;
+    }
+
+    test.boolean("truncated buffer", thrown);
+  }
+
+  {
+    // Packet larger than 65535 bytes, which Packet::serialize()
+    // refuses to produce but other implementations may send.
+    IMC::CompressedImage img;
+    img.data.assign(65530, 'x');
+    std::vector<uint8_t> bfr(img.getSerializationSize());
+    IMC::Packet::serializeHeader(&img, &bfr[0], DUNE_IMC_CONST_HEADER_SIZE);
+    uint8_t* footer = img.serializeFields(&bfr[DUNE_IMC_CONST_HEADER_SIZE]);
+    IMC::serialize(Algorithms::CRC16::compute(&bfr[0], footer - &bfr[0]), footer);
+
+    IMC::PacketView view(&bfr[0], bfr.size());
+    IMC::Message* msg = view.materialize();
+    test.boolean("largest payload", view.getSize() > 65535 && *msg == img);
+    delete msg;
+  }
+
+  for (size_t i = 0; i < msgs.size(); ++i)
+    delete msgs[i];
+
+  return test.getReturnValue();
+}
@@ -0,0 +1,205 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Algorithms/CRC16.hpp>
+#include <DUNE/IMC.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE;
+
+//! Build a stream of packets separated by garbage. Together with
+//! the surrounding bytes, the garbage forms false synchronization
+//! numbers.
+static void
+buildStream(std::vector<uint8_t>& stream, std::vector<IMC::Message*>& msgs)
+{
+  const char* garbage = "\xfe\x00\x54\x01\xfe\x01\x54";
+
+  for (unsigned i = 0; i < 50; ++i)
+  {
+    IMC::Message* msg;
+    if (i % 3 == 0)
+    {
+      IMC::CompressedImage* img = new IMC::CompressedImage;
+      img->data.assign(100 + i * 37, (char)i);
+      msg = img;
+    }
+    else
+    {
+      IMC::EstimatedState* state = new IMC::EstimatedState;
+      state->x = i;
+      msg = state;
+    }
+
+    msg->setTimeStamp(i);
+    msgs.push_back(msg);
+
+    std::vector<uint8_t> bfr(msg->getSerializationSize());
+    IMC::Packet::serialize(msg, &bfr[0], bfr.size());
+    stream.insert(stream.end(), bfr.begin(), bfr.end());
+
+    if (i % 5 == 0)
+      stream.insert(stream.end(), garbage, garbage + (i % 7) + 1);
+  }
+}
+
+//! Parse a stream in chunks of a given size.
+static bool
+parseChunks(const std::vector<uint8_t>& stream, const std::vector<IMC::Message*>& msgs, size_t chunk)
+{
+  IMC::Parser parser;
+  std::vector<IMC::Message*> out;
+
+  for (size_t i = 0; i < stream.size(); i += chunk)
+    parser.parse(&stream[i], std::min(chunk, stream.size() - i), out);
+
+  bool same = (out.size() == msgs.size());
+  for (size_t i = 0; i < out.size(); ++i)
+  {
+    same = same && i < msgs.size() && *out[i] == *msgs[i];
+    delete out[i];
+  }
+
+  return same;
+}
+
+int
+main(void)
+{
+  Test test("IMC::Parser");
+
+  std::vector<uint8_t> stream;
+  std::vector<IMC::Message*> msgs;
+  buildStream(stream, msgs);
+
+  {
+    IMC::Parser parser;
+    bool same = true;
+    size_t count = 0;
+    for (size_t i = 0; i < stream.size(); ++i)
+    {
+      IMC::Message* msg = parser.parse(stream[i]);
+      if (msg != NULL)
+      {
+        same = same && count < msgs.size() && *msg == *msgs[count];
+        ++count;
+        delete msg;
+      }
+    }
+
+    test.boolean("byte by byte", same && count == msgs.size());
+  }
+
+  test.boolean("whole stream", parseChunks(stream, msgs, stream.size()));
+
+  const size_t c_chunks[] = {2, 7, 19, 20, 21, 100, 1000};
+  for (unsigned i = 0; i < sizeof(c_chunks) / sizeof(c_chunks[0]); ++i)
+  {
+    std::ostringstream os;
+    os << "chunks of " << c_chunks[i] << " bytes";
+    test.boolean(os.str().c_str(), parseChunks(stream, msgs, c_chunks[i]));
+  }
+
+  {
+    IMC::Parser parser;
+    std::vector<IMC::Message*> out;
+    parser.parse(&stream[0], stream.size(), out);
+
+    bool none = !out.empty();
+    for (size_t i = 0; i < out.size(); ++i)
+    {
+      none = none && out[i]->getRawFrame().isNull();
+      delete out[i];
+    }
+    out.clear();
+
+    test.boolean("no raw frames by default", none);
+
+    parser.setRawFrames(true);
+    parser.parse(&stream[0], stream.size(), out);
+
+    bool frames = !out.empty();
+    for (size_t i = 0; i < out.size(); ++i)
+    {
+      std::vector<uint8_t> bfr(out[i]->getSerializationSize());
+      IMC::Packet::serialize(out[i], &bfr[0], bfr.size());
+      const IMC::RawFrame& frame = out[i]->getRawFrame();
+      frames = frames && frame.getSize() == bfr.size()
+      && std::equal(bfr.begin(), bfr.end(), frame.getData());
+    }
+
+    test.boolean("raw frames", frames);
+
+    IMC::Message* copy = out[0]->clone();
+    test.boolean("raw frame not cloned", copy->getRawFrame().isNull());
+    delete copy;
+
+    out[0]->setTimeStamp(out[0]->getTimeStamp());
+    test.boolean("raw frame kept", !out[0]->getRawFrame().isNull());
+    out[0]->setTimeStamp(out[0]->getTimeStamp() + 1.0);
+    test.boolean("raw frame discarded", out[0]->getRawFrame().isNull());
+
+    for (size_t i = 0; i < out.size(); ++i)
+      delete out[i];
+  }
+
+  {
+    // Packet larger than 65535 bytes.
+    IMC::CompressedImage img;
+    img.data.assign(65530, 'x');
+    std::vector<uint8_t> bfr(img.getSerializationSize());
+    IMC::Packet::serializeHeader(&img, &bfr[0], DUNE_IMC_CONST_HEADER_SIZE);
+    uint8_t* footer = img.serializeFields(&bfr[DUNE_IMC_CONST_HEADER_SIZE]);
+    IMC::serialize(Algorithms::CRC16::compute(&bfr[0], footer - &bfr[0]), footer);
+
+    IMC::Parser parser;
+    parser.setRawFrames(true);
+    std::vector<IMC::Message*> out;
+    parser.parse(&bfr[0], bfr.size(), out);
+
+    test.boolean("largest raw frame", out.size() == 1
+                 && out[0]->getRawFrame().getSize() == bfr.size());
+
+    for (size_t i = 0; i < out.size(); ++i)
+      delete out[i];
+  }
+
+  for (size_t i = 0; i < msgs.size(); ++i)
+    delete msgs[i];
+
+  return test.getReturnValue();
+}
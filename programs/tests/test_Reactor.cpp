@@ -0,0 +1,200 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+// ISO C++ 98 headers.
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE;
+using DUNE::IO::Reactor;
+
+//! Port used for the loopback tests.
+static const uint16_t c_port = 19876;
+
+//! Thread that wakes up a reactor after a delay.
+class Waker: public Concurrency::Thread
+{
+public:
+  Waker(Reactor& reactor):
+    m_reactor(reactor)
+  { }
+
+private:
+  Reactor& m_reactor;
+
+  void
+  run(void)
+  {
+    Time::Delay::wait(0.1);
+    m_reactor.wakeup();
+  }
+};
+
+//! Thread that keeps waking up a reactor.
+class Hammer: public Concurrency::Thread
+{
+public:
+  Hammer(Reactor& reactor):
+    m_reactor(reactor)
+  { }
+
+private:
+  Reactor& m_reactor;
+
+  void
+  run(void)
+  {
+    double end = Time::Clock::getReal() + 0.5;
+    while (Time::Clock::getReal() < end)
+    {
+      for (unsigned i = 0; i < 1000; ++i)
+        m_reactor.wakeup();
+    }
+  }
+};
+
+int
+main(void)
+{
+  Test test("IO::Reactor");
+
+  Reactor reactor;
+  std::vector<Reactor::Event> events;
+  int tag = 0;
+
+  {
+    double start = Time::Clock::getReal();
+    test.boolean("wait() times out", reactor.wait(0.05, events) == 0);
+    test.boolean("wait() timeout duration", Time::Clock::getReal() - start >= 0.04);
+  }
+
+  Network::UDPSocket rx;
+  Network::UDPSocket tx;
+  rx.bind(c_port, Network::Address::Loopback);
+  uint8_t bfr[16] = {0};
+
+  {
+    reactor.add(rx, Reactor::EV_READ, &tag);
+    tx.write(bfr, sizeof(bfr), Network::Address::Loopback, c_port);
+    bool ok = reactor.wait(1.0, events) == 1
+      && events[0].data == &tag
+      && (events[0].events & Reactor::EV_READ);
+    test.boolean("read readiness", ok);
+
+    test.boolean("level-triggered read", reactor.wait(0.05, events) == 1);
+    rx.read(bfr, sizeof(bfr));
+    test.boolean("read drained", reactor.wait(0.05, events) == 0);
+    reactor.remove(rx);
+  }
+
+  {
+    reactor.add(rx, Reactor::EV_READ | Reactor::EV_EDGE, &tag);
+    tx.write(bfr, sizeof(bfr), Network::Address::Loopback, c_port);
+    test.boolean("edge-triggered read", reactor.wait(1.0, events) == 1);
+    if (std::string(Reactor::getBackend()) == "epoll")
+      test.boolean("edge-triggered read reported once", reactor.wait(0.05, events) == 0);
+    rx.read(bfr, sizeof(bfr));
+    reactor.remove(rx);
+  }
+
+  {
+    reactor.add(tx, Reactor::EV_WRITE, &tag);
+    bool ok = reactor.wait(1.0, events) == 1
+      && (events[0].events & Reactor::EV_WRITE);
+    test.boolean("write readiness", ok);
+
+    reactor.modify(tx, Reactor::EV_READ);
+    test.boolean("modify()", reactor.wait(0.05, events) == 0);
+    reactor.remove(tx);
+  }
+
+  {
+    unsigned timer = reactor.addTimer(0.05, &tag);
+    double start = Time::Clock::getReal();
+    bool ok = reactor.wait(1.0, events) == 1
+      && events[0].data == &tag
+      && events[0].events == Reactor::EV_TIMER
+      && events[0].expirations >= 1;
+    test.boolean("timer", ok);
+    test.boolean("timer period", Time::Clock::getReal() - start >= 0.04);
+
+    Time::Delay::wait(0.2);
+    ok = reactor.wait(1.0, events) == 1 && events[0].expirations >= 3;
+    test.boolean("timer expirations", ok);
+
+    reactor.removeTimer(timer);
+    test.boolean("removeTimer()", reactor.wait(0.1, events) == 0);
+  }
+
+  {
+    Waker waker(reactor);
+    double start = Time::Clock::getReal();
+    waker.start();
+    test.boolean("wakeup() from thread", reactor.wait(5.0, events) == 0);
+    test.boolean("wakeup() latency", Time::Clock::getReal() - start < 1.0);
+    waker.stopAndJoin();
+  }
+
+  {
+    reactor.wakeup();
+    reactor.wakeup();
+    double start = Time::Clock::getReal();
+    reactor.wait(5.0, events);
+    test.boolean("wakeup() before wait()", Time::Clock::getReal() - start < 1.0);
+
+    start = Time::Clock::getReal();
+    reactor.wait(0.05, events);
+    test.boolean("wakeup() is coalesced", Time::Clock::getReal() - start >= 0.04);
+  }
+
+  {
+    // Wake ups racing with the wait that clears them must not be
+    // lost for good.
+    Hammer hammer(reactor);
+    hammer.start();
+    while (!hammer.isDead())
+      reactor.wait(0, events);
+    hammer.join();
+    reactor.wait(0, events);
+
+    Waker waker(reactor);
+    double start = Time::Clock::getReal();
+    waker.start();
+    reactor.wait(5.0, events);
+    test.boolean("wakeup() after concurrent wakeups", Time::Clock::getReal() - start < 1.0);
+    waker.stopAndJoin();
+  }
+
+  return test.getReturnValue();
+}
@@ -0,0 +1,79 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/IMC.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE;
+
+int
+main(void)
+{
+  Test test("IMC::SharedMessage");
+
+  {
+    IMC::SharedMessage handle;
+    test.boolean("empty handle", handle.isNull() && handle.get() == NULL);
+    test.boolean("empty reference count", handle.getReferenceCount() == 0);
+  }
+
+  {
+    IMC::Heartbeat msg;
+    msg.setTimeStamp(1.5);
+    IMC::SharedMessage handle = IMC::SharedMessage::copy(&msg);
+    test.boolean("copy()", !handle.isNull() && handle.get() != &msg && *handle == msg);
+    test.boolean("reference count", handle.getReferenceCount() == 1);
+
+    std::vector<IMC::SharedMessage> handles(10, handle);
+    test.boolean("shared reference count", handle.getReferenceCount() == 11);
+
+    bool same = true;
+    for (unsigned i = 0; i < handles.size(); ++i)
+      same = same && (handles[i].get() == handle.get());
+    test.boolean("shared object", same);
+
+    handles.clear();
+    test.boolean("released references", handle.getReferenceCount() == 1);
+
+    IMC::SharedMessage other;
+    other = handle;
+    test.boolean("assignment", other.get() == handle.get() && handle.getReferenceCount() == 2);
+
+    other = IMC::SharedMessage();
+    test.boolean("assignment (empty)", other.isNull() && handle.getReferenceCount() == 1);
+  }
+
+  return test.getReturnValue();
+}
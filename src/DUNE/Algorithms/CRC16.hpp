@@ -47,6 +47,9 @@ namespace DUNE
     class CRC16
     {
     public:
+      //! Minimum buffer length for which slicing-by-8 is used.
+      static const uint16_t c_slice_length = 16;
+
       //! Compute the CRC-16-IBM of a given data buffer.
       //! @param buffer data buffer.
       //! @param len data buffer length.
@@ -55,12 +58,26 @@ namespace DUNE
       static inline uint16_t
       compute(const uint8_t* buffer, uint16_t len, uint16_t crc = 0)
       {
+        if (len >= c_slice_length)
+          return computeSliced(buffer, len, crc);
+
         while (len--)
           crc = (crc >> 8) ^ c_crc16_ibm_table[(crc ^ *buffer++) & 0xff];
 
         return crc;
       }
 
+      //! Compute the CRC-16-IBM of a given data buffer, eight bytes
+      //! at a time (slicing-by-8). The result is the same as the one
+      //! of the byte-wise algorithm, but the additional tables only
+      //! pay off for buffers of more than a few bytes.
+      //! @param buffer data buffer.
+      //! @param len data buffer length.
+      //! @param crc CRC-16-IBM value to update.
+      //! @return computed CRC-16-IBM.
+      static uint16_t
+      computeSliced(const uint8_t* buffer, uint16_t len, uint16_t crc = 0);
+
       //! Compute the CRC-16-IBM of a given byte.
       //! @param byte byte.
       //! @param crc CRC-16-IBM value to update.
@@ -53,6 +53,8 @@ namespace DUNE
 #include <DUNE/Concurrency/Scheduler.hpp>
 #include <DUNE/Concurrency/Constants.hpp>
 #include <DUNE/Concurrency/TSQueue.hpp>
+#include <DUNE/Concurrency/LockFreeQueue.hpp>
+#include <DUNE/Concurrency/Event.hpp>
 #include <DUNE/Concurrency/Process.hpp>
 #include <DUNE/Concurrency/SharedMemory.hpp>
 #include <DUNE/Concurrency/Semaphore.hpp>
@@ -0,0 +1,218 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/System/Error.hpp>
+#include <DUNE/Concurrency/Event.hpp>
+#include <DUNE/Concurrency/ScopedCondition.hpp>
+#include <DUNE/Time/Clock.hpp>
+#include <DUNE/Time/Constants.hpp>
+
+// POSIX headers.
+#if defined(DUNE_CONCURRENCY_EVENT_EVENTFD)
+#  include <sys/eventfd.h>
+#  include <poll.h>
+#  include <unistd.h>
+#  include <cerrno>
+#endif
+
+#if defined(DUNE_CONCURRENCY_EVENT_TIMERFD)
+#  include <sys/timerfd.h>
+#  include <cstring>
+#endif
+
+namespace DUNE
+{
+  namespace Concurrency
+  {
+#if defined(DUNE_CONCURRENCY_EVENT_EVENTFD)
+    Event::Event(void):
+      m_waiters(0)
+#  if defined(DUNE_CONCURRENCY_EVENT_TIMERFD)
+      , m_timer_fd(-1)
+#  endif
+    {
+      m_fd = eventfd(0, EFD_NONBLOCK);
+      if (m_fd == -1)
+        throw System::Error(errno, "creating event");
+    }
+
+    Event::~Event(void)
+    {
+#  if defined(DUNE_CONCURRENCY_EVENT_TIMERFD)
+      if (m_timer_fd != -1)
+        close(m_timer_fd);
+#  endif
+      close(m_fd);
+    }
+
+    void
+    Event::signal(void)
+    {
+      __sync_synchronize();
+      if (m_waiters == 0)
+        return;
+
+      uint64_t value = 1;
+      if (write(m_fd, &value, sizeof(value)) < 0)
+        return;
+    }
+
+    void
+    Event::prepareWait(void)
+    {
+      __sync_add_and_fetch(&m_waiters, 1);
+    }
+
+    void
+    Event::cancelWait(void)
+    {
+      __sync_sub_and_fetch(&m_waiters, 1);
+    }
+
+    bool
+    Event::wait(double timeout)
+    {
+      pollfd pfd;
+      pfd.fd = m_fd;
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+
+      // Round up, truncating would turn short timeouts into busy polls.
+      int ms = (timeout < 0) ? -1 : (int)std::ceil(timeout * 1000.0);
+      int rv = ::poll(&pfd, 1, ms);
+      __sync_sub_and_fetch(&m_waiters, 1);
+
+      if (rv <= 0)
+        return false;
+
+      uint64_t value = 0;
+      return read(m_fd, &value, sizeof(value)) == sizeof(value);
+    }
+
+    bool
+    Event::waitUntil(uint64_t deadline)
+    {
+#  if defined(DUNE_CONCURRENCY_EVENT_TIMERFD)
+      if (m_timer_fd == -1)
+        m_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+
+      itimerspec its;
+      std::memset(&its, 0, sizeof(its));
+      its.it_value.tv_sec = deadline / Time::c_nsec_per_sec;
+      its.it_value.tv_nsec = deadline % Time::c_nsec_per_sec;
+      // A zero expiration would disarm the timer.
+      if (deadline == 0)
+        its.it_value.tv_nsec = 1;
+
+      if (m_timer_fd != -1
+          && timerfd_settime(m_timer_fd, TFD_TIMER_ABSTIME, &its, NULL) == 0)
+      {
+        pollfd pfds[2];
+        pfds[0].fd = m_fd;
+        pfds[0].events = POLLIN;
+        pfds[0].revents = 0;
+        pfds[1].fd = m_timer_fd;
+        pfds[1].events = POLLIN;
+        pfds[1].revents = 0;
+
+        int rv = ::poll(pfds, 2, -1);
+        __sync_sub_and_fetch(&m_waiters, 1);
+
+        if (rv <= 0)
+          return false;
+
+        uint64_t value = 0;
+        if (pfds[1].revents & POLLIN)
+        {
+          if (read(m_timer_fd, &value, sizeof(value)) < 0)
+            value = 0;
+        }
+
+        if ((pfds[0].revents & POLLIN) == 0)
+          return false;
+
+        return read(m_fd, &value, sizeof(value)) == sizeof(value);
+      }
+#  endif
+
+      uint64_t now = Time::Clock::getRealNsec();
+      return wait((deadline > now) ? (deadline - now) / Time::c_nsec_per_sec_fp : 0.0);
+    }
+
+#else
+    Event::Event(void):
+      m_signalled(false)
+    { }
+
+    Event::~Event(void)
+    { }
+
+    void
+    Event::signal(void)
+    {
+      ScopedCondition l(m_cond);
+      m_signalled = true;
+      m_cond.signal();
+    }
+
+    void
+    Event::prepareWait(void)
+    { }
+
+    void
+    Event::cancelWait(void)
+    { }
+
+    bool
+    Event::wait(double timeout)
+    {
+      ScopedCondition l(m_cond);
+
+      if (!m_signalled && timeout != 0)
+        m_cond.wait(timeout);
+
+      bool rv = m_signalled;
+      m_signalled = false;
+      return rv;
+    }
+
+    bool
+    Event::waitUntil(uint64_t deadline)
+    {
+      uint64_t now = Time::Clock::getRealNsec();
+      return wait((deadline > now) ? (deadline - now) / Time::c_nsec_per_sec_fp : 0.0);
+    }
+#endif
+  }
+}
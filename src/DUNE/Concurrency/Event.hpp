@@ -0,0 +1,138 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+#ifndef DUNE_CONCURRENCY_EVENT_HPP_INCLUDED_
+#define DUNE_CONCURRENCY_EVENT_HPP_INCLUDED_
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/Concurrency/Condition.hpp>
+
+// Check if we can use eventfd(2) and GCC's atomic functions.
+#if defined(DUNE_SYS_HAS_SYS_EVENTFD_H) && defined(DUNE_SYS_HAS___SYNC_ADD_AND_FETCH) \
+  && defined(DUNE_SYS_HAS___SYNC_SUB_AND_FETCH) && defined(DUNE_SYS_HAS___SYNC_SYNCHRONIZE)
+#  ifndef DUNE_CONCURRENCY_EVENT_EVENTFD
+#    define DUNE_CONCURRENCY_EVENT_EVENTFD
+#  endif
+#endif
+
+// Check if we can also wait for absolute deadlines with timerfd(2).
+#if defined(DUNE_CONCURRENCY_EVENT_EVENTFD) && defined(DUNE_SYS_HAS_SYS_TIMERFD_H) \
+  && defined(DUNE_SYS_HAS_TIMERFD_CREATE)
+#  ifndef DUNE_CONCURRENCY_EVENT_TIMERFD
+#    define DUNE_CONCURRENCY_EVENT_TIMERFD
+#  endif
+#endif
+
+namespace DUNE
+{
+  namespace Concurrency
+  {
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM Event;
+
+    //! Lightweight wake up primitive used by a single consumer to
+    //! block until one or more producers signal that new data is
+    //! available. Signalling is a plain memory access when nobody is
+    //! waiting. The consumer must announce its intention to wait with
+    //! prepareWait(), check its predicate once more and then either
+    //! call wait() or cancelWait():
+    //!
+    //! @code
+    //! event.prepareWait();
+    //! if (queue.empty())
+    //!   event.wait(timeout);
+    //! else
+    //!   event.cancelWait();
+    //! @endcode
+    class Event
+    {
+    public:
+      //! Constructor.
+      Event(void);
+
+      //! Destructor.
+      ~Event(void);
+
+      //! Wake up the waiting thread, if any.
+      void
+      signal(void);
+
+      //! Announce that the calling thread is about to wait.
+      void
+      prepareWait(void);
+
+      //! Withdraw a previous call to prepareWait().
+      void
+      cancelWait(void);
+
+      //! Block until the event is signalled or a timeout expires.
+      //! Must be preceded by prepareWait().
+      //! @param[in] timeout timeout in seconds, use a negative
+      //! number to wait forever.
+      //! @return true if the event was signalled, false otherwise.
+      bool
+      wait(double timeout = -1.0);
+
+      //! Block until the event is signalled or an absolute deadline
+      //! of the real monotonic clock (Time::Clock::getRealNsec()) is
+      //! reached. Must be preceded by prepareWait().
+      //! @param[in] deadline deadline in nanoseconds.
+      //! @return true if the event was signalled, false otherwise.
+      bool
+      waitUntil(uint64_t deadline);
+
+    private:
+#if defined(DUNE_CONCURRENCY_EVENT_EVENTFD)
+      //! Number of waiting threads.
+      volatile int m_waiters;
+      //! Event file descriptor.
+      int m_fd;
+#  if defined(DUNE_CONCURRENCY_EVENT_TIMERFD)
+      //! Deadline timer file descriptor, created on first use.
+      int m_timer_fd;
+#  endif
+#else
+      //! Condition variable.
+      Condition m_cond;
+      //! True if the event was signalled.
+      bool m_signalled;
+#endif
+
+      //! Non-copyable.
+      Event(const Event&);
+
+      //! Non-assignable.
+      Event&
+      operator=(const Event&);
+    };
+  }
+}
+
+#endif
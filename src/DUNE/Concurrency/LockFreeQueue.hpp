@@ -0,0 +1,259 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+#ifndef DUNE_CONCURRENCY_LOCK_FREE_QUEUE_HPP_INCLUDED_
+#define DUNE_CONCURRENCY_LOCK_FREE_QUEUE_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cstddef>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/Concurrency/Mutex.hpp>
+#include <DUNE/Concurrency/ScopedMutex.hpp>
+
+// Check if we can use GCC's atomic functions.
+#if defined(DUNE_SYS_HAS___SYNC_BOOL_COMPARE_AND_SWAP) && defined(DUNE_SYS_HAS___SYNC_SYNCHRONIZE)
+#  ifndef DUNE_CONCURRENCY_LOCK_FREE_QUEUE_GCC
+#    define DUNE_CONCURRENCY_LOCK_FREE_QUEUE_GCC
+#  endif
+#endif
+
+namespace DUNE
+{
+  namespace Concurrency
+  {
+    //! Bounded first-in, first-out queue that can be used
+    //! concurrently by multiple producers and consumers without
+    //! locks. Each slot carries a sequence number that tells
+    //! producers and consumers whether it is free or holds an
+    //! element, so the only contended operation is a compare and
+    //! swap of the head or tail position. The capacity is rounded up
+    //! to the next power of two.
+    template <typename T>
+    class LockFreeQueue
+    {
+    public:
+      //! Constructor.
+      //! @param[in] capacity maximum number of elements.
+      LockFreeQueue(size_t capacity = 1024):
+        m_mask(0),
+        m_tail(0),
+        m_head(0)
+      {
+        size_t size = 2;
+        while (size < capacity)
+          size <<= 1;
+
+        m_mask = size - 1;
+        m_cells.resize(size);
+        for (size_t i = 0; i < size; ++i)
+          m_cells[i].sequence = i;
+      }
+
+      //! Retrieve the maximum number of elements.
+      //! @return queue capacity.
+      size_t
+      capacity(void) const
+      {
+        return m_mask + 1;
+      }
+
+      //! Add an element to the end of the queue.
+      //! @param[in] v element.
+      //! @return true if the element was added, false if the queue
+      //! is full.
+      bool
+      push(const T& v)
+      {
+#if defined(DUNE_CONCURRENCY_LOCK_FREE_QUEUE_GCC)
+        Cell* cell = NULL;
+        size_t pos = m_tail;
+
+        while (true)
+        {
+          cell = &m_cells[pos & m_mask];
+          size_t seq = cell->sequence;
+          __sync_synchronize();
+          long dif = (long)seq - (long)pos;
+
+          if (dif == 0)
+          {
+            if (__sync_bool_compare_and_swap(&m_tail, pos, pos + 1))
+              break;
+          }
+          else if (dif < 0)
+          {
+            return false;
+          }
+
+          pos = m_tail;
+        }
+
+        cell->data = v;
+        __sync_synchronize();
+        cell->sequence = pos + 1;
+        return true;
+#else
+        ScopedMutex l(m_lock);
+        Cell& cell = m_cells[m_tail & m_mask];
+        if (cell.sequence != m_tail)
+          return false;
+
+        cell.data = v;
+        cell.sequence = m_tail + 1;
+        ++m_tail;
+        return true;
+#endif
+      }
+
+      //! Remove the first element of the queue.
+      //! @param[out] v element.
+      //! @return true if an element was removed, false if the queue
+      //! is empty.
+      bool
+      pop(T& v)
+      {
+#if defined(DUNE_CONCURRENCY_LOCK_FREE_QUEUE_GCC)
+        Cell* cell = NULL;
+        size_t pos = m_head;
+
+        while (true)
+        {
+          cell = &m_cells[pos & m_mask];
+          size_t seq = cell->sequence;
+          __sync_synchronize();
+          long dif = (long)seq - (long)(pos + 1);
+
+          if (dif == 0)
+          {
+            if (__sync_bool_compare_and_swap(&m_head, pos, pos + 1))
+              break;
+          }
+          else if (dif < 0)
+          {
+            return false;
+          }
+
+          pos = m_head;
+        }
+
+        v = cell->data;
+        cell->data = T();
+        __sync_synchronize();
+        cell->sequence = pos + m_mask + 1;
+        return true;
+#else
+        ScopedMutex l(m_lock);
+        Cell& cell = m_cells[m_head & m_mask];
+        if (cell.sequence != m_head + 1)
+          return false;
+
+        v = cell.data;
+        cell.data = T();
+        cell.sequence = m_head + m_mask + 1;
+        ++m_head;
+        return true;
+#endif
+      }
+
+      //! Remove up to a given number of elements from the queue.
+      //! @param[out] batch container where elements are appended.
+      //! @param[in] max maximum number of elements to remove.
+      //! @return number of elements removed.
+      size_t
+      pop(std::vector<T>& batch, size_t max)
+      {
+        T v;
+        size_t count = 0;
+        while (count < max && pop(v))
+        {
+          batch.push_back(v);
+          ++count;
+        }
+
+        return count;
+      }
+
+      //! Test if the queue is empty. The result is only a hint when
+      //! other threads are using the queue.
+      //! @return true if the queue is empty, false otherwise.
+      bool
+      empty(void) const
+      {
+        return size() == 0;
+      }
+
+      //! Retrieve the number of elements in the queue. The result is
+      //! only a hint when other threads are using the queue.
+      //! @return number of elements.
+      size_t
+      size(void) const
+      {
+        size_t tail = m_tail;
+        size_t head = m_head;
+        return (tail > head) ? (tail - head) : 0;
+      }
+
+    private:
+      //! Queue slot.
+      struct Cell
+      {
+        //! Sequence number.
+        volatile size_t sequence;
+        //! Element.
+        T data;
+      };
+
+      //! Queue slots.
+      std::vector<Cell> m_cells;
+      //! Index mask.
+      size_t m_mask;
+      //! Position of the next element to be written.
+      volatile size_t m_tail;
+      //! Position of the next element to be read.
+      volatile size_t m_head;
+
+#if !defined(DUNE_CONCURRENCY_LOCK_FREE_QUEUE_GCC)
+      //! Explicit lock for generic implementation.
+      Mutex m_lock;
+#endif
+
+      //! Non-copyable.
+      LockFreeQueue(const LockFreeQueue&);
+
+      //! Non-assignable.
+      LockFreeQueue&
+      operator=(const LockFreeQueue&);
+    };
+  }
+}
+
+#endif
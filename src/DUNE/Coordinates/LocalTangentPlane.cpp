@@ -0,0 +1,165 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+
+// DUNE headers.
+#include <DUNE/Coordinates/LocalTangentPlane.hpp>
+#include <DUNE/Coordinates/WGS84.hpp>
+
+namespace DUNE
+{
+  namespace Coordinates
+  {
+    //! Convert WGS-84 coordinates to ECEF coordinates.
+    static inline void
+    toECEF(double lat, double lon, double hae, double* x, double* y, double* z)
+    {
+      double slat = std::sin(lat);
+      double clat = std::cos(lat);
+      double rn = c_wgs84_a / std::sqrt(1.0 - c_wgs84_e2 * slat * slat);
+
+      *x = (rn + hae) * clat * std::cos(lon);
+      *y = (rn + hae) * clat * std::sin(lon);
+      *z = ((1.0 - c_wgs84_e2) * rn + hae) * slat;
+    }
+
+    //! Convert ECEF coordinates to WGS-84 coordinates using one step
+    //! of Bowring's method, which is accurate to well below a
+    //! millimeter for points near the surface of the Earth.
+    static inline void
+    fromECEF(double x, double y, double z, double* lat, double* lon, double* hae)
+    {
+      double p = std::sqrt(x * x + y * y);
+      double u = z * c_wgs84_a;
+      double v = p * c_wgs84_b;
+      double r = std::sqrt(u * u + v * v);
+      double st = u / r;
+      double ct = v / r;
+
+      double num = z + c_wgs84_ep2 * c_wgs84_b * st * st * st;
+      double den = p - c_wgs84_e2 * c_wgs84_a * ct * ct * ct;
+
+      *lat = std::atan2(num, den);
+      *lon = std::atan2(y, x);
+
+      if (hae != NULL)
+      {
+        double h = std::sqrt(num * num + den * den);
+        double slat = num / h;
+        double clat = den / h;
+        *hae = p * clat + z * slat - c_wgs84_a * std::sqrt(1.0 - c_wgs84_e2 * slat * slat);
+      }
+    }
+
+    LocalTangentPlane::LocalTangentPlane(void)
+    {
+      setOrigin(0.0, 0.0, 0.0);
+    }
+
+    LocalTangentPlane::LocalTangentPlane(double lat, double lon, double hae)
+    {
+      setOrigin(lat, lon, hae);
+    }
+
+    void
+    LocalTangentPlane::setOrigin(double lat, double lon, double hae)
+    {
+      m_lat = lat;
+      m_lon = lon;
+      m_hae = hae;
+
+      toECEF(lat, lon, hae, &m_ecef[0], &m_ecef[1], &m_ecef[2]);
+
+      double slat = std::sin(lat);
+      double clat = std::cos(lat);
+      double slon = std::sin(lon);
+      double clon = std::cos(lon);
+
+      // North.
+      m_rot[0] = -slat * clon;
+      m_rot[1] = -slat * slon;
+      m_rot[2] = clat;
+      // East.
+      m_rot[3] = -slon;
+      m_rot[4] = clon;
+      m_rot[5] = 0.0;
+      // Down.
+      m_rot[6] = -clat * clon;
+      m_rot[7] = -clat * slon;
+      m_rot[8] = -slat;
+    }
+
+    void
+    LocalTangentPlane::toNED(double lat, double lon, double hae, double* n, double* e, double* d) const
+    {
+      double x;
+      double y;
+      double z;
+      toECEF(lat, lon, hae, &x, &y, &z);
+
+      x -= m_ecef[0];
+      y -= m_ecef[1];
+      z -= m_ecef[2];
+
+      *n = m_rot[0] * x + m_rot[1] * y + m_rot[2] * z;
+      *e = m_rot[3] * x + m_rot[4] * y;
+
+      if (d != NULL)
+        *d = m_rot[6] * x + m_rot[7] * y + m_rot[8] * z;
+    }
+
+    void
+    LocalTangentPlane::toNED(const double* lat, const double* lon, const double* hae, size_t count,
+                             double* n, double* e, double* d) const
+    {
+      for (size_t i = 0; i < count; ++i)
+        toNED(lat[i], lon[i], hae[i], &n[i], &e[i], (d == NULL) ? NULL : &d[i]);
+    }
+
+    void
+    LocalTangentPlane::fromNED(double n, double e, double d, double* lat, double* lon, double* hae) const
+    {
+      double x = m_ecef[0] + m_rot[0] * n + m_rot[3] * e + m_rot[6] * d;
+      double y = m_ecef[1] + m_rot[1] * n + m_rot[4] * e + m_rot[7] * d;
+      double z = m_ecef[2] + m_rot[2] * n + m_rot[8] * d;
+
+      fromECEF(x, y, z, lat, lon, hae);
+    }
+
+    void
+    LocalTangentPlane::fromNED(const double* n, const double* e, const double* d, size_t count,
+                               double* lat, double* lon, double* hae) const
+    {
+      for (size_t i = 0; i < count; ++i)
+        fromNED(n[i], e[i], d[i], &lat[i], &lon[i], (hae == NULL) ? NULL : &hae[i]);
+    }
+  }
+}
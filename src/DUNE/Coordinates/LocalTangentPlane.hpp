@@ -0,0 +1,161 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+#ifndef DUNE_COORDINATES_LOCAL_TANGENT_PLANE_HPP_INCLUDED_
+#define DUNE_COORDINATES_LOCAL_TANGENT_PLANE_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cstddef>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+
+namespace DUNE
+{
+  namespace Coordinates
+  {
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM LocalTangentPlane;
+
+    //! North-East-Down frame tangent to the WGS-84 ellipsoid at a
+    //! fixed origin. The origin's ECEF coordinates and rotation are
+    //! computed once, so conversions of many points relative to the
+    //! same origin are much cheaper than calling WGS84::displacement()
+    //! or WGS84::displace() for each of them.
+    class LocalTangentPlane
+    {
+    public:
+      //! Create a tangent plane at latitude and longitude zero.
+      LocalTangentPlane(void);
+
+      //! Create a tangent plane at a given origin.
+      //! @param[in] lat WGS-84 latitude of the origin (rad).
+      //! @param[in] lon WGS-84 longitude of the origin (rad).
+      //! @param[in] hae height above WGS-84 ellipsoid of the origin (m).
+      LocalTangentPlane(double lat, double lon, double hae);
+
+      //! Change the origin of the tangent plane.
+      //! @param[in] lat WGS-84 latitude of the origin (rad).
+      //! @param[in] lon WGS-84 longitude of the origin (rad).
+      //! @param[in] hae height above WGS-84 ellipsoid of the origin (m).
+      void
+      setOrigin(double lat, double lon, double hae);
+
+      //! Get latitude of the origin.
+      //! @return WGS-84 latitude (rad).
+      double
+      getLatitude(void) const
+      {
+        return m_lat;
+      }
+
+      //! Get longitude of the origin.
+      //! @return WGS-84 longitude (rad).
+      double
+      getLongitude(void) const
+      {
+        return m_lon;
+      }
+
+      //! Get height of the origin.
+      //! @return height above WGS-84 ellipsoid (m).
+      double
+      getHeight(void) const
+      {
+        return m_hae;
+      }
+
+      //! Compute North-East-Down displacement of a WGS-84 coordinate
+      //! from the origin. The result is the same as the one of
+      //! WGS84::displacement().
+      //! @param[in] lat WGS-84 latitude (rad).
+      //! @param[in] lon WGS-84 longitude (rad).
+      //! @param[in] hae height above WGS-84 ellipsoid (m).
+      //! @param[out] n storage for North offset (m).
+      //! @param[out] e storage for East offset (m).
+      //! @param[out] d storage for Down offset (m), may be NULL.
+      void
+      toNED(double lat, double lon, double hae, double* n, double* e, double* d = NULL) const;
+
+      //! Compute North-East-Down displacements of many WGS-84
+      //! coordinates from the origin.
+      //! @param[in] lat WGS-84 latitudes (rad).
+      //! @param[in] lon WGS-84 longitudes (rad).
+      //! @param[in] hae heights above WGS-84 ellipsoid (m).
+      //! @param[in] count number of coordinates.
+      //! @param[out] n storage for North offsets (m).
+      //! @param[out] e storage for East offsets (m).
+      //! @param[out] d storage for Down offsets (m), may be NULL.
+      void
+      toNED(const double* lat, const double* lon, const double* hae, size_t count,
+            double* n, double* e, double* d = NULL) const;
+
+      //! Compute the WGS-84 coordinate of a North-East-Down
+      //! displacement from the origin. This is the exact inverse of
+      //! toNED().
+      //! @param[in] n North offset (m).
+      //! @param[in] e East offset (m).
+      //! @param[in] d Down offset (m).
+      //! @param[out] lat storage for WGS-84 latitude (rad).
+      //! @param[out] lon storage for WGS-84 longitude (rad).
+      //! @param[out] hae storage for height above WGS-84 ellipsoid (m),
+      //!             may be NULL.
+      void
+      fromNED(double n, double e, double d, double* lat, double* lon, double* hae = NULL) const;
+
+      //! Compute the WGS-84 coordinates of many North-East-Down
+      //! displacements from the origin.
+      //! @param[in] n North offsets (m).
+      //! @param[in] e East offsets (m).
+      //! @param[in] d Down offsets (m).
+      //! @param[in] count number of displacements.
+      //! @param[out] lat storage for WGS-84 latitudes (rad).
+      //! @param[out] lon storage for WGS-84 longitudes (rad).
+      //! @param[out] hae storage for heights above WGS-84 ellipsoid
+      //!             (m), may be NULL.
+      void
+      fromNED(const double* n, const double* e, const double* d, size_t count,
+              double* lat, double* lon, double* hae = NULL) const;
+
+    private:
+      //! Latitude of the origin.
+      double m_lat;
+      //! Longitude of the origin.
+      double m_lon;
+      //! Height of the origin.
+      double m_hae;
+      //! ECEF coordinates of the origin.
+      double m_ecef[3];
+      //! Rotation from ECEF to NED, in row-major order.
+      double m_rot[9];
+    };
+  }
+}
+
+#endif
@@ -42,8 +42,13 @@ namespace DUNE
 #include <DUNE/IMC/InlineMessage.hpp>
 #include <DUNE/IMC/MessageList.hpp>
 #include <DUNE/IMC/Message.hpp>
+#include <DUNE/IMC/SharedMessage.hpp>
+#include <DUNE/IMC/DeliveryStatistics.hpp>
 #include <DUNE/IMC/Factory.hpp>
 #include <DUNE/IMC/Packet.hpp>
+#include <DUNE/IMC/PacketView.hpp>
+#include <DUNE/IMC/LsfIndex.hpp>
+#include <DUNE/IMC/LsfReader.hpp>
 #include <DUNE/IMC/Macros.hpp>
 #include <DUNE/IMC/AddressResolver.hpp>
 #include <DUNE/IMC/Parser.hpp>
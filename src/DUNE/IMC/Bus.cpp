@@ -28,11 +28,13 @@
 //***************************************************************************
 
 // ISO C++ 98 headers.
-#include <algorithm>
+#include <set>
 
 // DUNE headers.
 #include <DUNE/Streams/Terminal.hpp>
 #include <DUNE/Utils/String.hpp>
+#include <DUNE/Time/Clock.hpp>
+#include <DUNE/Time/Delay.hpp>
 #include <DUNE/IMC/Factory.hpp>
 #include <DUNE/IMC/Bus.hpp>
 #include <DUNE/IMC/Message.hpp>
@@ -42,25 +44,26 @@ namespace DUNE
 {
   namespace IMC
   {
+    //! Time to wait between checks for dispatchers using a retired
+    //! table of recipients.
+    static const double c_grace_period_delay = 0.0001;
+
     struct BackLogEntry
     {
-      BackLogEntry(const Message* msg, Tasks::AbstractTask* exc):
-        message(msg->clone()),
+      BackLogEntry(const SharedMessage& msg, Tasks::AbstractTask* exc):
+        message(msg),
         exclude(exc)
       {  }
 
-      ~BackLogEntry(void)
-      {
-        delete message;
-      }
-
       //! Message.
-      Message* message;
+      SharedMessage message;
       //! Exclude this task.
       Tasks::AbstractTask* exclude;
     };
 
     Bus::Bus(void):
+      m_table(new RecipientTable),
+      m_epoch(0),
       m_paused(false)
     { }
 
@@ -75,9 +78,26 @@ namespace DUNE
 
       for (unsigned i = 0; i < m_bind_msgs.size(); ++i)
         delete m_bind_msgs[i];
+
+      for (unsigned i = 0; i < m_stats.size(); ++i)
+        delete m_stats[i];
+
+      release(m_table);
     }
 
-    void
+    size_t
+    Bus::findRecipient(const RecipientList& list, Tasks::AbstractTask* task)
+    {
+      for (size_t i = 0; i < list.size(); ++i)
+      {
+        if (list[i].task == task)
+          return i;
+      }
+
+      return list.size();
+    }
+
+    DeliveryStatistics*
     Bus::registerRecipient(Tasks::AbstractTask* task, uint16_t id)
     {
       TransportBindings* bind = new TransportBindings;
@@ -86,40 +106,168 @@ namespace DUNE
       bind->consumer = task->getName();
       bind->message_id = id;
 
-      Concurrency::ScopedRWLock l(m_lock, true);
+      Concurrency::ScopedMutex l(m_lock);
       m_bind_msgs.push_back(bind);
-      TransportList::iterator itr = std::find(m_recipients[id].begin(), m_recipients[id].end(), task);
-      if (itr == m_recipients[id].end())
-        m_recipients[id].push_back(task);
+
+      if (id < m_table->lists.size())
+      {
+        const RecipientList& list = m_table->lists[id];
+        size_t index = findRecipient(list, task);
+        if (index != list.size())
+          return list[index].stats;
+      }
+
+      // Statistics are kept when a task unsubscribes, reuse them if
+      // it subscribes again.
+      Subscription sub;
+      sub.task = task;
+      sub.stats = NULL;
+
+      for (size_t i = 0; i < m_stats.size(); ++i)
+      {
+        if (m_stats[i]->getTask() == task && m_stats[i]->getId() == id)
+        {
+          sub.stats = m_stats[i];
+          break;
+        }
+      }
+
+      if (sub.stats == NULL)
+      {
+        sub.stats = new DeliveryStatistics(task, id);
+        m_stats.push_back(sub.stats);
+      }
+
+      RecipientTable* table = new RecipientTable;
+      table->lists = m_table->lists;
+      if (id >= table->lists.size())
+        table->lists.resize(id + 1);
+      table->lists[id].push_back(sub);
+      publish(table);
+
+      return sub.stats;
     }
 
     void
     Bus::unregisterRecipient(Tasks::AbstractTask* task, uint16_t id)
     {
-      Concurrency::ScopedRWLock l(m_lock, true);
-      m_recipients[id].remove(task);
+      Concurrency::ScopedMutex l(m_lock);
+
+      if (id >= m_table->lists.size())
+        return;
+
+      const RecipientList& list = m_table->lists[id];
+      size_t index = findRecipient(list, task);
+      if (index == list.size())
+        return;
+
+      RecipientTable* table = new RecipientTable;
+      table->lists = m_table->lists;
+      RecipientList& dlst = table->lists[id];
+      dlst.erase(dlst.begin() + index);
+      publish(table);
+    }
+
+    void
+    Bus::publish(RecipientTable* table)
+    {
+      RecipientTable* old = m_table;
+      int epoch = m_epoch;
+
+      // Make the new table visible before starting a new epoch.
+      m_table = table;
+      m_readers[epoch].add(0);
+      m_epoch = 1 - epoch;
+
+      // Dispatchers that entered the previous epoch may still be
+      // taking a reference to the old table. This only takes a few
+      // instructions, deliveries in progress are not waited for.
+      while (m_readers[epoch].add(0) != 0)
+        Time::Delay::wait(c_grace_period_delay);
+
+      release(old);
+    }
+
+    Bus::RecipientTable*
+    Bus::acquire(void)
+    {
+      // Enter the current read epoch. If a table update started a
+      // new epoch in the meantime, try again in the new one.
+      int epoch = m_epoch;
+      m_readers[epoch].add(1);
+      while (epoch != m_epoch)
+      {
+        m_readers[epoch].sub(1);
+        epoch = m_epoch;
+        m_readers[epoch].add(1);
+      }
+
+      RecipientTable* table = m_table;
+      table->refs.add(1);
+      m_readers[epoch].sub(1);
+      return table;
+    }
+
+    void
+    Bus::release(RecipientTable* table)
+    {
+      if (table->refs.sub(1) == 0)
+        delete table;
     }
 
     void
     Bus::dispatch(const Message* msg, Tasks::AbstractTask* task)
     {
+      SharedMessage shared;
+      deliver(msg, shared, task);
+    }
+
+    void
+    Bus::dispatch(const SharedMessage& msg, Tasks::AbstractTask* task)
+    {
+      SharedMessage shared(msg);
+      deliver(msg.get(), shared, task);
+    }
+
+    void
+    Bus::deliver(const Message* msg, SharedMessage& shared, Tasks::AbstractTask* task)
+    {
+      // The bus is only paused during start up, avoid taking the
+      // lock on every dispatch once it has been resumed.
+      if (m_paused)
       {
         Concurrency::ScopedMutex lock(m_paused_lock);
         if (m_paused)
         {
-          m_back_log.push(new BackLogEntry(msg, task));
+          if (shared.isNull())
+            shared = SharedMessage::copy(msg);
+
+          m_back_log.push(new BackLogEntry(shared, task));
           return;
         }
       }
 
+      // Recipients may block until there is room in their inbox. The
+      // reference keeps the table alive without holding back updates.
+      RecipientTable* table = acquire();
       uint16_t id = msg->getId();
-      Concurrency::ScopedRWLock l(m_lock);
-      TransportList& dlst(m_recipients[id]);
-      for (TransportList::iterator itr = dlst.begin(); itr != dlst.end(); ++itr)
+
+      if (id < table->lists.size())
       {
-        if (*itr != task)
-          (*itr)->receive(msg);
+        const RecipientList& dlst = table->lists[id];
+        for (size_t i = 0; i < dlst.size(); ++i)
+        {
+          if (dlst[i].task == task)
+            continue;
+
+          if (shared.isNull())
+            shared = SharedMessage::copy(msg);
+
+          dlst[i].task->receive(shared, *dlst[i].stats);
+        }
       }
+
+      release(table);
     }
 
     void
@@ -145,5 +293,54 @@ namespace DUNE
     {
       return m_bind_msgs;
     }
+
+    void
+    Bus::getStatistics(std::vector<const DeliveryStatistics*>& stats)
+    {
+      Concurrency::ScopedMutex l(m_lock);
+      stats.assign(m_stats.begin(), m_stats.end());
+    }
+
+    bool
+    Bus::waitIdle(double timeout, Tasks::AbstractTask* task)
+    {
+      uint64_t deadline = Time::Clock::getRealNsec() + (uint64_t)(timeout * Time::c_nsec_per_sec_fp);
+
+      std::set<Tasks::AbstractTask*> tasks;
+      RecipientTable* table = acquire();
+      for (size_t i = 0; i < table->lists.size(); ++i)
+      {
+        for (size_t j = 0; j < table->lists[i].size(); ++j)
+          tasks.insert(table->lists[i][j].task);
+      }
+      release(table);
+      tasks.erase(task);
+
+      // Consuming messages may dispatch others to tasks that were
+      // already checked, stop after a pass without waits.
+      bool waited = true;
+      while (waited)
+      {
+        if (Time::Clock::getRealNsec() >= deadline)
+          return false;
+
+        waited = false;
+
+        std::set<Tasks::AbstractTask*>::iterator itr = tasks.begin();
+        for (; itr != tasks.end(); ++itr)
+        {
+          // Tasks that are stopping no longer consume messages.
+          if ((*itr)->isStopping() || (*itr)->isDead() || (*itr)->isIdle())
+            continue;
+
+          if (!(*itr)->waitIdle(deadline))
+            return false;
+
+          waited = true;
+        }
+      }
+
+      return true;
+    }
   }
 }
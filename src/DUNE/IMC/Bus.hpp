@@ -41,6 +41,9 @@
 
 // DUNE headers.
 #include <DUNE/Tasks/AbstractTask.hpp>
+#include <DUNE/IMC/SharedMessage.hpp>
+#include <DUNE/IMC/DeliveryStatistics.hpp>
+#include <DUNE/Concurrency/AtomicCounter.hpp>
 #include <DUNE/Concurrency/TSQueue.hpp>
 #include <DUNE/Concurrency/ScopedMutex.hpp>
 #include <DUNE/Concurrency/ScopedRWLock.hpp>
@@ -69,7 +72,8 @@ namespace DUNE
       //! identification number.
       //! @param task task object.
       //! @param id message identification number.
-      void
+      //! @return delivery statistics of the message to the task.
+      DeliveryStatistics*
       registerRecipient(Tasks::AbstractTask* task, uint16_t id);
 
       //! Unregister a task as a recipient of a given message
@@ -85,6 +89,14 @@ namespace DUNE
       void
       dispatch(const Message* msg, Tasks::AbstractTask* task = NULL);
 
+      //! Dispatches a shared message to registered listeners. The
+      //! message is delivered to every recipient without being
+      //! copied.
+      //! @param msg message handle.
+      //! @param task do not deliver message to this task.
+      void
+      dispatch(const SharedMessage& msg, Tasks::AbstractTask* task = NULL);
+
       inline void
       pause(void)
       {
@@ -98,14 +110,66 @@ namespace DUNE
       const std::vector<TransportBindings*>
       getBindings(void);
 
+      //! Retrieve the delivery statistics of every message to every
+      //! task that ever subscribed to it. The returned objects are
+      //! valid for the lifetime of the bus.
+      //! @param stats output vector.
+      void
+      getStatistics(std::vector<const DeliveryStatistics*>& stats);
+
+      //! Wait until every task subscribed to any message is idle,
+      //! i.e., consumed its queued messages and has no periodic run
+      //! due (see Tasks::AbstractTask::isIdle()). Used to step a
+      //! virtual clock without outrunning the consumers. Only one
+      //! thread may wait at a time.
+      //! @param timeout maximum amount of real time to wait for.
+      //! @param task do not wait for this task.
+      //! @return true if all tasks are idle, false if the timeout
+      //! expired.
+      bool
+      waitIdle(double timeout, Tasks::AbstractTask* task = NULL);
+
     private:
-      typedef std::list<Tasks::AbstractTask*> TransportList;
+      //! Subscription of a task to a message.
+      struct Subscription
+      {
+        //! Recipient task.
+        Tasks::AbstractTask* task;
+        //! Delivery statistics.
+        DeliveryStatistics* stats;
+      };
+
+      //! Tasks subscribed to a given message.
+      typedef std::vector<Subscription> RecipientList;
+
       //! Table of recipients.
-      std::map<uint16_t, TransportList> m_recipients;
-      //! Internal list lock.
-      Concurrency::RWLock m_lock;
+      struct RecipientTable
+      {
+        //! Subscriber lists indexed by message identification number.
+        std::vector<RecipientList> lists;
+        //! References held by the bus and by dispatchers. The table
+        //! is deleted when the last reference is released.
+        Concurrency::AtomicCounter refs;
+
+        RecipientTable(void):
+          refs(1)
+        { }
+      };
+
+      //! Current table of recipients. Tables are never modified
+      //! after being published, updates build and publish a new one.
+      RecipientTable* volatile m_table;
+      //! Parity of the current read epoch.
+      volatile int m_epoch;
+      //! Number of dispatchers taking a reference to the table in
+      //! each epoch.
+      Concurrency::AtomicCounter m_readers[2];
+      //! Serializes table updates.
+      Concurrency::Mutex m_lock;
+      //! Delivery statistics of all subscriptions.
+      std::vector<DeliveryStatistics*> m_stats;
       //! Bus is paused.
-      bool m_paused;
+      volatile bool m_paused;
       //! Pause lock.
       Concurrency::Mutex m_paused_lock;
       //! List containing all generated TransportBindings for future logging/reference.
@@ -113,6 +177,42 @@ namespace DUNE
       //! Back log queue. Saves messages when Bus is paused.
       Concurrency::TSQueue<BackLogEntry*> m_back_log;
 
+      //! Deliver a message to registered listeners. A single copy
+      //! of the message is made on demand and shared between all
+      //! recipients.
+      //! @param msg message to dispatch.
+      //! @param shared shared copy of the message (may be empty).
+      //! @param task do not deliver message to this task.
+      void
+      deliver(const Message* msg, SharedMessage& shared, Tasks::AbstractTask* task);
+
+      //! Find the subscription of a task in a list of recipients.
+      //! @param list list of recipients.
+      //! @param task task object.
+      //! @return subscription index or list size if not found.
+      static size_t
+      findRecipient(const RecipientList& list, Tasks::AbstractTask* task);
+
+      //! Replace the table of recipients. The previous table is
+      //! deleted once no dispatcher holds a reference to it. Only
+      //! dispatchers that are taking a reference are waited for, never
+      //! a delivery in progress, so tasks may subscribe and
+      //! unsubscribe while producers are blocked on their inbox. Must
+      //! be called with m_lock held.
+      //! @param table new table of recipients.
+      void
+      publish(RecipientTable* table);
+
+      //! Take a reference to the current table of recipients.
+      //! @return table of recipients.
+      RecipientTable*
+      acquire(void);
+
+      //! Release a reference to a table of recipients.
+      //! @param table table of recipients.
+      static void
+      release(RecipientTable* table);
+
       //! Non - copyable.
       Bus(Bus const&);
 
@@ -0,0 +1,252 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+#ifndef DUNE_IMC_DELIVERY_STATISTICS_HPP_INCLUDED_
+#define DUNE_IMC_DELIVERY_STATISTICS_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cstddef>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/Concurrency/AtomicCounter.hpp>
+#include <DUNE/Concurrency/Mutex.hpp>
+#include <DUNE/Concurrency/ScopedMutex.hpp>
+
+namespace DUNE
+{
+  namespace Tasks
+  {
+    // Forward declarations.
+    class AbstractTask;
+  }
+
+  namespace IMC
+  {
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM DeliveryStatistics;
+
+    //! Delivery counters of one message type to one task. Messages
+    //! are counted when the bus queues them for the task and when
+    //! the task's callbacks are invoked. The time between these two
+    //! events is recorded in a histogram with logarithmic buckets:
+    //! bucket 0 holds latencies below 1 us and bucket k holds
+    //! latencies from 2^(k-1) up to 2^k us. The last bucket also
+    //! holds every longer latency.
+    //!
+    //! The enqueue, drop and depth counters may be updated by any
+    //! thread, all other counters are only updated by the thread of
+    //! the recipient task. Counters may be read at any time.
+    class DeliveryStatistics
+    {
+    public:
+      //! Number of latency buckets.
+      static const unsigned c_latency_buckets = 24;
+
+      //! Constructor.
+      //! @param task recipient task.
+      //! @param id message identification number.
+      DeliveryStatistics(Tasks::AbstractTask* task, uint16_t id):
+        m_task(task),
+        m_id(id),
+        m_dequeued(0),
+        m_max_depth(0)
+      {
+        for (unsigned i = 0; i < c_latency_buckets; ++i)
+          m_latency[i] = 0;
+      }
+
+      //! Count a message queued for the task.
+      //! @param depth number of messages in the queue of the task
+      //! after the message was queued.
+      void
+      enqueued(size_t depth)
+      {
+        m_enqueued.add(1);
+
+        // Only a new maximum takes the lock.
+        if (depth > m_max_depth)
+        {
+          Concurrency::ScopedMutex l(m_depth_lock);
+          if (depth > m_max_depth)
+            m_max_depth = depth;
+        }
+      }
+
+      //! Count a message discarded because the queue of the task was
+      //! full.
+      void
+      dropped(void)
+      {
+        m_dropped.add(1);
+      }
+
+      //! Count a message delivered to the task's callbacks.
+      //! @param latency time the message waited, in nanoseconds.
+      void
+      dequeued(uint64_t latency)
+      {
+        ++m_dequeued;
+        ++m_latency[getBucket(latency)];
+      }
+
+      //! Retrieve the recipient task.
+      //! @return task object.
+      Tasks::AbstractTask*
+      getTask(void) const
+      {
+        return m_task;
+      }
+
+      //! Retrieve the message identification number.
+      //! @return message identification number.
+      uint16_t
+      getId(void) const
+      {
+        return m_id;
+      }
+
+      //! Retrieve the number of messages queued for the task.
+      //! @return number of messages.
+      unsigned
+      getEnqueued(void) const
+      {
+        return (unsigned)m_enqueued.add(0);
+      }
+
+      //! Retrieve the number of messages delivered to the task.
+      //! @return number of messages.
+      unsigned
+      getDequeued(void) const
+      {
+        return m_dequeued;
+      }
+
+      //! Retrieve the number of messages discarded because the queue
+      //! of the task was full.
+      //! @return number of messages.
+      unsigned
+      getDropped(void) const
+      {
+        return (unsigned)m_dropped.add(0);
+      }
+
+      //! Retrieve the largest queue depth observed when messages
+      //! of this type were queued.
+      //! @return number of messages.
+      size_t
+      getMaxDepth(void) const
+      {
+        return m_max_depth;
+      }
+
+      //! Retrieve the number of messages in a latency bucket.
+      //! @param bucket bucket index.
+      //! @return number of messages.
+      unsigned
+      getLatency(unsigned bucket) const
+      {
+        return m_latency[bucket];
+      }
+
+      //! Retrieve an upper bound of a latency percentile.
+      //! @param fraction fraction of delivered messages, between 0
+      //! and 1.
+      //! @return latency bound in microseconds or 0 if no messages
+      //! were delivered.
+      uint64_t
+      getLatencyPercentile(double fraction) const
+      {
+        uint64_t total = 0;
+        for (unsigned i = 0; i < c_latency_buckets; ++i)
+          total += m_latency[i];
+
+        if (total == 0)
+          return 0;
+
+        uint64_t count = 0;
+        for (unsigned i = 0; i < c_latency_buckets; ++i)
+        {
+          count += m_latency[i];
+          if (count >= fraction * total)
+            return getBucketBound(i);
+        }
+
+        return getBucketBound(c_latency_buckets - 1);
+      }
+
+      //! Retrieve the upper bound of a latency bucket.
+      //! @param bucket bucket index.
+      //! @return latency bound in microseconds.
+      static uint64_t
+      getBucketBound(unsigned bucket)
+      {
+        return (uint64_t)1 << bucket;
+      }
+
+      //! Retrieve the latency bucket of a given latency.
+      //! @param latency latency in nanoseconds.
+      //! @return bucket index.
+      static unsigned
+      getBucket(uint64_t latency)
+      {
+        uint64_t usec = latency / 1000;
+        unsigned bucket = 0;
+
+        while (usec > 0 && bucket < c_latency_buckets - 1)
+        {
+          usec >>= 1;
+          ++bucket;
+        }
+
+        return bucket;
+      }
+
+    private:
+      //! Recipient task.
+      Tasks::AbstractTask* m_task;
+      //! Message identification number.
+      uint16_t m_id;
+      //! Number of queued messages.
+      mutable Concurrency::AtomicCounter m_enqueued;
+      //! Number of discarded messages.
+      mutable Concurrency::AtomicCounter m_dropped;
+      //! Number of delivered messages.
+      volatile unsigned m_dequeued;
+      //! Largest queue depth after queueing a message.
+      volatile size_t m_max_depth;
+      //! Lock for the largest queue depth.
+      Concurrency::Mutex m_depth_lock;
+      //! Latency histogram.
+      volatile unsigned m_latency[c_latency_buckets];
+    };
+  }
+}
+
+#endif
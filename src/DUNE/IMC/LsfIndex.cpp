@@ -0,0 +1,305 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+// DUNE headers.
+#include <DUNE/Compression/Factory.hpp>
+#include <DUNE/IMC/LsfIndex.hpp>
+#include <DUNE/Utils/ByteCopy.hpp>
+
+namespace DUNE
+{
+  namespace IMC
+  {
+    //! Index file magic.
+    static const char c_magic[] = {'L', 'S', 'F', 'I'};
+    //! Index format version.
+    static const uint16_t c_version = 1;
+    //! Byte order mark.
+    static const uint16_t c_bom = 0x0102;
+    //! Compression methods whose extensions are stripped from log names.
+    static const Compression::Methods c_methods[] =
+    {
+      Compression::METHOD_GZIP,
+      Compression::METHOD_BZIP2,
+      Compression::METHOD_ZLIB
+    };
+
+    //! Write a value in host byte order.
+    template <typename T>
+    static void
+    put(std::ostream& os, T value)
+    {
+      os.write((const char*)&value, sizeof(T));
+    }
+
+    //! Read a value.
+    //! @param[in] is input stream.
+    //! @param[out] value value.
+    //! @param[in] swap true to swap the byte order.
+    template <typename T>
+    static void
+    get(std::istream& is, T& value, bool swap)
+    {
+      uint8_t bfr[sizeof(T)];
+      is.read((char*)bfr, sizeof(T));
+      if ((size_t)is.gcount() != sizeof(T))
+        throw std::runtime_error("LSF index is truncated");
+
+      if (swap)
+        Utils::ByteCopy::rcopy(value, bfr);
+      else
+        Utils::ByteCopy::copy(value, bfr);
+    }
+
+    //! Compare a time with the start of a slice.
+    struct SliceTime
+    {
+      template <typename S>
+      bool
+      operator()(double time, const S& slice) const
+      {
+        return time < slice.time;
+      }
+    };
+
+    LsfIndex::LsfIndex(double period):
+      m_period(period),
+      m_size(0)
+    { }
+
+    void
+    LsfIndex::clear(void)
+    {
+      m_slices.clear();
+      m_entries.clear();
+      m_size = 0;
+    }
+
+    void
+    LsfIndex::add(uint16_t id, double timestamp, uint64_t offset, size_t size)
+    {
+      if (m_slices.empty() || timestamp >= m_slices.back().time + m_period)
+      {
+        Slice slice;
+        slice.time = timestamp;
+        slice.offset = offset;
+        m_slices.push_back(slice);
+      }
+
+      uint32_t slice = (uint32_t)m_slices.size() - 1;
+      Entry& entry = m_entries[id];
+      ++entry.count;
+
+      if (entry.runs.empty() || entry.runs.back().second + 1 < slice)
+        entry.runs.push_back(std::make_pair(slice, slice));
+      else
+        entry.runs.back().second = slice;
+
+      m_size = offset + size;
+    }
+
+    void
+    LsfIndex::write(const std::string& file) const
+    {
+      std::ofstream os(file.c_str(), std::ios::binary);
+
+      os.write(c_magic, sizeof(c_magic));
+      put(os, c_bom);
+      put(os, c_version);
+      put(os, m_period);
+      put(os, m_size);
+
+      put(os, (uint32_t)m_slices.size());
+      for (size_t i = 0; i < m_slices.size(); ++i)
+      {
+        put(os, m_slices[i].time);
+        put(os, m_slices[i].offset);
+      }
+
+      put(os, (uint32_t)m_entries.size());
+      std::map<uint16_t, Entry>::const_iterator itr = m_entries.begin();
+      for (; itr != m_entries.end(); ++itr)
+      {
+        put(os, itr->first);
+        put(os, itr->second.count);
+        put(os, (uint32_t)itr->second.runs.size());
+        for (size_t i = 0; i < itr->second.runs.size(); ++i)
+        {
+          put(os, itr->second.runs[i].first);
+          put(os, itr->second.runs[i].second);
+        }
+      }
+
+      os.close();
+      if (os.fail())
+        throw std::runtime_error("failed to write LSF index: " + file);
+    }
+
+    void
+    LsfIndex::read(const std::string& file)
+    {
+      std::ifstream is(file.c_str(), std::ios::binary);
+      if (!is.is_open())
+        throw std::runtime_error("failed to open LSF index: " + file);
+
+      char magic[sizeof(c_magic)];
+      is.read(magic, sizeof(magic));
+      if (is.gcount() != sizeof(magic) || std::memcmp(magic, c_magic, sizeof(magic)) != 0)
+        throw std::runtime_error("invalid LSF index: " + file);
+
+      uint16_t bom = 0;
+      get(is, bom, false);
+      bool swap = (bom != c_bom);
+
+      uint16_t version = 0;
+      get(is, version, swap);
+      if (version != c_version)
+        throw std::runtime_error("unsupported LSF index version: " + file);
+
+      clear();
+      get(is, m_period, swap);
+      get(is, m_size, swap);
+
+      uint32_t count = 0;
+      get(is, count, swap);
+      m_slices.resize(count);
+      for (uint32_t i = 0; i < count; ++i)
+      {
+        get(is, m_slices[i].time, swap);
+        get(is, m_slices[i].offset, swap);
+      }
+
+      get(is, count, swap);
+      for (uint32_t i = 0; i < count; ++i)
+      {
+        uint16_t id = 0;
+        get(is, id, swap);
+        Entry& entry = m_entries[id];
+        get(is, entry.count, swap);
+
+        uint32_t runs = 0;
+        get(is, runs, swap);
+        entry.runs.resize(runs);
+        for (uint32_t j = 0; j < runs; ++j)
+        {
+          get(is, entry.runs[j].first, swap);
+          get(is, entry.runs[j].second, swap);
+        }
+      }
+    }
+
+    void
+    LsfIndex::getRanges(const std::set<uint16_t>& ids, double start, double end,
+                        std::vector<Range>& ranges) const
+    {
+      ranges.clear();
+      if (m_slices.empty())
+        return;
+
+      // Slices starting after 'start' do not contain earlier messages.
+      std::vector<Slice>::const_iterator first = std::upper_bound(m_slices.begin(), m_slices.end(), start, SliceTime());
+      std::vector<Slice>::const_iterator last = std::upper_bound(m_slices.begin(), m_slices.end(), end, SliceTime());
+      uint32_t s0 = (first == m_slices.begin()) ? 0 : (uint32_t)(first - m_slices.begin()) - 1;
+      uint32_t s1 = (uint32_t)(last - m_slices.begin());
+      if (s0 >= s1)
+        return;
+
+      std::vector<bool> marks(s1 - s0, ids.empty());
+      std::set<uint16_t>::const_iterator iitr = ids.begin();
+      for (; iitr != ids.end(); ++iitr)
+      {
+        std::map<uint16_t, Entry>::const_iterator eitr = m_entries.find(*iitr);
+        if (eitr == m_entries.end())
+          continue;
+
+        const Runs& runs = eitr->second.runs;
+        for (size_t i = 0; i < runs.size(); ++i)
+        {
+          uint32_t a = std::max(runs[i].first, s0);
+          uint32_t b = std::min(runs[i].second + 1, s1);
+          for (uint32_t j = a; j < b; ++j)
+            marks[j - s0] = true;
+        }
+      }
+
+      for (uint32_t i = s0; i < s1; ++i)
+      {
+        if (!marks[i - s0])
+          continue;
+
+        Range range = getRange(i);
+        if (!ranges.empty() && ranges.back().second == range.first)
+          ranges.back().second = range.second;
+        else
+          ranges.push_back(range);
+      }
+    }
+
+    unsigned
+    LsfIndex::getCount(uint16_t id) const
+    {
+      std::map<uint16_t, Entry>::const_iterator itr = m_entries.find(id);
+      if (itr == m_entries.end())
+        return 0;
+
+      return itr->second.count;
+    }
+
+    std::string
+    LsfIndex::getPath(const std::string& lsf)
+    {
+      std::string path = lsf;
+
+      for (size_t i = 0; i < sizeof(c_methods) / sizeof(c_methods[0]); ++i)
+      {
+        std::string ext = Compression::Factory::extension(c_methods[i]);
+        if (path.size() > ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0)
+        {
+          path.erase(path.size() - ext.size());
+          break;
+        }
+      }
+
+      return path + ".idx";
+    }
+
+    LsfIndex::Range
+    LsfIndex::getRange(uint32_t slice) const
+    {
+      uint64_t end = (slice + 1 < m_slices.size()) ? m_slices[slice + 1].offset : m_size;
+      return Range(m_slices[slice].offset, end);
+    }
+  }
+}
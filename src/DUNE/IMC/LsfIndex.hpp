@@ -0,0 +1,185 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+#ifndef DUNE_IMC_LSF_INDEX_HPP_INCLUDED_
+#define DUNE_IMC_LSF_INDEX_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+
+namespace DUNE
+{
+  namespace IMC
+  {
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM LsfIndex;
+
+    //! Index of an LSF log. The log is divided in slices spanning a
+    //! fixed period of log time, i.e., the highest message time stamp
+    //! seen so far. The index keeps the offset at which each slice
+    //! starts and, for each message identification number, the runs
+    //! of slices containing messages with that number. Offsets refer
+    //! to the uncompressed log.
+    class LsfIndex
+    {
+    public:
+      //! Range of bytes of a log, [first, second).
+      typedef std::pair<uint64_t, uint64_t> Range;
+
+      //! Create an empty index.
+      //! @param[in] period slice period in seconds.
+      LsfIndex(double period = 1.0);
+
+      //! Clear the index.
+      void
+      clear(void);
+
+      //! Add a packet to the index. Packets must be added in the
+      //! order they appear in the log.
+      //! @param[in] id message identification number.
+      //! @param[in] timestamp message time stamp.
+      //! @param[in] offset offset of the packet.
+      //! @param[in] size size of the packet.
+      void
+      add(uint16_t id, double timestamp, uint64_t offset, size_t size);
+
+      //! Write the index to a file.
+      //! @param[in] file index file.
+      //! @throw std::runtime_error if the file cannot be written.
+      void
+      write(const std::string& file) const;
+
+      //! Read the index from a file.
+      //! @param[in] file index file.
+      //! @throw std::runtime_error if the file cannot be read or is
+      //! not a valid index.
+      void
+      read(const std::string& file);
+
+      //! Retrieve the ranges of the log containing messages with a
+      //! set of identification numbers logged between two instants.
+      //! Adjacent ranges are merged.
+      //! @param[in] ids identification numbers, empty for any message.
+      //! @param[in] start start time.
+      //! @param[in] end end time.
+      //! @param[out] ranges ranges of the log.
+      void
+      getRanges(const std::set<uint16_t>& ids, double start, double end,
+                std::vector<Range>& ranges) const;
+
+      //! Retrieve the number of messages with a given identification
+      //! number.
+      //! @param[in] id identification number.
+      //! @return number of messages.
+      unsigned
+      getCount(uint16_t id) const;
+
+      //! Retrieve the slice period.
+      //! @return period in seconds.
+      double
+      getPeriod(void) const
+      {
+        return m_period;
+      }
+
+      //! Retrieve the time of the first slice.
+      //! @return time or -1 if the index is empty.
+      double
+      getStartTime(void) const
+      {
+        return m_slices.empty() ? -1.0 : m_slices.front().time;
+      }
+
+      //! Retrieve the size of the indexed log.
+      //! @return log size in bytes.
+      uint64_t
+      getLogSize(void) const
+      {
+        return m_size;
+      }
+
+      //! Retrieve the path of the index of a log. The index of
+      //! 'Data.lsf' and 'Data.lsf.gz' is 'Data.lsf.idx'.
+      //! @param[in] lsf log file.
+      //! @return index file.
+      static std::string
+      getPath(const std::string& lsf);
+
+    private:
+      //! Start of a slice.
+      struct Slice
+      {
+        //! Log time.
+        double time;
+        //! Offset.
+        uint64_t offset;
+      };
+
+      //! Runs of slices, [first, second].
+      typedef std::vector<std::pair<uint32_t, uint32_t> > Runs;
+
+      //! Slices of a message.
+      struct Entry
+      {
+        Entry(void):
+          count(0)
+        { }
+
+        //! Number of messages.
+        uint32_t count;
+        //! Runs of slices containing messages.
+        Runs runs;
+      };
+
+      //! Slice period.
+      double m_period;
+      //! Slices.
+      std::vector<Slice> m_slices;
+      //! Slices of each message.
+      std::map<uint16_t, Entry> m_entries;
+      //! Log size.
+      uint64_t m_size;
+
+      //! Retrieve the range of a slice.
+      //! @param[in] slice slice index.
+      //! @return range.
+      Range
+      getRange(uint32_t slice) const;
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,238 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cerrno>
+#include <fstream>
+#include <limits>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/IMC/Constants.hpp>
+#include <DUNE/IMC/LsfReader.hpp>
+#include <DUNE/System/Error.hpp>
+
+#if defined(DUNE_SYS_HAS_UNISTD_H)
+#  include <unistd.h>
+#endif
+
+#if defined(DUNE_SYS_HAS_SYS_MMAN_H)
+#  include <sys/mman.h>
+#endif
+
+#if defined(DUNE_SYS_HAS_SYS_STAT_H)
+#  include <sys/stat.h>
+#endif
+
+#if defined(DUNE_SYS_HAS_FCNTL_H)
+#  include <fcntl.h>
+#endif
+
+#if defined(DUNE_SYS_HAS_MMAP) && defined(DUNE_SYS_HAS_SYS_MMAN_H) && defined(DUNE_SYS_HAS_FCNTL_H)
+#  define DUNE_SYS_HAS_POSIX_MMAP
+#endif
+
+namespace DUNE
+{
+  namespace IMC
+  {
+    //! Size of a packet with an empty payload.
+    static const uint64_t c_frame_overhead = DUNE_IMC_CONST_HEADER_SIZE + DUNE_IMC_CONST_FOOTER_SIZE;
+
+    //! Test if two bytes are a synchronization number, in either byte
+    //! order.
+    static inline bool
+    isSync(const uint8_t* bfr)
+    {
+      uint16_t sync = (bfr[0] << 8) | bfr[1];
+      return sync == DUNE_IMC_CONST_SYNC || sync == DUNE_IMC_CONST_SYNC_REV;
+    }
+
+    LsfReader::LsfReader(const std::string& file):
+      m_data(NULL),
+      m_size(0)
+    {
+#if defined(DUNE_SYS_HAS_POSIX_MMAP)
+      int fd = ::open(file.c_str(), O_RDONLY);
+      if (fd == -1)
+        throw System::Error(errno, "failed to open " + file);
+
+      struct stat st;
+      if (fstat(fd, &st) == -1)
+      {
+        int error = errno;
+        ::close(fd);
+        throw System::Error(error, "failed to query " + file);
+      }
+
+      m_size = st.st_size;
+
+      // A 32-bit process cannot map the whole log.
+      if (m_size > std::numeric_limits<size_t>::max())
+      {
+        ::close(fd);
+        throw System::Error(EOVERFLOW, "failed to map " + file);
+      }
+
+      if (m_size > 0)
+      {
+        void* ptr = mmap(0, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED)
+        {
+          int error = errno;
+          ::close(fd);
+          throw System::Error(error, "failed to map " + file);
+        }
+
+#  if defined(MADV_SEQUENTIAL)
+        madvise(ptr, m_size, MADV_SEQUENTIAL);
+#  endif
+
+        m_data = (const uint8_t*)ptr;
+      }
+
+      ::close(fd);
+#else
+      std::ifstream ifs(file.c_str(), std::ios::binary);
+      if (!ifs.is_open())
+        throw System::Error(errno, "failed to open " + file);
+
+      ifs.seekg(0, std::ios::end);
+      m_copy.resize((size_t)ifs.tellg());
+      ifs.seekg(0, std::ios::beg);
+      if (!m_copy.empty())
+        ifs.read((char*)&m_copy[0], m_copy.size());
+
+      m_size = m_copy.size();
+      m_data = m_copy.empty() ? NULL : &m_copy[0];
+#endif
+    }
+
+    LsfReader::~LsfReader(void)
+    {
+#if defined(DUNE_SYS_HAS_POSIX_MMAP)
+      if (m_data != NULL)
+        munmap((void*)m_data, m_size);
+#endif
+    }
+
+    bool
+    LsfReader::next(uint64_t& offset, uint64_t end, PacketView& pkt) const
+    {
+      if (end > m_size)
+        end = m_size;
+
+      for (uint64_t pos = offset; pos < end; ++pos)
+      {
+        if (m_size - pos < c_frame_overhead)
+          break;
+
+        if (!isSync(m_data + pos))
+          continue;
+
+        try
+        {
+          pkt.set(m_data + pos, m_size - pos);
+        }
+        catch (...)
+        {
+          continue;
+        }
+
+        // Try to find sync again from the next position.
+        if (!pkt.isValid())
+          continue;
+
+        offset = pos + pkt.getSize();
+        return true;
+      }
+
+      offset = end;
+      return false;
+    }
+
+    void
+    LsfReader::split(unsigned count, std::vector<Range>& chunks) const
+    {
+      chunks.clear();
+      if (count == 0)
+        count = 1;
+
+      uint64_t start = 0;
+      uint64_t offset = 0;
+      PacketView pkt;
+
+      for (unsigned i = 1; i <= count && start < m_size; ++i)
+      {
+        uint64_t limit = m_size;
+
+        if (i < count)
+        {
+          // Move the nominal boundary to the start of a packet. A
+          // synchronization number found by scanning could belong to
+          // a packet embedded in the payload of another one, so walk
+          // from the previous boundary using packet sizes. A size is
+          // trusted if another packet follows, otherwise the packet
+          // is validated and corrupted bytes are skipped like next()
+          // does when reading the log.
+          uint64_t nominal = (m_size / count) * i;
+          while (offset < nominal)
+          {
+            if (m_size - offset >= c_frame_overhead && isSync(m_data + offset))
+            {
+              try
+              {
+                pkt.set(m_data + offset, m_size - offset);
+                uint64_t end = offset + pkt.getSize();
+                if (end == m_size || (m_size - end >= 2 && isSync(m_data + end)))
+                {
+                  offset = end;
+                  continue;
+                }
+              }
+              catch (...)
+              { }
+            }
+
+            if (!next(offset, pkt))
+              break;
+          }
+
+          limit = offset;
+        }
+
+        if (limit > start || i == count)
+        {
+          chunks.push_back(Range(start, limit));
+          start = limit;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,133 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+#ifndef DUNE_IMC_LSF_READER_HPP_INCLUDED_
+#define DUNE_IMC_LSF_READER_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <string>
+#include <utility>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/IMC/PacketView.hpp>
+
+namespace DUNE
+{
+  namespace IMC
+  {
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM LsfReader;
+
+    //! Reader of uncompressed LSF logs. The log is mapped in memory
+    //! and packets are returned as views of the mapped data, so
+    //! reading does not copy or allocate. Corrupted bytes are
+    //! skipped, like IMC::Parser does with streams. Since reading
+    //! does not change the reader, a log can be split in chunks that
+    //! are scanned concurrently by different threads.
+    class LsfReader
+    {
+    public:
+      //! Range of bytes of a log, [first, second).
+      typedef std::pair<uint64_t, uint64_t> Range;
+
+      //! Open a log.
+      //! @param[in] file log file.
+      //! @throw System::Error if the log cannot be opened or mapped.
+      explicit
+      LsfReader(const std::string& file);
+
+      //! Destructor.
+      ~LsfReader(void);
+
+      //! Find the next valid packet.
+      //! @param[in,out] offset offset to start looking for a packet,
+      //! updated to the end of the packet found.
+      //! @param[in] end packets must start before this offset.
+      //! @param[out] pkt packet found.
+      //! @return true if a packet was found, false otherwise.
+      bool
+      next(uint64_t& offset, uint64_t end, PacketView& pkt) const;
+
+      //! Find the next valid packet.
+      //! @param[in,out] offset offset to start looking for a packet,
+      //! updated to the end of the packet found.
+      //! @param[out] pkt packet found.
+      //! @return true if a packet was found, false otherwise.
+      bool
+      next(uint64_t& offset, PacketView& pkt) const
+      {
+        return next(offset, m_size, pkt);
+      }
+
+      //! Split the log in chunks that start at packet boundaries.
+      //! Chunks are contiguous and cover the whole log, every packet
+      //! starts in exactly one chunk. Boundaries are found by walking
+      //! the packets of the log, which reads their headers only.
+      //! @param[in] count desired number of chunks.
+      //! @param[out] chunks chunks, possibly fewer than requested.
+      void
+      split(unsigned count, std::vector<Range>& chunks) const;
+
+      //! Retrieve the log data.
+      //! @return log data.
+      const uint8_t*
+      getData(void) const
+      {
+        return m_data;
+      }
+
+      //! Retrieve the log size.
+      //! @return log size in bytes.
+      uint64_t
+      getSize(void) const
+      {
+        return m_size;
+      }
+
+    private:
+      //! Log data.
+      const uint8_t* m_data;
+      //! Log size.
+      uint64_t m_size;
+      //! Copy of the log when memory mapping is not available.
+      std::vector<uint8_t> m_copy;
+
+      //! Non-copyable.
+      LsfReader(const LsfReader&);
+
+      //! Non-assignable.
+      LsfReader&
+      operator=(const LsfReader&);
+    };
+  }
+}
+
+#endif
@@ -37,6 +37,7 @@
 #include <DUNE/IMC/Header.hpp>
 #include <DUNE/IMC/Packet.hpp>
 #include <DUNE/IMC/AddressResolver.hpp>
+#include <DUNE/IMC/RawFrame.hpp>
 
 namespace DUNE
 {
@@ -60,6 +61,29 @@ namespace DUNE
         m_header.timestamp = -1.0;
       }
 
+      //! Copy constructor. The raw frame of the other message is not
+      //! copied, since copies are usually made to be modified.
+      //! @param[in] other message.
+      Message(const Message& other):
+        m_header(other.m_header)
+      { }
+
+      //! Assignment operator. The raw frame of the other message is
+      //! not copied.
+      //! @param[in] other message.
+      //! @return this message.
+      Message&
+      operator=(const Message& other)
+      {
+        if (this != &other)
+        {
+          m_header = other.m_header;
+          m_frame.clear();
+        }
+
+        return *this;
+      }
+
       //! Default destructor.
       virtual
       ~Message(void)
@@ -97,6 +121,9 @@ namespace DUNE
       double
       setTimeStamp(double ts)
       {
+        if (m_header.timestamp != ts)
+          m_frame.clear();
+
         m_header.timestamp = ts;
         setTimeStampNested(ts);
         return m_header.timestamp;
@@ -131,6 +158,9 @@ namespace DUNE
       void
       setSource(uint16_t src)
       {
+        if (m_header.src != src)
+          m_frame.clear();
+
         m_header.src = src;
         setSourceNested(src);
       }
@@ -148,6 +178,9 @@ namespace DUNE
       void
       setSourceEntity(uint8_t src_ent)
       {
+        if (m_header.src_ent != src_ent)
+          m_frame.clear();
+
         m_header.src_ent = src_ent;
         setSourceEntityNested(src_ent);
       }
@@ -165,6 +198,9 @@ namespace DUNE
       void
       setDestination(uint16_t dst)
       {
+        if (m_header.dst != dst)
+          m_frame.clear();
+
         m_header.dst = dst;
         setDestinationNested(dst);
       }
@@ -182,10 +218,50 @@ namespace DUNE
       void
       setDestinationEntity(uint8_t dst_ent)
       {
+        if (m_header.dst_ent != dst_ent)
+          m_frame.clear();
+
         m_header.dst_ent = dst_ent;
         setDestinationEntityNested(dst_ent);
       }
 
+      //! Attach the bytes this message was received with. Forwarding
+      //! consumers may then copy these bytes instead of serializing
+      //! the message again. Changing the header of the message
+      //! discards the frame, code that changes the fields of a
+      //! message with a frame must call clearRawFrame().
+      //! @param[in] frame raw frame.
+      void
+      setRawFrame(const RawFrame& frame)
+      {
+        m_frame = frame;
+      }
+
+      //! Attach a copy of the bytes this message was received with.
+      //! @param[in] bfr packet data.
+      //! @param[in] size packet size.
+      void
+      setRawFrame(const uint8_t* bfr, size_t size)
+      {
+        m_frame = RawFrame(bfr, size);
+      }
+
+      //! Retrieve the bytes this message was received with.
+      //! @return raw frame, empty if the message was created locally
+      //! or modified after being received.
+      const RawFrame&
+      getRawFrame(void) const
+      {
+        return m_frame;
+      }
+
+      //! Discard the bytes this message was received with.
+      void
+      clearRawFrame(void)
+      {
+        m_frame.clear();
+      }
+
       //! Retrieve message's sub identification number (id field).
       //! @return message's sub identification number.
       virtual uint16_t
@@ -316,6 +392,8 @@ namespace DUNE
     protected:
       //! Message header.
       Header m_header;
+      //! Bytes this message was received with.
+      RawFrame m_frame;
 
       //! Set the timestamp of nested messages.
       //! @param[in] value timestamp.
@@ -220,7 +220,7 @@ namespace DUNE
     }
 
     Message*
-    Packet::deserializePayload(const Header& hdr, const uint8_t* bfr, uint16_t bfr_len, Message* msg)
+    Packet::deserializePayload(const Header& hdr, const uint8_t* bfr, size_t bfr_len, Message* msg)
     {
       (void)bfr_len;
 
@@ -270,6 +270,7 @@ namespace DUNE
       msg->setSourceEntity(hdr.src_ent);
       msg->setDestination(hdr.dst);
       msg->setDestinationEntity(hdr.dst_ent);
+      msg->clearRawFrame();
 
       return msg;
     }
@@ -92,7 +92,7 @@ namespace DUNE
       deserializeHeader(Header& hdr, const uint8_t* bfr, uint16_t bfr_len);
 
       static Message*
-      deserializePayload(const Header& hdr, const uint8_t* bfr, uint16_t bfr_len, Message* msg);
+      deserializePayload(const Header& hdr, const uint8_t* bfr, size_t bfr_len, Message* msg);
     };
   }
 }
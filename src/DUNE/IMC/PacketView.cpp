@@ -0,0 +1,126 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cstddef>
+
+// DUNE headers.
+#include <DUNE/Algorithms/CRC16.hpp>
+#include <DUNE/Utils/ByteCopy.hpp>
+#include <DUNE/IMC/Exceptions.hpp>
+#include <DUNE/IMC/Packet.hpp>
+#include <DUNE/IMC/PacketView.hpp>
+
+namespace DUNE
+{
+  namespace IMC
+  {
+    //! Size of a packet with an empty payload.
+    static const size_t c_overhead = DUNE_IMC_CONST_HEADER_SIZE + DUNE_IMC_CONST_FOOTER_SIZE;
+
+    PacketView::PacketView(void):
+      m_data(NULL),
+      m_size(0)
+    { }
+
+    PacketView::PacketView(const uint8_t* bfr, size_t size):
+      m_data(NULL),
+      m_size(0)
+    {
+      set(bfr, size);
+    }
+
+    void
+    PacketView::set(const uint8_t* bfr, size_t size)
+    {
+      if (size < DUNE_IMC_CONST_HEADER_SIZE)
+        throw BufferTooShort();
+
+      Packet::deserializeHeader(m_header, bfr, DUNE_IMC_CONST_HEADER_SIZE);
+
+      if (m_header.size + c_overhead > size)
+        throw BufferTooShort();
+
+      m_data = bfr;
+      m_size = m_header.size + c_overhead;
+    }
+
+    bool
+    PacketView::read(std::istream& ifs)
+    {
+      if (m_buffer.size() < DUNE_IMC_CONST_HEADER_SIZE)
+        m_buffer.resize(DUNE_IMC_CONST_HEADER_SIZE);
+
+      ifs.read((char*)&m_buffer[0], DUNE_IMC_CONST_HEADER_SIZE);
+
+      // If we're at the EOF there's nothing more to do.
+      if (ifs.eof())
+        return false;
+
+      if (ifs.gcount() < DUNE_IMC_CONST_HEADER_SIZE)
+        throw BufferTooShort();
+
+      Packet::deserializeHeader(m_header, &m_buffer[0], DUNE_IMC_CONST_HEADER_SIZE);
+
+      // Get remaining data.
+      size_t remaining = m_header.size + DUNE_IMC_CONST_FOOTER_SIZE;
+      if (m_buffer.size() < DUNE_IMC_CONST_HEADER_SIZE + remaining)
+        m_buffer.resize(DUNE_IMC_CONST_HEADER_SIZE + remaining);
+
+      ifs.read((char*)&m_buffer[DUNE_IMC_CONST_HEADER_SIZE], remaining);
+
+      if ((size_t)ifs.gcount() < remaining)
+        throw BufferTooShort();
+
+      m_data = &m_buffer[0];
+      m_size = DUNE_IMC_CONST_HEADER_SIZE + remaining;
+      return true;
+    }
+
+    bool
+    PacketView::isValid(void) const
+    {
+      uint16_t rcrc = 0;
+      const uint8_t* footer = m_data + DUNE_IMC_CONST_HEADER_SIZE + m_header.size;
+
+      if (m_header.sync == DUNE_IMC_CONST_SYNC_REV)
+        Utils::ByteCopy::rcopy(rcrc, footer);
+      else
+        Utils::ByteCopy::copy(rcrc, footer);
+
+      return Algorithms::CRC16::compute(m_data, DUNE_IMC_CONST_HEADER_SIZE + m_header.size) == rcrc;
+    }
+
+    Message*
+    PacketView::materialize(Message* msg) const
+    {
+      return Packet::deserializePayload(m_header, m_data, m_size, msg);
+    }
+  }
+}
@@ -0,0 +1,211 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+#ifndef DUNE_IMC_PACKET_VIEW_HPP_INCLUDED_
+#define DUNE_IMC_PACKET_VIEW_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cstddef>
+#include <istream>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/IMC/Constants.hpp>
+#include <DUNE/IMC/Header.hpp>
+
+namespace DUNE
+{
+  namespace IMC
+  {
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM PacketView;
+
+    // Forward declarations.
+    class Message;
+
+    //! View of a serialized IMC packet. Only the header is parsed,
+    //! which is enough to decide whether a message is of interest
+    //! without allocating it. The message object is created on
+    //! demand with materialize().
+    class PacketView
+    {
+    public:
+      //! Create an empty view.
+      PacketView(void);
+
+      //! Create a view of a packet stored in a buffer. The buffer is
+      //! not copied and must outlive the view.
+      //! @param[in] bfr packet buffer.
+      //! @param[in] size packet buffer size.
+      PacketView(const uint8_t* bfr, size_t size);
+
+      //! Point the view to a packet stored in a buffer. The buffer
+      //! is not copied and must outlive the view.
+      //! @param[in] bfr packet buffer.
+      //! @param[in] size packet buffer size.
+      //! @throw BufferTooShort if the buffer does not hold the whole
+      //! packet.
+      //! @throw InvalidSync if the buffer does not start with a
+      //! synchronization number.
+      void
+      set(const uint8_t* bfr, size_t size);
+
+      //! Read the next packet from a stream. The packet is kept in a
+      //! buffer owned by the view, which is reused by further reads.
+      //! @param[in] ifs input stream.
+      //! @return true if a packet was read, false if the stream is at
+      //! end of file.
+      //! @throw BufferTooShort if the stream ends in the middle of a
+      //! packet.
+      bool
+      read(std::istream& ifs);
+
+      //! Create the message object of the packet. The checksum is
+      //! validated at this point.
+      //! @param[in] msg message object to fill, if NULL a new one is
+      //! allocated.
+      //! @return message object.
+      Message*
+      materialize(Message* msg = NULL) const;
+
+      //! Validate the checksum of the packet.
+      //! @return true if the checksum is valid, false otherwise.
+      bool
+      isValid(void) const;
+
+      //! Retrieve the packet header.
+      //! @return packet header.
+      const Header&
+      getHeader(void) const
+      {
+        return m_header;
+      }
+
+      //! Retrieve the message identification number.
+      //! @return message identification number.
+      uint16_t
+      getId(void) const
+      {
+        return m_header.mgid;
+      }
+
+      //! Retrieve the message time stamp.
+      //! @return time stamp.
+      double
+      getTimeStamp(void) const
+      {
+        return m_header.timestamp;
+      }
+
+      //! Retrieve the source address.
+      //! @return source address.
+      uint16_t
+      getSource(void) const
+      {
+        return m_header.src;
+      }
+
+      //! Retrieve the source entity.
+      //! @return source entity.
+      uint8_t
+      getSourceEntity(void) const
+      {
+        return m_header.src_ent;
+      }
+
+      //! Retrieve the destination address.
+      //! @return destination address.
+      uint16_t
+      getDestination(void) const
+      {
+        return m_header.dst;
+      }
+
+      //! Retrieve the destination entity.
+      //! @return destination entity.
+      uint8_t
+      getDestinationEntity(void) const
+      {
+        return m_header.dst_ent;
+      }
+
+      //! Retrieve the serialized packet, including header and footer.
+      //! @return packet data.
+      const uint8_t*
+      getData(void) const
+      {
+        return m_data;
+      }
+
+      //! Retrieve the size of the serialized packet.
+      //! @return packet size.
+      size_t
+      getSize(void) const
+      {
+        return m_size;
+      }
+
+      //! Retrieve the serialized message fields.
+      //! @return payload data.
+      const uint8_t*
+      getPayload(void) const
+      {
+        return m_data + DUNE_IMC_CONST_HEADER_SIZE;
+      }
+
+      //! Retrieve the size of the serialized message fields.
+      //! @return payload size.
+      size_t
+      getPayloadSize(void) const
+      {
+        return m_header.size;
+      }
+
+    private:
+      //! Packet header.
+      Header m_header;
+      //! Packet data.
+      const uint8_t* m_data;
+      //! Packet size.
+      size_t m_size;
+      //! Storage of packets read from streams.
+      std::vector<uint8_t> m_buffer;
+
+      //! Non-copyable.
+      PacketView(const PacketView&);
+
+      //! Non-assignable.
+      PacketView&
+      operator=(const PacketView&);
+    };
+  }
+}
+
+#endif
@@ -27,6 +27,9 @@
 // Author: Eduardo Marques                                                  *
 //***************************************************************************
 
+// ISO C++ 98 headers.
+#include <algorithm>
+
 // DUNE headers.
 #include <DUNE/IMC/Parser.hpp>
 #include <DUNE/IMC/Packet.hpp>
@@ -35,102 +38,187 @@ namespace DUNE
 {
   namespace IMC
   {
-    Parser::Parser(void)
+    //! Size of a packet with an empty payload.
+    static const size_t c_frame_overhead = DUNE_IMC_CONST_HEADER_SIZE + DUNE_IMC_CONST_FOOTER_SIZE;
+
+    //! Test if a byte may be the first byte of a synchronization
+    //! number, in either byte order.
+    static inline bool
+    isSyncStart(uint8_t byte)
+    {
+      return byte == (DUNE_IMC_CONST_SYNC >> 8) || byte == (DUNE_IMC_CONST_SYNC & 0xff);
+    }
+
+    //! Test if two bytes are a synchronization number, in either byte
+    //! order.
+    static inline bool
+    isSync(const uint8_t* bfr)
+    {
+      uint16_t sync = (bfr[0] << 8) | bfr[1];
+      return sync == DUNE_IMC_CONST_SYNC || sync == DUNE_IMC_CONST_SYNC_REV;
+    }
+
+    Parser::Parser(void):
+      m_raw_frames(false)
     {
       reset();
     }
 
     Parser::~Parser(void)
-    { }
+    {
+      reset();
+    }
 
     void
     Parser::reset(void)
     {
-      m_stage = c_sync;
-      m_pos = 0;
       m_buf.clear();
+
+      for (size_t i = 0; i < m_pending.size(); ++i)
+        delete m_pending[i];
+      m_pending.clear();
     }
 
     Message*
     Parser::parse(uint8_t byte)
     {
-      Message* m = 0;
-      m_buf.push_back(byte);
+      // Discarding an invalid packet may reveal more than one valid
+      // packet, return them one at a time.
+      parse(&byte, 1, m_pending);
+
+      if (m_pending.empty())
+        return 0;
 
-      while (true)
+      Message* m = m_pending.front();
+      m_pending.erase(m_pending.begin());
+      return m;
+    }
+
+    void
+    Parser::parse(const uint8_t* data, size_t size, std::vector<Message*>& msgs)
+    {
+      size_t used = 0;
+
+      if (!m_buf.empty())
       {
-        int n = m_buf.size() - m_pos;
+        used = fill(data, size);
 
-        if (!n)
+        size_t rv = scan(&m_buf[0], m_buf.size(), msgs);
+        if (rv == m_buf.size())
         {
-          reset(); // discard unneeded data
-          break;
+          m_buf.clear();
         }
-
-        if (m_stage == c_sync)
+        else
         {
-          // This would not be stricly necessary but is more efficient
-          // than  handling recurrent exceptions from Packet::deserializeHeader
-          if (n == 1)
-          {
-            break; // need more data
-          }
-
-          uint16_t sync = (m_buf[m_pos] << 8) | m_buf[m_pos + 1];
-
-          if (sync != DUNE_IMC_CONST_SYNC && sync != DUNE_IMC_CONST_SYNC_REV)
-          {
-            m_pos++; // invalid sync, advance
-            continue;
-          }
-          m_stage = c_header; // sync is ok, get rest of header
+          // The incomplete packet was not valid and a new one starts
+          // somewhere after it, continue from there.
+          m_buf.erase(m_buf.begin(), m_buf.begin() + rv);
+          if (used == size)
+            return;
+
+          m_buf.insert(m_buf.end(), data + used, data + size);
+          rv = scan(&m_buf[0], m_buf.size(), msgs);
+          m_buf.erase(m_buf.begin(), m_buf.begin() + rv);
+          return;
         }
+      }
 
-        if (m_stage == c_header)
-        {
-          if (n < DUNE_IMC_CONST_HEADER_SIZE)
-            break;  // need more data
-
-          try
-          {
-            Packet::deserializeHeader(m_header, &m_buf[m_pos], n);
-          }
-          catch (...)
-          {
-            m_stage = c_sync;
-            ++m_pos; // try to find sync again from current position
-            continue;
-          }
-          m_stage = c_payload; // done with header
-        }
+      size_t rv = scan(data + used, size - used, msgs);
+      m_buf.assign(data + used + rv, data + size);
+    }
 
-        // on to c_payload stage
+    size_t
+    Parser::fill(const uint8_t* data, size_t size)
+    {
+      size_t used = 0;
 
-        if (n < (int)(m_header.size + DUNE_IMC_CONST_HEADER_SIZE + DUNE_IMC_CONST_FOOTER_SIZE))
-          break;  // need more data
+      if (m_buf.size() < DUNE_IMC_CONST_HEADER_SIZE)
+      {
+        used = std::min(size, DUNE_IMC_CONST_HEADER_SIZE - m_buf.size());
+        m_buf.insert(m_buf.end(), data, data + used);
+        if (m_buf.size() < DUNE_IMC_CONST_HEADER_SIZE)
+          return used;
+      }
 
-        // all payload data available
-        m_stage = c_sync; // the next stage in any case
+      Header hdr;
+      try
+      {
+        Packet::deserializeHeader(hdr, &m_buf[0], DUNE_IMC_CONST_HEADER_SIZE);
+      }
+      catch (...)
+      {
+        // Not a packet, the header is enough to find out.
+        return used;
+      }
+
+      size_t frame = hdr.size + c_frame_overhead;
+      if (m_buf.size() < frame)
+      {
+        size_t n = std::min(size - used, frame - m_buf.size());
+        m_buf.insert(m_buf.end(), data + used, data + used + n);
+        used += n;
+      }
+
+      return used;
+    }
+
+    size_t
+    Parser::scan(const uint8_t* data, size_t size, std::vector<Message*>& msgs)
+    {
+      size_t pos = 0;
+
+      while (pos < size)
+      {
+        // Find synchronization number.
+        while (pos + 1 < size && !isSync(data + pos))
+          ++pos;
 
+        if (pos + 1 >= size)
+        {
+          // The last byte may be the start of the next packet.
+          if (pos < size && isSyncStart(data[pos]))
+            return pos;
+
+          return size;
+        }
+
+        size_t n = size - pos;
+        if (n < DUNE_IMC_CONST_HEADER_SIZE)
+          return pos;
+
+        Header hdr;
         try
         {
-          m = Packet::deserializePayload(m_header, &m_buf[m_pos], n, 0);
+          Packet::deserializeHeader(hdr, data + pos, DUNE_IMC_CONST_HEADER_SIZE);
         }
         catch (...)
         {
-          ++m_pos; // try to find sync again from current position
+          ++pos;
           continue;
         }
 
-        m_pos += n;
+        size_t frame = hdr.size + c_frame_overhead;
+        if (n < frame)
+          return pos;
 
-        if (m_pos == m_buf.size())
-          reset();  // discard unneeded data
+        try
+        {
+          Message* msg = Packet::deserializePayload(hdr, data + pos, frame, 0);
+          if (m_raw_frames)
+            msg->setRawFrame(data + pos, frame);
+          msgs.push_back(msg);
+        }
+        catch (...)
+        {
+          // Try to find sync again from the next position.
+          ++pos;
+          continue;
+        }
 
-        break;
+        pos += frame;
       }
 
-      return m;
+      return pos;
     }
   }
 }
@@ -31,6 +31,7 @@
 #define DUNE_IMC_PARSER_HPP_INCLUDED_
 
 // ISO C++ 98 headers.
+#include <cstddef>
 #include <vector>
 
 // DUNE headers.
@@ -57,25 +58,79 @@ namespace DUNE
       void
       reset(void);
 
+      //! Attach the received bytes of each packet to the message
+      //! parsed from it (see Message::setRawFrame()). This costs one
+      //! copy per message and should only be enabled by transports
+      //! that forward or log the original frames.
+      //! @param enable true to attach raw frames, false otherwise.
+      void
+      setRawFrames(bool enable)
+      {
+        m_raw_frames = enable;
+      }
+
       //! Parse byte and return message if parsing of one message is done.
       //! @param byte data byte
       //! @return defined message or 0
       Message*
       parse(uint8_t byte);
 
-    private:
-      //! Parser stage constants.
-      enum ParserStage
+      //! Parse a block of data. Complete packets are deserialized
+      //! directly from the given buffer, only the bytes of a trailing
+      //! incomplete packet are kept until more data arrives.
+      //! @param data data buffer.
+      //! @param size number of bytes in the data buffer.
+      //! @param msgs parsed messages are appended to this vector,
+      //! the caller is responsible for deleting them.
+      void
+      parse(const uint8_t* data, size_t size, std::vector<Message*>& msgs);
+
+      //! Parse a block of data and call a member function of an
+      //! object for each parsed message, which becomes owned by the
+      //! callee.
+      //! @param data data buffer.
+      //! @param size number of bytes in the data buffer.
+      //! @param obj object.
+      //! @param callback member function.
+      template <typename T>
+      void
+      parse(const uint8_t* data, size_t size, T* obj, void (T::* callback)(Message*))
       {
-        c_sync,
-        c_header,
-        c_payload
-      };
-
-      ParserStage m_stage; //!< Parser stage.
-      std::vector<uint8_t> m_buf; //!< Internal buffer.
-      unsigned int m_pos; //!< Buffer position.
-      Header m_header; //!< Holds parsed header (c_payload stage).
+        m_msgs.clear();
+        parse(data, size, m_msgs);
+
+        for (size_t i = 0; i < m_msgs.size(); ++i)
+          (obj->*callback)(m_msgs[i]);
+
+        m_msgs.clear();
+      }
+
+    private:
+      //! Bytes of an incomplete packet.
+      std::vector<uint8_t> m_buf;
+      //! Messages parsed from the current block.
+      std::vector<Message*> m_msgs;
+      //! Messages parsed but not yet returned by parse(uint8_t).
+      std::vector<Message*> m_pending;
+      //! True to attach raw frames to parsed messages.
+      bool m_raw_frames;
+
+      //! Parse packets from a buffer.
+      //! @param data data buffer.
+      //! @param size number of bytes in the data buffer.
+      //! @param msgs parsed messages are appended to this vector.
+      //! @return number of bytes consumed. Remaining bytes are the
+      //! start of an incomplete packet.
+      size_t
+      scan(const uint8_t* data, size_t size, std::vector<Message*>& msgs);
+
+      //! Move bytes from a buffer into the buffer of the incomplete
+      //! packet, as many as needed to complete it.
+      //! @param data data buffer.
+      //! @param size number of bytes in the data buffer.
+      //! @return number of bytes moved.
+      size_t
+      fill(const uint8_t* data, size_t size);
     };
   }
 }
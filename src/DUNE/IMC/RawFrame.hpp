@@ -0,0 +1,178 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+#ifndef DUNE_IMC_RAW_FRAME_HPP_INCLUDED_
+#define DUNE_IMC_RAW_FRAME_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cstddef>
+#include <cstring>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/Concurrency/AtomicCounter.hpp>
+
+namespace DUNE
+{
+  namespace IMC
+  {
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM RawFrame;
+
+    //! Immutable, reference counted copy of the bytes of a packet as
+    //! received from the wire. Copies of a RawFrame refer to the same
+    //! bytes, so attaching a frame to copies of a message does not
+    //! copy the packet again.
+    class RawFrame
+    {
+    public:
+      //! Create an empty frame.
+      RawFrame(void):
+        m_block(NULL)
+      { }
+
+      //! Create a frame holding a copy of a packet.
+      //! @param[in] data packet data.
+      //! @param[in] size packet size.
+      RawFrame(const uint8_t* data, size_t size):
+        m_block(new Block(data, size))
+      { }
+
+      //! Copy constructor. Shares the bytes of another frame.
+      //! @param[in] other frame.
+      RawFrame(const RawFrame& other):
+        m_block(other.m_block)
+      {
+        acquire();
+      }
+
+      //! Destructor.
+      ~RawFrame(void)
+      {
+        release();
+      }
+
+      //! Assignment operator.
+      //! @param[in] other frame.
+      //! @return this frame.
+      RawFrame&
+      operator=(const RawFrame& other)
+      {
+        if (m_block != other.m_block)
+        {
+          release();
+          m_block = other.m_block;
+          acquire();
+        }
+
+        return *this;
+      }
+
+      //! Forget the bytes of this frame.
+      void
+      clear(void)
+      {
+        release();
+      }
+
+      //! Test if the frame is empty.
+      //! @return true if the frame holds no bytes.
+      bool
+      isNull(void) const
+      {
+        return m_block == NULL;
+      }
+
+      //! Retrieve the packet data.
+      //! @return packet data or NULL if the frame is empty.
+      const uint8_t*
+      getData(void) const
+      {
+        return (m_block == NULL) ? NULL : m_block->data;
+      }
+
+      //! Retrieve the packet size.
+      //! @return packet size.
+      size_t
+      getSize(void) const
+      {
+        return (m_block == NULL) ? 0 : m_block->size;
+      }
+
+    private:
+      //! Shared state.
+      struct Block
+      {
+        Block(const uint8_t* bfr, size_t len):
+          data(new uint8_t[len]),
+          size(len),
+          references(1)
+        {
+          std::memcpy(data, bfr, len);
+        }
+
+        ~Block(void)
+        {
+          delete [] data;
+        }
+
+        //! Packet data.
+        uint8_t* data;
+        //! Packet size.
+        size_t size;
+        //! Number of frames referring to this block.
+        Concurrency::AtomicCounter references;
+      };
+
+      //! Shared state.
+      Block* m_block;
+
+      void
+      acquire(void)
+      {
+        if (m_block != NULL)
+          m_block->references.add(1);
+      }
+
+      void
+      release(void)
+      {
+        if (m_block == NULL)
+          return;
+
+        if (m_block->references.sub(1) == 0)
+          delete m_block;
+
+        m_block = NULL;
+      }
+    };
+  }
+}
+
+#endif
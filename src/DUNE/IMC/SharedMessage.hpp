@@ -0,0 +1,213 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+#ifndef DUNE_IMC_SHARED_MESSAGE_HPP_INCLUDED_
+#define DUNE_IMC_SHARED_MESSAGE_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cstddef>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/Concurrency/AtomicCounter.hpp>
+#include <DUNE/IMC/Message.hpp>
+#include <DUNE/Time/Clock.hpp>
+
+namespace DUNE
+{
+  namespace IMC
+  {
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM SharedMessage;
+
+    //! Immutable, reference counted message handle. Copies of a
+    //! SharedMessage refer to the same message object, which is
+    //! destroyed when the last handle goes away. The reference
+    //! counter is updated atomically, so handles may be copied and
+    //! destroyed concurrently from different threads. This allows
+    //! the message bus to deliver a single copy of a message to all
+    //! of its recipients.
+    class SharedMessage
+    {
+    public:
+      //! Create an empty handle.
+      SharedMessage(void):
+        m_block(NULL)
+      { }
+
+      //! Create a handle that takes ownership of a message. The
+      //! message must not be modified or deleted by the caller
+      //! after this point.
+      //! @param[in] msg message object (may be NULL).
+      explicit
+      SharedMessage(const Message* msg):
+        m_block(NULL)
+      {
+        if (msg != NULL)
+          m_block = new Block(msg);
+      }
+
+      //! Copy constructor. Shares the message of another handle.
+      //! @param[in] other handle.
+      SharedMessage(const SharedMessage& other):
+        m_block(other.m_block)
+      {
+        acquire();
+      }
+
+      //! Destructor. Deletes the message if this is the last
+      //! handle referring to it.
+      ~SharedMessage(void)
+      {
+        release();
+      }
+
+      //! Assignment operator.
+      //! @param[in] other handle.
+      //! @return this handle.
+      SharedMessage&
+      operator=(const SharedMessage& other)
+      {
+        if (m_block != other.m_block)
+        {
+          release();
+          m_block = other.m_block;
+          acquire();
+        }
+
+        return *this;
+      }
+
+      //! Create a handle to a private copy of a message. The copy
+      //! keeps the raw frame of the original message.
+      //! @param[in] msg message to copy.
+      //! @return new handle.
+      static SharedMessage
+      copy(const Message* msg)
+      {
+        Message* copy = msg->clone();
+        copy->setRawFrame(msg->getRawFrame());
+        return SharedMessage(copy);
+      }
+
+      //! Retrieve the message.
+      //! @return message object or NULL if the handle is empty.
+      const Message*
+      get(void) const
+      {
+        return (m_block == NULL) ? NULL : m_block->message;
+      }
+
+      const Message*
+      operator->(void) const
+      {
+        return m_block->message;
+      }
+
+      const Message&
+      operator*(void) const
+      {
+        return *m_block->message;
+      }
+
+      //! Test if the handle is empty.
+      //! @return true if the handle does not refer to a message.
+      bool
+      isNull(void) const
+      {
+        return m_block == NULL;
+      }
+
+      //! Retrieve the time at which the handle was created from a
+      //! message, i.e., when the message was published.
+      //! @return monotonic time in nanoseconds of the real clock (see
+      //! Time::Clock::getRealNsec()) or 0 if the handle is empty.
+      uint64_t
+      getCreationTime(void) const
+      {
+        return (m_block == NULL) ? 0 : m_block->time;
+      }
+
+      //! Retrieve the number of handles referring to the message.
+      //! @return number of references.
+      int
+      getReferenceCount(void) const
+      {
+        return (m_block == NULL) ? 0 : m_block->references.add(0);
+      }
+
+    private:
+      //! Shared state.
+      struct Block
+      {
+        Block(const Message* msg):
+          message(msg),
+          time(Time::Clock::getRealNsec()),
+          references(1)
+        { }
+
+        ~Block(void)
+        {
+          delete message;
+        }
+
+        //! Message object.
+        const Message* message;
+        //! Creation time.
+        uint64_t time;
+        //! Number of handles referring to this block.
+        mutable Concurrency::AtomicCounter references;
+      };
+
+      //! Shared state.
+      Block* m_block;
+
+      void
+      acquire(void)
+      {
+        if (m_block != NULL)
+          m_block->references.add(1);
+      }
+
+      void
+      release(void)
+      {
+        if (m_block == NULL)
+          return;
+
+        if (m_block->references.sub(1) == 0)
+          delete m_block;
+
+        m_block = NULL;
+      }
+    };
+  }
+}
+
+#endif
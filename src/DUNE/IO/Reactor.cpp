@@ -0,0 +1,623 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/System/Error.hpp>
+#include <DUNE/Time/Clock.hpp>
+#include <DUNE/Time/Constants.hpp>
+#include <DUNE/Time/Utils.hpp>
+#include <DUNE/IO/Reactor.hpp>
+
+// POSIX headers.
+#if defined(DUNE_IO_REACTOR_EPOLL)
+#  include <sys/epoll.h>
+#  include <sys/eventfd.h>
+#  include <sys/timerfd.h>
+#  include <unistd.h>
+#elif defined(DUNE_OS_POSIX)
+#  include <sys/select.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+namespace DUNE
+{
+  namespace IO
+  {
+    using System::Error;
+
+    //! Create an event with no readiness flags.
+    //! @param[in] handle I/O handle.
+    //! @param[in] data user data.
+    //! @return event.
+    static Reactor::Event
+    makeEvent(const NativeHandle& handle, void* data)
+    {
+      Reactor::Event ev;
+      ev.handle = handle;
+      ev.data = data;
+      ev.events = 0;
+      ev.expirations = 0;
+      return ev;
+    }
+
+#if defined(DUNE_IO_REACTOR_EPOLL)
+    //! Maximum number of events retrieved per system call.
+    static const int c_max_events = 64;
+
+    //! Convert event flags to epoll flags.
+    //! @param[in] events event flags.
+    //! @return epoll flags.
+    static uint32_t
+    toEpoll(unsigned events)
+    {
+      uint32_t rv = 0;
+
+      if (events & Reactor::EV_READ)
+        rv |= EPOLLIN;
+
+      if (events & Reactor::EV_WRITE)
+        rv |= EPOLLOUT;
+
+      if (events & Reactor::EV_EDGE)
+        rv |= EPOLLET;
+
+      return rv;
+    }
+
+    Reactor::Reactor(void):
+      m_wakeup(0)
+    {
+      m_fd = epoll_create1(EPOLL_CLOEXEC);
+      if (m_fd == -1)
+        throw Error(errno, "creating reactor");
+
+      m_wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+      if (m_wakeup_fd == -1)
+      {
+        int error = errno;
+        close(m_fd);
+        throw Error(error, "creating reactor wake up event");
+      }
+
+      // The wake up channel is the only registration without an entry.
+      epoll_event ev;
+      ev.events = EPOLLIN;
+      ev.data.ptr = 0;
+      if (epoll_ctl(m_fd, EPOLL_CTL_ADD, m_wakeup_fd, &ev) == -1)
+      {
+        int error = errno;
+        close(m_wakeup_fd);
+        close(m_fd);
+        throw Error(error, "registering reactor wake up event");
+      }
+    }
+
+    Reactor::~Reactor(void)
+    {
+      std::map<NativeHandle, Entry*>::iterator hitr = m_handles.begin();
+      for (; hitr != m_handles.end(); ++hitr)
+        delete hitr->second;
+
+      std::map<unsigned, Entry*>::iterator titr = m_timers.begin();
+      for (; titr != m_timers.end(); ++titr)
+      {
+        close(titr->second->handle);
+        delete titr->second;
+      }
+
+      close(m_wakeup_fd);
+      close(m_fd);
+    }
+
+    void
+    Reactor::add(const NativeHandle& handle, unsigned events, void* data)
+    {
+      if (m_handles.find(handle) != m_handles.end())
+        throw Error("registering handle", "handle is already registered");
+
+      Entry* entry = new Entry;
+      entry->handle = handle;
+      entry->events = events;
+      entry->data = data;
+      entry->period = 0;
+      entry->deadline = 0;
+
+      epoll_event ev;
+      ev.events = toEpoll(events);
+      ev.data.ptr = entry;
+      if (epoll_ctl(m_fd, EPOLL_CTL_ADD, handle, &ev) == -1)
+      {
+        int error = errno;
+        delete entry;
+        throw Error(error, "registering handle");
+      }
+
+      m_handles[handle] = entry;
+    }
+
+    void
+    Reactor::modify(const NativeHandle& handle, unsigned events)
+    {
+      std::map<NativeHandle, Entry*>::iterator itr = m_handles.find(handle);
+      if (itr == m_handles.end())
+        throw Error("modifying handle", "handle is not registered");
+
+      if (itr->second->events == events)
+        return;
+
+      epoll_event ev;
+      ev.events = toEpoll(events);
+      ev.data.ptr = itr->second;
+      if (epoll_ctl(m_fd, EPOLL_CTL_MOD, handle, &ev) == -1)
+        throw Error(errno, "modifying handle");
+
+      itr->second->events = events;
+    }
+
+    void
+    Reactor::remove(const NativeHandle& handle)
+    {
+      std::map<NativeHandle, Entry*>::iterator itr = m_handles.find(handle);
+      if (itr == m_handles.end())
+        return;
+
+      // Fails harmlessly if the handle was already closed.
+      epoll_event ev;
+      epoll_ctl(m_fd, EPOLL_CTL_DEL, handle, &ev);
+
+      delete itr->second;
+      m_handles.erase(itr);
+    }
+
+    unsigned
+    Reactor::addTimer(double period, void* data)
+    {
+      int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+      if (fd == -1)
+        throw Error(errno, "creating timer");
+
+      timespec ts = DUNE_TIMESPEC_INIT_SEC_FP(period);
+      // A zero expiration would disarm the timer.
+      if (ts.tv_sec == 0 && ts.tv_nsec <= 0)
+        ts.tv_nsec = 1;
+
+      itimerspec its;
+      its.it_interval = ts;
+      its.it_value = ts;
+
+      Entry* entry = new Entry;
+      entry->handle = fd;
+      entry->events = EV_TIMER;
+      entry->data = data;
+      entry->period = period;
+      entry->deadline = 0;
+
+      epoll_event ev;
+      ev.events = EPOLLIN;
+      ev.data.ptr = entry;
+
+      if (timerfd_settime(fd, 0, &its, NULL) == -1
+          || epoll_ctl(m_fd, EPOLL_CTL_ADD, fd, &ev) == -1)
+      {
+        int error = errno;
+        delete entry;
+        close(fd);
+        throw Error(error, "starting timer");
+      }
+
+      m_timers[fd] = entry;
+      return fd;
+    }
+
+    void
+    Reactor::removeTimer(unsigned timer)
+    {
+      std::map<unsigned, Entry*>::iterator itr = m_timers.find(timer);
+      if (itr == m_timers.end())
+        return;
+
+      epoll_event ev;
+      epoll_ctl(m_fd, EPOLL_CTL_DEL, itr->second->handle, &ev);
+      close(itr->second->handle);
+
+      delete itr->second;
+      m_timers.erase(itr);
+    }
+
+    void
+    Reactor::wakeup(void)
+    {
+      // Only the first wake up after the last wait needs a write.
+      if (__sync_add_and_fetch(&m_wakeup, 1) != 1)
+        return;
+
+      uint64_t value = 1;
+      if (write(m_wakeup_fd, &value, sizeof(value)) < 0)
+        return;
+    }
+
+    void
+    Reactor::clearWakeup(void)
+    {
+      // Drain the eventfd before resetting the flag. Otherwise a
+      // wake up between both steps would leave the flag set without a
+      // pending write and later wake ups would never write again.
+      uint64_t value = 0;
+      if (read(m_wakeup_fd, &value, sizeof(value)) < 0)
+        value = 0;
+
+      __sync_synchronize();
+      m_wakeup = 0;
+      __sync_synchronize();
+    }
+
+    size_t
+    Reactor::wait(double timeout, std::vector<Event>& events)
+    {
+      events.clear();
+
+      int ms = (timeout < 0) ? -1 : (int)std::ceil(timeout * 1000.0);
+      epoll_event evs[c_max_events];
+      int rv = epoll_wait(m_fd, evs, c_max_events, ms);
+
+      if (rv == -1)
+      {
+        //! Workaround for when we are interrupted by a signal.
+        if (errno == EINTR)
+          return 0;
+        else
+          throw Error("waiting for events", Error::getLastMessage());
+      }
+
+      for (int i = 0; i < rv; ++i)
+      {
+        Entry* entry = static_cast<Entry*>(evs[i].data.ptr);
+        if (entry == 0)
+        {
+          clearWakeup();
+          continue;
+        }
+
+        Event ev = makeEvent(entry->handle, entry->data);
+
+        if (entry->events & EV_TIMER)
+        {
+          uint64_t count = 0;
+          if (read(entry->handle, &count, sizeof(count)) != sizeof(count))
+            continue;
+
+          ev.events = EV_TIMER;
+          ev.expirations = (unsigned)count;
+        }
+        else
+        {
+          if (evs[i].events & EPOLLIN)
+            ev.events |= EV_READ;
+
+          if (evs[i].events & EPOLLOUT)
+            ev.events |= EV_WRITE;
+
+          // Let the next operation report the cause.
+          if (evs[i].events & (EPOLLERR | EPOLLHUP))
+            ev.events |= EV_ERROR | (entry->events & (EV_READ | EV_WRITE));
+        }
+
+        events.push_back(ev);
+      }
+
+      return events.size();
+    }
+
+    const char*
+    Reactor::getBackend(void)
+    {
+      return "epoll";
+    }
+
+#else
+    Reactor::Reactor(void):
+      m_next_timer(0)
+    {
+#  if defined(DUNE_OS_POSIX)
+      if (pipe(m_pipe) == -1)
+        throw Error(errno, "creating reactor wake up pipe");
+
+      for (unsigned i = 0; i < 2; ++i)
+      {
+        int flags = fcntl(m_pipe[i], F_GETFL, 0);
+        fcntl(m_pipe[i], F_SETFL, flags | O_NONBLOCK);
+      }
+#  elif defined(DUNE_OS_WINDOWS)
+      m_wakeup_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+      if (m_wakeup_event == NULL)
+        throw Error("creating reactor wake up event", Error::getLastMessage());
+#  endif
+    }
+
+    Reactor::~Reactor(void)
+    {
+      std::map<NativeHandle, Entry*>::iterator hitr = m_handles.begin();
+      for (; hitr != m_handles.end(); ++hitr)
+        delete hitr->second;
+
+      std::map<unsigned, Entry*>::iterator titr = m_timers.begin();
+      for (; titr != m_timers.end(); ++titr)
+        delete titr->second;
+
+#  if defined(DUNE_OS_POSIX)
+      close(m_pipe[0]);
+      close(m_pipe[1]);
+#  elif defined(DUNE_OS_WINDOWS)
+      CloseHandle(m_wakeup_event);
+#  endif
+    }
+
+    void
+    Reactor::add(const NativeHandle& handle, unsigned events, void* data)
+    {
+      if (m_handles.find(handle) != m_handles.end())
+        throw Error("registering handle", "handle is already registered");
+
+      Entry* entry = new Entry;
+      entry->handle = handle;
+      entry->events = events;
+      entry->data = data;
+      entry->period = 0;
+      entry->deadline = 0;
+      m_handles[handle] = entry;
+    }
+
+    void
+    Reactor::modify(const NativeHandle& handle, unsigned events)
+    {
+      std::map<NativeHandle, Entry*>::iterator itr = m_handles.find(handle);
+      if (itr == m_handles.end())
+        throw Error("modifying handle", "handle is not registered");
+
+      itr->second->events = events;
+    }
+
+    void
+    Reactor::remove(const NativeHandle& handle)
+    {
+      std::map<NativeHandle, Entry*>::iterator itr = m_handles.find(handle);
+      if (itr == m_handles.end())
+        return;
+
+      delete itr->second;
+      m_handles.erase(itr);
+    }
+
+    unsigned
+    Reactor::addTimer(double period, void* data)
+    {
+      Entry* entry = new Entry;
+      entry->handle = NativeHandle();
+      entry->events = EV_TIMER;
+      entry->data = data;
+      entry->period = period;
+      entry->deadline = Time::Clock::getReal() + period;
+
+      m_timers[m_next_timer] = entry;
+      return m_next_timer++;
+    }
+
+    void
+    Reactor::removeTimer(unsigned timer)
+    {
+      std::map<unsigned, Entry*>::iterator itr = m_timers.find(timer);
+      if (itr == m_timers.end())
+        return;
+
+      delete itr->second;
+      m_timers.erase(itr);
+    }
+
+    void
+    Reactor::wakeup(void)
+    {
+#  if defined(DUNE_OS_POSIX)
+      // The pipe is non-blocking, a full pipe already wakes us up.
+      char byte = 0;
+      if (write(m_pipe[1], &byte, 1) < 0)
+        return;
+#  elif defined(DUNE_OS_WINDOWS)
+      SetEvent(m_wakeup_event);
+#  endif
+    }
+
+    void
+    Reactor::clearWakeup(void)
+    {
+#  if defined(DUNE_OS_POSIX)
+      char bfr[64];
+      while (read(m_pipe[0], bfr, sizeof(bfr)) > 0)
+      { }
+#  endif
+    }
+
+    size_t
+    Reactor::wait(double timeout, std::vector<Event>& events)
+    {
+      events.clear();
+
+      // Do not sleep past the next timer deadline.
+      double now = Time::Clock::getReal();
+      std::map<unsigned, Entry*>::iterator titr = m_timers.begin();
+      for (; titr != m_timers.end(); ++titr)
+      {
+        double left = titr->second->deadline - now;
+        if (left < 0)
+          left = 0;
+
+        if (timeout < 0 || left < timeout)
+          timeout = left;
+      }
+
+#  if defined(DUNE_OS_POSIX)
+      fd_set rfd;
+      fd_set wfd;
+      FD_ZERO(&rfd);
+      FD_ZERO(&wfd);
+      FD_SET(m_pipe[0], &rfd);
+      NativeHandle max = m_pipe[0];
+
+      std::map<NativeHandle, Entry*>::iterator hitr = m_handles.begin();
+      for (; hitr != m_handles.end(); ++hitr)
+      {
+        if (hitr->second->events & EV_READ)
+          FD_SET(hitr->first, &rfd);
+
+        if (hitr->second->events & EV_WRITE)
+          FD_SET(hitr->first, &wfd);
+
+        if (hitr->first > max)
+          max = hitr->first;
+      }
+
+      int rv = 0;
+      if (timeout < 0.0)
+      {
+        rv = select(max + 1, &rfd, &wfd, NULL, NULL);
+      }
+      else
+      {
+        timeval tv = DUNE_TIMEVAL_INIT_SEC_FP(timeout);
+        rv = select(max + 1, &rfd, &wfd, NULL, &tv);
+      }
+
+      if (rv == -1)
+      {
+        //! Workaround for when we are interrupted by a signal.
+        if (errno == EINTR)
+          return 0;
+        else
+          throw Error("waiting for events", Error::getLastMessage());
+      }
+
+      if (rv > 0)
+      {
+        if (FD_ISSET(m_pipe[0], &rfd))
+          clearWakeup();
+
+        for (hitr = m_handles.begin(); hitr != m_handles.end(); ++hitr)
+        {
+          Event ev = makeEvent(hitr->first, hitr->second->data);
+
+          if (FD_ISSET(hitr->first, &rfd))
+            ev.events |= EV_READ;
+
+          if (FD_ISSET(hitr->first, &wfd))
+            ev.events |= EV_WRITE;
+
+          if (ev.events != 0)
+            events.push_back(ev);
+        }
+      }
+
+#  elif defined(DUNE_OS_WINDOWS)
+      // Only read readiness can be waited for, writable handles are
+      // always reported as ready.
+      std::vector<HANDLE> handles;
+      std::vector<Entry*> entries;
+      handles.push_back(m_wakeup_event);
+
+      std::map<NativeHandle, Entry*>::iterator hitr = m_handles.begin();
+      for (; hitr != m_handles.end(); ++hitr)
+      {
+        if (hitr->second->events & EV_READ)
+        {
+          handles.push_back(hitr->first);
+          entries.push_back(hitr->second);
+        }
+
+        if (hitr->second->events & EV_WRITE)
+        {
+          Event ev = makeEvent(hitr->first, hitr->second->data);
+          ev.events = EV_WRITE;
+          events.push_back(ev);
+          timeout = 0;
+        }
+      }
+
+      DWORD ms = (timeout < 0) ? INFINITE : (DWORD)std::ceil(timeout * 1000.0);
+      DWORD rv = WaitForMultipleObjects(handles.size(), &handles[0], FALSE, ms);
+
+      if (rv == WAIT_FAILED)
+        throw Error("waiting for events", Error::getLastMessage());
+
+      size_t idx = rv - WAIT_OBJECT_0;
+      if (idx > 0 && idx < handles.size())
+      {
+        Event ev = makeEvent(entries[idx - 1]->handle, entries[idx - 1]->data);
+        ev.events = EV_READ;
+        events.push_back(ev);
+      }
+#  endif
+
+      now = Time::Clock::getReal();
+      for (titr = m_timers.begin(); titr != m_timers.end(); ++titr)
+      {
+        Entry* entry = titr->second;
+        if (now < entry->deadline)
+          continue;
+
+        unsigned count = 1;
+        if (entry->period > 0)
+          count += (unsigned)((now - entry->deadline) / entry->period);
+        entry->deadline = std::max(entry->deadline + count * entry->period, now);
+
+        Event ev = makeEvent(entry->handle, entry->data);
+        ev.events = EV_TIMER;
+        ev.expirations = count;
+        events.push_back(ev);
+      }
+
+      return events.size();
+    }
+
+    const char*
+    Reactor::getBackend(void)
+    {
+#  if defined(DUNE_OS_POSIX)
+      return "select";
+#  else
+      return "WaitForMultipleObjects";
+#  endif
+    }
+#endif
+  }
+}
@@ -0,0 +1,241 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+#ifndef DUNE_IO_REACTOR_HPP_INCLUDED_
+#define DUNE_IO_REACTOR_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <map>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/IO/Handle.hpp>
+
+// Check if we can use epoll(7), timerfd_create(2), eventfd(2) and
+// GCC's atomic functions.
+#if defined(DUNE_SYS_HAS_SYS_EPOLL_H) && defined(DUNE_SYS_HAS_EPOLL_CREATE1) \
+  && defined(DUNE_SYS_HAS_SYS_TIMERFD_H) && defined(DUNE_SYS_HAS_TIMERFD_CREATE) \
+  && defined(DUNE_SYS_HAS_SYS_EVENTFD_H) && defined(DUNE_SYS_HAS_EVENTFD) \
+  && defined(DUNE_SYS_HAS___SYNC_ADD_AND_FETCH) && defined(DUNE_SYS_HAS___SYNC_SYNCHRONIZE)
+#  ifndef DUNE_IO_REACTOR_EPOLL
+#    define DUNE_IO_REACTOR_EPOLL
+#  endif
+#endif
+
+namespace DUNE
+{
+  namespace IO
+  {
+    // Export symbol.
+    class DUNE_DLL_SYM Reactor;
+
+    //! I/O event demultiplexer. I/O handles and periodic timers are
+    //! registered once and wait() reports the ones that are ready,
+    //! in time proportional to the number of ready handles. Any
+    //! thread may interrupt a wait with wakeup().
+    //!
+    //! On Linux this is backed by epoll, timerfd and eventfd. Other
+    //! POSIX systems use select(), where edge-triggered registrations
+    //! behave as level-triggered ones. On Microsoft Windows only read
+    //! readiness is waited for and writable handles are always
+    //! reported as ready.
+    //!
+    //! Apart from wakeup(), methods must be called from a single
+    //! thread.
+    class Reactor
+    {
+    public:
+      //! Event flags.
+      enum EventFlags
+      {
+        //! Handle is readable.
+        EV_READ = 0x01,
+        //! Handle is writable.
+        EV_WRITE = 0x02,
+        //! Error or hang up condition on handle.
+        EV_ERROR = 0x04,
+        //! Timer expired.
+        EV_TIMER = 0x08,
+        //! Report readiness only when it changes (registration only).
+        EV_EDGE = 0x10
+      };
+
+      //! Reported event.
+      struct Event
+      {
+        //! I/O handle, undefined for timers.
+        NativeHandle handle;
+        //! User data given at registration.
+        void* data;
+        //! Event flags.
+        unsigned events;
+        //! Number of timer expirations since the last report.
+        unsigned expirations;
+      };
+
+      //! Constructor.
+      Reactor(void);
+
+      //! Destructor.
+      ~Reactor(void);
+
+      //! Register a native I/O handle.
+      //! @param[in] handle native I/O handle.
+      //! @param[in] events events of interest (EV_READ, EV_WRITE,
+      //! optionally combined with EV_EDGE).
+      //! @param[in] data user data reported with events.
+      void
+      add(const NativeHandle& handle, unsigned events, void* data = 0);
+
+      //! Register an I/O handle.
+      //! @param[in] handle I/O handle.
+      //! @param[in] events events of interest.
+      //! @param[in] data user data reported with events.
+      void
+      add(const Handle& handle, unsigned events, void* data = 0)
+      {
+        add(handle.getNative(), events, data);
+      }
+
+      //! Change the events of interest of a registered native I/O
+      //! handle.
+      //! @param[in] handle native I/O handle.
+      //! @param[in] events events of interest.
+      void
+      modify(const NativeHandle& handle, unsigned events);
+
+      //! Change the events of interest of a registered I/O handle.
+      //! @param[in] handle I/O handle.
+      //! @param[in] events events of interest.
+      void
+      modify(const Handle& handle, unsigned events)
+      {
+        modify(handle.getNative(), events);
+      }
+
+      //! Unregister a native I/O handle. Events of the handle already
+      //! returned by wait() remain in the caller's list.
+      //! @param[in] handle native I/O handle.
+      void
+      remove(const NativeHandle& handle);
+
+      //! Unregister an I/O handle.
+      //! @param[in] handle I/O handle.
+      void
+      remove(const Handle& handle)
+      {
+        remove(handle.getNative());
+      }
+
+      //! Add a periodic timer.
+      //! @param[in] period timer period in seconds.
+      //! @param[in] data user data reported with events.
+      //! @return timer identifier.
+      unsigned
+      addTimer(double period, void* data = 0);
+
+      //! Remove a periodic timer.
+      //! @param[in] timer timer identifier.
+      void
+      removeTimer(unsigned timer);
+
+      //! Interrupt the current or next call to wait(). Can be called
+      //! from any thread and consecutive calls are coalesced.
+      void
+      wakeup(void);
+
+      //! Wait for events.
+      //! @param[in] timeout timeout in seconds, use a negative number
+      //! to wait forever.
+      //! @param[out] events ready handles and expired timers.
+      //! @return number of events, which may be zero if the wait
+      //! timed out or was interrupted by wakeup().
+      size_t
+      wait(double timeout, std::vector<Event>& events);
+
+      //! Retrieve the name of the underlying mechanism.
+      //! @return mechanism name.
+      static const char*
+      getBackend(void);
+
+    private:
+      //! Registered handle or timer.
+      struct Entry
+      {
+        //! I/O handle or timer file descriptor.
+        NativeHandle handle;
+        //! Events of interest.
+        unsigned events;
+        //! User data.
+        void* data;
+        //! Timer period.
+        double period;
+        //! Timer deadline.
+        double deadline;
+      };
+
+      //! Registered handles.
+      std::map<NativeHandle, Entry*> m_handles;
+      //! Registered timers.
+      std::map<unsigned, Entry*> m_timers;
+#if defined(DUNE_IO_REACTOR_EPOLL)
+      //! Number of wake ups since the last wait.
+      volatile int m_wakeup;
+      //! epoll instance.
+      int m_fd;
+      //! Wake up event file descriptor.
+      int m_wakeup_fd;
+#else
+      //! Next timer identifier.
+      unsigned m_next_timer;
+#  if defined(DUNE_OS_POSIX)
+      //! Wake up pipe.
+      int m_pipe[2];
+#  elif defined(DUNE_OS_WINDOWS)
+      //! Wake up event.
+      HANDLE m_wakeup_event;
+#  endif
+#endif
+
+      //! Reset the wake up flag and drain the wake up channel.
+      void
+      clearWakeup(void);
+
+      //! Non-copyable.
+      Reactor(const Reactor&);
+
+      //! Non-assignable.
+      Reactor&
+      operator=(const Reactor&);
+    };
+  }
+}
+
+#endif
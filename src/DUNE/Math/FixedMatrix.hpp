@@ -0,0 +1,416 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+#ifndef DUNE_MATH_FIXED_MATRIX_HPP_INCLUDED_
+#define DUNE_MATH_FIXED_MATRIX_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cmath>
+#include <cstddef>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/Math/Matrix.hpp>
+
+namespace DUNE
+{
+  namespace Math
+  {
+    //! Matrix with dimensions known at compile time. Elements are
+    //! stored in row-major order inside the object itself, so
+    //! instances never touch the heap and can be freely copied.
+    //! Use it for the small, fixed-size matrices of estimators and
+    //! controllers that are evaluated at every control step.
+    //! @tparam R number of rows.
+    //! @tparam C number of columns.
+    template <unsigned R, unsigned C>
+    class FixedMatrix
+    {
+    public:
+      //! Create a matrix filled with zeros.
+      FixedMatrix(void)
+      {
+        fill(0.0);
+      }
+
+      //! Create a matrix with all elements set to a value.
+      //! @param value element value.
+      explicit FixedMatrix(double value)
+      {
+        fill(value);
+      }
+
+      //! Create a matrix from an array in row-major order.
+      //! @param data array with R * C elements.
+      explicit FixedMatrix(const double* data)
+      {
+        for (unsigned i = 0; i < R * C; ++i)
+          m_data[i] = data[i];
+      }
+
+      //! Create a matrix from a dynamically sized matrix.
+      //! @param m matrix with R rows and C columns.
+      explicit FixedMatrix(const Matrix& m)
+      {
+        assign(m);
+      }
+
+      //! Get number of rows.
+      //! @return number of rows.
+      static unsigned
+      rows(void)
+      {
+        return R;
+      }
+
+      //! Get number of columns.
+      //! @return number of columns.
+      static unsigned
+      columns(void)
+      {
+        return C;
+      }
+
+      //! Get number of elements.
+      //! @return number of elements.
+      static unsigned
+      size(void)
+      {
+        return R * C;
+      }
+
+      //! Set all elements to a value.
+      //! @param value element value.
+      void
+      fill(double value)
+      {
+        for (unsigned i = 0; i < R * C; ++i)
+          m_data[i] = value;
+      }
+
+      //! Set the matrix to identity.
+      void
+      identity(void)
+      {
+        fill(0.0);
+        for (unsigned i = 0; i < R && i < C; ++i)
+          m_data[i * C + i] = 1.0;
+      }
+
+      //! Copy the elements of a dynamically sized matrix.
+      //! @param m matrix with R rows and C columns.
+      void
+      assign(const Matrix& m)
+      {
+        if ((unsigned)m.rows() != R || (unsigned)m.columns() != C)
+          throw Matrix::Error("Incompatible dimensions!");
+
+        for (unsigned i = 0; i < R; ++i)
+        {
+          for (unsigned j = 0; j < C; ++j)
+            m_data[i * C + j] = m(i, j);
+        }
+      }
+
+      //! Convert to a dynamically sized matrix.
+      //! @return matrix with the same elements.
+      Matrix
+      toMatrix(void) const
+      {
+        return Matrix(m_data, R, C);
+      }
+
+      //! Get pointer to elements, in row-major order.
+      //! @return pointer to elements.
+      double*
+      data(void)
+      {
+        return m_data;
+      }
+
+      //! Get pointer to elements, in row-major order.
+      //! @return pointer to elements.
+      const double*
+      data(void) const
+      {
+        return m_data;
+      }
+
+      //! Access element. Indexes are not checked.
+      //! @param i row index.
+      //! @param j column index.
+      //! @return element reference.
+      double&
+      operator()(unsigned i, unsigned j)
+      {
+        return m_data[i * C + j];
+      }
+
+      //! Access element. Indexes are not checked.
+      //! @param i row index.
+      //! @param j column index.
+      //! @return element value.
+      double
+      operator()(unsigned i, unsigned j) const
+      {
+        return m_data[i * C + j];
+      }
+
+      //! Access element in row-major order. Index is not checked.
+      //! @param i element index.
+      //! @return element reference.
+      double&
+      operator()(unsigned i)
+      {
+        return m_data[i];
+      }
+
+      //! Access element in row-major order. Index is not checked.
+      //! @param i element index.
+      //! @return element value.
+      double
+      operator()(unsigned i) const
+      {
+        return m_data[i];
+      }
+
+      FixedMatrix&
+      operator+=(const FixedMatrix& m)
+      {
+        for (unsigned i = 0; i < R * C; ++i)
+          m_data[i] += m.m_data[i];
+        return *this;
+      }
+
+      FixedMatrix&
+      operator-=(const FixedMatrix& m)
+      {
+        for (unsigned i = 0; i < R * C; ++i)
+          m_data[i] -= m.m_data[i];
+        return *this;
+      }
+
+      FixedMatrix&
+      operator*=(double x)
+      {
+        for (unsigned i = 0; i < R * C; ++i)
+          m_data[i] *= x;
+        return *this;
+      }
+
+      FixedMatrix&
+      operator/=(double x)
+      {
+        for (unsigned i = 0; i < R * C; ++i)
+          m_data[i] /= x;
+        return *this;
+      }
+
+    private:
+      //! Elements in row-major order.
+      double m_data[R * C] DUNE_ALIGNED(16);
+    };
+
+    template <unsigned R, unsigned C>
+    inline FixedMatrix<R, C>
+    operator+(const FixedMatrix<R, C>& a, const FixedMatrix<R, C>& b)
+    {
+      FixedMatrix<R, C> s(a);
+      s += b;
+      return s;
+    }
+
+    template <unsigned R, unsigned C>
+    inline FixedMatrix<R, C>
+    operator-(const FixedMatrix<R, C>& a, const FixedMatrix<R, C>& b)
+    {
+      FixedMatrix<R, C> s(a);
+      s -= b;
+      return s;
+    }
+
+    template <unsigned R, unsigned C>
+    inline FixedMatrix<R, C>
+    operator*(double x, const FixedMatrix<R, C>& a)
+    {
+      FixedMatrix<R, C> s(a);
+      s *= x;
+      return s;
+    }
+
+    template <unsigned R, unsigned C>
+    inline FixedMatrix<R, C>
+    operator*(const FixedMatrix<R, C>& a, double x)
+    {
+      return x * a;
+    }
+
+    //! Multiply two matrices into an existing matrix.
+    //! @param a left operand.
+    //! @param b right operand.
+    //! @param s result, must not be one of the operands.
+    template <unsigned R, unsigned N, unsigned C>
+    inline void
+    multiply(const FixedMatrix<R, N>& a, const FixedMatrix<N, C>& b, FixedMatrix<R, C>& s)
+    {
+      const double* a_p = a.data();
+      const double* b_p = b.data();
+      double* s_p = s.data();
+
+      for (unsigned i = 0; i < R; ++i)
+      {
+        for (unsigned j = 0; j < C; ++j)
+          s_p[i * C + j] = 0.0;
+
+        for (unsigned k = 0; k < N; ++k)
+        {
+          double v = a_p[i * N + k];
+          for (unsigned j = 0; j < C; ++j)
+            s_p[i * C + j] += v * b_p[k * C + j];
+        }
+      }
+    }
+
+    template <unsigned R, unsigned N, unsigned C>
+    inline FixedMatrix<R, C>
+    operator*(const FixedMatrix<R, N>& a, const FixedMatrix<N, C>& b)
+    {
+      FixedMatrix<R, C> s;
+      multiply(a, b, s);
+      return s;
+    }
+
+    template <unsigned R, unsigned C>
+    inline FixedMatrix<C, R>
+    transpose(const FixedMatrix<R, C>& a)
+    {
+      FixedMatrix<C, R> t;
+      for (unsigned i = 0; i < R; ++i)
+      {
+        for (unsigned j = 0; j < C; ++j)
+          t(j, i) = a(i, j);
+      }
+      return t;
+    }
+
+    //! Compute a * p * transpose(a) + q, the covariance propagation
+    //! of linear estimators, without forming transpose(a).
+    //! @param a transformation matrix.
+    //! @param p symmetric matrix.
+    //! @param q matrix added to the result.
+    //! @return a * p * transpose(a) + q.
+    template <unsigned R, unsigned N>
+    inline FixedMatrix<R, R>
+    congruence(const FixedMatrix<R, N>& a, const FixedMatrix<N, N>& p, const FixedMatrix<R, R>& q)
+    {
+      FixedMatrix<R, N> ap;
+      multiply(a, p, ap);
+
+      FixedMatrix<R, R> s(q);
+      for (unsigned i = 0; i < R; ++i)
+      {
+        for (unsigned j = 0; j < R; ++j)
+        {
+          double v = 0.0;
+          for (unsigned k = 0; k < N; ++k)
+            v += ap(i, k) * a(j, k);
+          s(i, j) += v;
+        }
+      }
+
+      return s;
+    }
+
+    //! Invert a square matrix using Gauss-Jordan elimination with
+    //! partial pivoting.
+    //! @param a matrix to invert.
+    //! @return inverse matrix.
+    template <unsigned N>
+    inline FixedMatrix<N, N>
+    inverse(const FixedMatrix<N, N>& a)
+    {
+      FixedMatrix<N, N> m(a);
+      FixedMatrix<N, N> s;
+      s.identity();
+
+      for (unsigned c = 0; c < N; ++c)
+      {
+        unsigned p = c;
+        for (unsigned i = c + 1; i < N; ++i)
+        {
+          if (std::fabs(m(i, c)) > std::fabs(m(p, c)))
+            p = i;
+        }
+
+        if (std::fabs(m(p, c)) <= Matrix::get_precision())
+          throw Matrix::Error("Matrix is not invertible!");
+
+        if (p != c)
+        {
+          for (unsigned j = 0; j < N; ++j)
+          {
+            double t = m(c, j);
+            m(c, j) = m(p, j);
+            m(p, j) = t;
+            t = s(c, j);
+            s(c, j) = s(p, j);
+            s(p, j) = t;
+          }
+        }
+
+        double d = 1.0 / m(c, c);
+        for (unsigned j = 0; j < N; ++j)
+        {
+          m(c, j) *= d;
+          s(c, j) *= d;
+        }
+
+        for (unsigned i = 0; i < N; ++i)
+        {
+          if (i == c)
+            continue;
+
+          double f = m(i, c);
+          if (f == 0.0)
+            continue;
+
+          for (unsigned j = 0; j < N; ++j)
+          {
+            m(i, j) -= f * m(c, j);
+            s(i, j) -= f * s(c, j);
+          }
+        }
+      }
+
+      return s;
+    }
+  }
+}
+
+#endif
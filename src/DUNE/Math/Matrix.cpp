@@ -701,6 +701,19 @@ namespace DUNE
       return m_data[i];
     }
 
+    double*
+    Matrix::data(void)
+    {
+      split();
+      return m_data;
+    }
+
+    const double*
+    Matrix::data(void) const
+    {
+      return m_data;
+    }
+
     void
     Matrix::to_row(void)
     {
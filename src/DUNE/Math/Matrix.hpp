@@ -368,6 +368,19 @@ namespace DUNE
       double
       element(size_t i);
 
+      //! This method returns a pointer to the entries of a Matrix, in
+      //! row-major order. Shared data is copied first, so the entries
+      //! can be modified without affecting other matrices.
+      //! @return pointer to the entries, or NULL if the matrix is empty.
+      double*
+      data(void);
+
+      //! This method returns a pointer to the entries of a Matrix, in
+      //! row-major order.
+      //! @return pointer to the entries, or NULL if the matrix is empty.
+      const double*
+      data(void) const;
+
       //! This method changes the dimensions of a Matrix to a one row Matrix.
       //! The elements are not changed.
       void
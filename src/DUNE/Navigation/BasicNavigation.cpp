@@ -578,9 +578,7 @@ namespace DUNE
       // Not sure about altitude.
       double x = 0.0;
       double y = 0.0;
-      Coordinates::WGS84::displacement(m_origin->lat, m_origin->lon, m_origin->height,
-                                       msg->lat, msg->lon, msg->height,
-                                       &x, &y, &m_last_z);
+      m_origin_plane.toNED(msg->lat, msg->lon, msg->height, &x, &y, &m_last_z);
 
       // Stream Estimator.
       IMC::EstimatedStreamVelocity stream;
@@ -595,6 +593,7 @@ namespace DUNE
       {
         // Redefine origin.
         Memory::replace(m_origin, new IMC::GpsFix(*msg));
+        m_origin_plane.setOrigin(msg->lat, msg->lon, msg->height);
 
         // Recalculate LBL positions.
         m_ranging.updateOrigin(msg);
@@ -842,6 +841,7 @@ namespace DUNE
     BasicNavigation::startNavigation(const IMC::GpsFix* msg)
     {
       Memory::replace(m_origin, new IMC::GpsFix(*msg));
+      m_origin_plane.setOrigin(msg->lat, msg->lon, msg->height);
 
       // Save message to cache.
       IMC::CacheControl cop;
@@ -924,17 +924,21 @@ namespace DUNE
     {
       // "Outlier Rejection for Autonomous Acoustic Navigation"
       // Jerome Vaganay, John J. Leonard and James G. Bellingham. MIT
-      Math::Matrix H(1, 2, 0.0);
+      Math::FixedMatrix<1, 2> H;
       H(0, 0) = dx / exp_range;
       H(0, 1) = dy / exp_range;
-      Math::Matrix P(2, 2, 0.0);
-      P = m_kal.getCovariance(STATE_X, STATE_Y, STATE_X, STATE_Y);
+      Math::FixedMatrix<2, 2> P;
+      P(0, 0) = m_kal.getCovariance(STATE_X, STATE_X);
+      P(0, 1) = m_kal.getCovariance(STATE_X, STATE_Y);
+      P(1, 0) = m_kal.getCovariance(STATE_Y, STATE_X);
+      P(1, 1) = m_kal.getCovariance(STATE_Y, STATE_Y);
 
+      double HPH = (H * P * transpose(H))(0);
       double k = getLblRejectionValue(exp_range);
-      double R = std::max(k, (H * P * transpose (H))(0));
+      double R = std::max(k, HPH);
 
       double d = range - exp_range;
-      m_navdata.lbl_rej_level = (d * (1 / ((H * P * transpose (H))(0) + R)) * d);
+      m_navdata.lbl_rej_level = (d * (1 / (HPH + R)) * d);
 
       // Is rejection level above maximum threshold?
       if (m_navdata.lbl_rej_level >= m_lbl_threshold)
@@ -36,6 +36,7 @@
 
 // DUNE headers.
 #include <DUNE/Coordinates/BodyFixedFrame.hpp>
+#include <DUNE/Coordinates/LocalTangentPlane.hpp>
 #include <DUNE/Coordinates/WGS84.hpp>
 #include <DUNE/Coordinates/WMM.hpp>
 #include <DUNE/IMC/Definitions.hpp>
@@ -631,6 +632,8 @@ namespace DUNE
       IMC::WaterVelocity m_wvel_previous;
       //! Navigation Startup point.
       IMC::GpsFix* m_origin;
+      //! Tangent plane at the navigation startup point.
+      Coordinates::LocalTangentPlane m_origin_plane;
       //! Displacement between LBL and GPS.
       float m_dist_lbl_gps;
       //! Always reject LblRanges.
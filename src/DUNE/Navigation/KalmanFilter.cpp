@@ -28,6 +28,9 @@
 // Author: José Braga                                                       *
 //***************************************************************************
 
+// ISO C++ 98 headers.
+#include <algorithm>
+
 // DUNE headers.
 #include <DUNE/Navigation/KalmanFilter.hpp>
 
@@ -113,15 +116,83 @@ namespace DUNE
       if (u.rows() != b.columns() || u.columns() != 1)
         throw std::runtime_error(DTR("invalid dimensions"));
 
-      m_x = m_ax * m_x + b * u;
-      m_p = m_ap * m_p * transpose(m_ap) + m_q;
+      if ((size_t)b.rows() != m_state_count)
+        throw std::runtime_error(DTR("invalid dimensions"));
+
+      propagate();
+
+      const double* b_p = static_cast<const Math::Matrix&>(b).data();
+      const double* u_p = static_cast<const Math::Matrix&>(u).data();
+      double* x_p = m_x.data();
+      size_t m = u.rows();
+
+      for (size_t i = 0; i < m_state_count; ++i)
+      {
+        for (size_t k = 0; k < m; ++k)
+          x_p[i] += b_p[i * m + k] * u_p[k];
+      }
     }
 
     void
     KalmanFilter::predict(void)
     {
-      m_x = m_ax * m_x;
-      m_p = m_ap * m_p * transpose(m_ap) + m_q;
+      propagate();
+    }
+
+    void
+    KalmanFilter::propagate(void)
+    {
+      size_t n = m_state_count;
+
+      if ((size_t)m_tmp.rows() != n || (size_t)m_tmp.columns() != n + 1)
+        m_tmp.resize(n, n + 1);
+
+      // Read-only operands must not be detached from shared copies.
+      const double* ax = static_cast<const Math::Matrix&>(m_ax).data();
+      const double* ap = static_cast<const Math::Matrix&>(m_ap).data();
+      const double* q = static_cast<const Math::Matrix&>(m_q).data();
+      double* x = m_x.data();
+      double* p = m_p.data();
+      double* t = m_tmp.data();
+
+      // t = [ap * p | ax * x], row by row.
+      for (size_t i = 0; i < n; ++i)
+      {
+        double* t_row = t + i * (n + 1);
+
+        for (size_t j = 0; j <= n; ++j)
+          t_row[j] = 0.0;
+
+        for (size_t k = 0; k < n; ++k)
+        {
+          double v = ap[i * n + k];
+          const double* p_row = p + k * n;
+
+          for (size_t j = 0; j < n; ++j)
+            t_row[j] += v * p_row[j];
+
+          t_row[n] += ax[i * n + k] * x[k];
+        }
+      }
+
+      // p = (ap * p) * transpose(ap) + q, x = ax * x.
+      for (size_t i = 0; i < n; ++i)
+      {
+        const double* t_row = t + i * (n + 1);
+
+        for (size_t j = 0; j < n; ++j)
+        {
+          const double* ap_row = ap + j * n;
+          double v = q[i * n + j];
+
+          for (size_t k = 0; k < n; ++k)
+            v += t_row[k] * ap_row[k];
+
+          p[i * n + j] = v;
+        }
+
+        x[i] = t_row[n];
+      }
     }
 
     int
@@ -139,6 +210,180 @@ namespace DUNE
       if (m_r.rows() != m_r.columns() || m_r.rows() != m_innov.rows())
         throw std::runtime_error(DTR("invalid dimensions"));
 
+      size_t n = m_state_count;
+      size_t outputs = m_innov.rows();
+      const double* c = static_cast<const Math::Matrix&>(m_c).data();
+      const double* r = static_cast<const Math::Matrix&>(m_r).data();
+      const double* innov = static_cast<const Math::Matrix&>(m_innov).data();
+
+      // Correlated measurement noises cannot be processed one at a time.
+      for (size_t i = 0; i < outputs; ++i)
+      {
+        for (size_t j = 0; j < outputs; ++j)
+        {
+          if (i != j && r[i * outputs + j] != 0.0)
+            return updateBatch(threshold);
+        }
+      }
+
+      m_obs_states.resize(n);
+      m_obs_values.resize(n);
+      m_backup.resize(n + n * n);
+
+      // Innovations are given for the predicted state, and must be
+      // corrected for the change made by previous observations. The
+      // covariance is saved too, so that a rejected or failed update
+      // leaves the filter unchanged.
+      double* x = m_x.data();
+      const double* p = static_cast<const Math::Matrix&>(m_p).data();
+      std::copy(x, x + n, m_backup.begin());
+      std::copy(p, p + n * n, m_backup.begin() + n);
+
+      // Sum of the normalized innovations squared, equal to the
+      // rejection level of the batch update.
+      double level = 0;
+
+      for (size_t i = 0; i < outputs; ++i)
+      {
+        unsigned count = 0;
+        double dz = 0;
+        for (size_t j = 0; j < n; ++j)
+        {
+          double h = c[i * n + j];
+          if (h == 0.0)
+            continue;
+
+          m_obs_states[count] = j;
+          m_obs_values[count] = h;
+          dz += h * (x[j] - m_backup[j]);
+          ++count;
+        }
+
+        double v = innov[i] - dz;
+
+        if (count == 0)
+        {
+          if (threshold != 0)
+          {
+            if (r[i * outputs + i] <= 0)
+            {
+              restore();
+              throw std::runtime_error(DTR("matrix inversion error"));
+            }
+
+            level += v * v / r[i * outputs + i];
+          }
+
+          continue;
+        }
+
+        double s = project(&m_obs_states[0], &m_obs_values[0], count, r[i * outputs + i]);
+        if (s <= 0)
+        {
+          restore();
+          throw std::runtime_error(DTR("matrix inversion error"));
+        }
+
+        level += v * v / s;
+        correct(v, s);
+      }
+
+      // Check if innovation is above a threshold value.
+      // Set threshold to 0 to accept everything.
+      if (threshold != 0 && level >= threshold)
+      {
+        restore();
+        return -1;
+      }
+
+      return 0;
+    }
+
+    void
+    KalmanFilter::restore(void)
+    {
+      size_t n = m_state_count;
+      std::copy(m_backup.begin(), m_backup.begin() + n, m_x.data());
+      std::copy(m_backup.begin() + n, m_backup.end(), m_p.data());
+    }
+
+    int
+    KalmanFilter::update(const unsigned* states, const double* h, unsigned count,
+                         double innovation, double noise, float threshold)
+    {
+      for (unsigned i = 0; i < count; ++i)
+      {
+        if (states[i] >= m_state_count)
+          throw std::runtime_error(DTR("invalid index"));
+      }
+
+      double s = project(states, h, count, noise);
+      if (s <= 0)
+        throw std::runtime_error(DTR("matrix inversion error"));
+
+      // Check if innovation is above a threshold value.
+      // Set threshold to 0 to accept everything.
+      if (threshold != 0 && innovation * innovation / s >= threshold)
+        return -1;
+
+      correct(innovation, s);
+      return 0;
+    }
+
+    double
+    KalmanFilter::project(const unsigned* states, const double* h, unsigned count, double noise)
+    {
+      size_t n = m_state_count;
+      const double* p = static_cast<const Math::Matrix&>(m_p).data();
+
+      m_gain.resize(n);
+
+      for (size_t i = 0; i < n; ++i)
+      {
+        const double* p_row = p + i * n;
+        double g = 0;
+
+        for (unsigned k = 0; k < count; ++k)
+          g += p_row[states[k]] * h[k];
+
+        m_gain[i] = g;
+      }
+
+      double s = noise;
+      for (unsigned k = 0; k < count; ++k)
+        s += h[k] * m_gain[states[k]];
+
+      return s;
+    }
+
+    void
+    KalmanFilter::correct(double innovation, double s)
+    {
+      size_t n = m_state_count;
+      double* x = m_x.data();
+      double* p = m_p.data();
+
+      // K = P * h' / s, x = x + K * innovation, P = P - K * h * P.
+      // Only the upper triangle is computed and then mirrored, so
+      // rounding errors cannot make the covariance asymmetric.
+      for (size_t i = 0; i < n; ++i)
+      {
+        double k = m_gain[i] / s;
+
+        x[i] += k * innovation;
+
+        for (size_t j = i; j < n; ++j)
+        {
+          double v = p[i * n + j] - k * m_gain[j];
+          p[i * n + j] = v;
+          p[j * n + i] = v;
+        }
+      }
+    }
+
+    int
+    KalmanFilter::updateBatch(float threshold)
+    {
       // Measurement prediction covariance.
       Math::Matrix S = (m_c * m_p * transpose(m_c)) + m_r;
       Math::Matrix S_1;
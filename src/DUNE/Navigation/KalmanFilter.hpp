@@ -45,6 +45,7 @@
 // ISO C++ 98 headers.
 #include <stdexcept>
 #include <string>
+#include <vector>
 #include <cmath>
 
 // DUNE headers.
@@ -103,12 +104,30 @@ namespace DUNE
       void
       predict(void);
 
-      //! Kalman Filter update function.
+      //! Kalman Filter update function. When the measurement noise
+      //! covariance is diagonal the outputs are processed one at a
+      //! time as scalar observations, skipping zero observation rows
+      //! and updating the covariance in place. The result, including
+      //! the rejection level, is the same as the batch update. A
+      //! rejected or failed update leaves the filter unchanged.
       //! @param threshold threshold to reject large state innovations.
       //! @return 0 if update is successful, -1 otherwise.
       int
       update(float threshold);
 
+      //! Update the filter with a single scalar observation, given by
+      //! the nonzero entries of its observation vector.
+      //! @param states indexes of the observed states.
+      //! @param h observation vector values for each observed state.
+      //! @param count number of observed states.
+      //! @param innovation measurement innovation.
+      //! @param noise measurement noise variance.
+      //! @param threshold threshold to reject large state innovations.
+      //! @return 0 if update is successful, -1 otherwise.
+      int
+      update(const unsigned* states, const double* h, unsigned count,
+             double innovation, double noise, float threshold);
+
       //! Get filter state value.
       //! @param pos matrix index.
       //! @return state matrix value.
@@ -361,6 +380,49 @@ namespace DUNE
       Math::Matrix m_r;
       //! Innovation vector.
       Math::Matrix m_innov;
+      //! Work area of the prediction step.
+      Math::Matrix m_tmp;
+      //! Product of the covariance and the current observation vector.
+      std::vector<double> m_gain;
+      //! Nonzero entries of the current observation vector.
+      std::vector<unsigned> m_obs_states;
+      std::vector<double> m_obs_values;
+      //! State and covariance before a sequential update.
+      std::vector<double> m_backup;
+
+      //! Propagate state and covariance without control input. The
+      //! products are computed in place, so no matrices are allocated
+      //! once the work area is sized.
+      void
+      propagate(void);
+
+      //! Restore the state and covariance saved before a sequential
+      //! update.
+      void
+      restore(void);
+
+      //! Batch update, used when measurement noises are correlated.
+      //! @param threshold threshold to reject large state innovations.
+      //! @return 0 if update is successful, -1 otherwise.
+      int
+      updateBatch(float threshold);
+
+      //! Compute the covariance of the innovation of a scalar
+      //! observation, leaving P * h' in the gain vector.
+      //! @param states indexes of the observed states.
+      //! @param h observation vector values for each observed state.
+      //! @param count number of observed states.
+      //! @param noise measurement noise variance.
+      //! @return innovation covariance.
+      double
+      project(const unsigned* states, const double* h, unsigned count, double noise);
+
+      //! Correct state and covariance with the gain vector left by
+      //! project().
+      //! @param innovation measurement innovation.
+      //! @param s innovation covariance.
+      void
+      correct(double innovation, double s);
     };
   }
 }
@@ -29,6 +29,7 @@
 
 // ISO C++ 98 headers.
 #include <cstring>
+#include <cerrno>
 #include <sstream>
 #include <iostream>
 #include <fstream>
@@ -91,6 +92,10 @@
 #  include <sys/signal.h>
 #endif
 
+#if defined(DUNE_SYS_HAS_SYS_UIO_H)
+#  include <sys/uio.h>
+#endif
+
 #if defined(DUNE_SYS_HAS_SYS_SENDFILE_H)
 #  include <sys/sendfile.h>
 #endif
@@ -104,6 +109,8 @@
 #endif
 
 static const unsigned c_block_size = 128 * 1024;
+//! Maximum number of buffers in a single gather write.
+static const size_t c_max_iov = 64;
 
 static inline std::string
 getLastErrorMessage(void)
@@ -252,6 +259,55 @@ namespace DUNE
       return static_cast<size_t>(rv);
     }
 
+    size_t
+    TCPSocket::writeNonBlocking(const uint8_t* const* bfrs, const size_t* sizes, size_t count)
+    {
+      if (count == 0)
+        return 0;
+
+      int flags = 0;
+
+#if defined(MSG_NOSIGNAL)
+      flags |= MSG_NOSIGNAL;
+#endif
+
+#if defined(MSG_DONTWAIT)
+      flags |= MSG_DONTWAIT;
+#endif
+
+#if defined(DUNE_SYS_HAS_SENDMSG)
+      iovec iov[c_max_iov];
+      if (count > c_max_iov)
+        count = c_max_iov;
+
+      for (size_t i = 0; i < count; ++i)
+      {
+        iov[i].iov_base = (void*)bfrs[i];
+        iov[i].iov_len = sizes[i];
+      }
+
+      msghdr msg;
+      std::memset(&msg, 0, sizeof(msg));
+      msg.msg_iov = iov;
+      msg.msg_iovlen = count;
+
+      ssize_t rv = ::sendmsg(m_handle, &msg, flags);
+#else
+      ssize_t rv = ::send(m_handle, (const char*)bfrs[0], sizes[0], flags);
+#endif
+
+      if (rv < 0)
+      {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+          return 0;
+        if (errno == EPIPE || errno == ECONNRESET)
+          throw ConnectionClosed();
+        throw NetworkError(DTR("error sending data"), getLastErrorMessage());
+      }
+
+      return static_cast<size_t>(rv);
+    }
+
     void
     TCPSocket::doFlushInput(void)
     {
@@ -77,6 +77,19 @@ namespace DUNE
       bool
       writeFile(const char* filename, int64_t off_end, int64_t off_beg = -1);
 
+      //! Write the contents of several buffers, in order, without
+      //! blocking. On systems without non-blocking sends this call
+      //! may block.
+      //! @param[in] bfrs buffers.
+      //! @param[in] sizes size of each buffer.
+      //! @param[in] count number of buffers.
+      //! @return number of bytes written, zero if the socket cannot
+      //! take more data.
+      //! @throw ConnectionClosed if the connection was closed.
+      //! @throw NetworkError on other errors.
+      size_t
+      writeNonBlocking(const uint8_t* const* bfrs, const size_t* sizes, size_t count);
+
       //! Enable/disable keep-alive messages. When enabled connections
       //! are kept active by periodically transmitting messages.
       //! @param[in] enabled true to enable this feature, false to
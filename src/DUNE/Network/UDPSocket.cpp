@@ -28,7 +28,9 @@
 //***************************************************************************
 
 // ISO C++ 98 headers.
+#include <algorithm>
 #include <cerrno>
+#include <cstring>
 
 // DUNE headers.
 #include <DUNE/Config.hpp>
@@ -93,6 +95,9 @@ namespace DUNE
 {
   namespace Network
   {
+    //! Maximum number of datagrams per system call.
+    static const size_t c_max_batch = 64;
+
     UDPSocket::UDPSocket(void):
       m_con_port(0)
     {
@@ -232,6 +237,148 @@ namespace DUNE
       return rv;
     }
 
+    size_t
+    UDPSocket::writeBatch(const uint8_t* const* bfrs, const size_t* sizes,
+                          const Address* addrs, const uint16_t* ports, size_t count)
+    {
+      size_t sent = 0;
+
+#if defined(DUNE_SYS_HAS_SENDMMSG)
+      mmsghdr msgs[c_max_batch];
+      iovec iovs[c_max_batch];
+      sockaddr_in hosts[c_max_batch];
+      size_t i = 0;
+
+      while (i < count)
+      {
+        size_t n = std::min(count - i, c_max_batch);
+        std::memset(msgs, 0, n * sizeof(mmsghdr));
+        std::memset(hosts, 0, n * sizeof(sockaddr_in));
+
+        for (size_t j = 0; j < n; ++j)
+        {
+          hosts[j].sin_family = AF_INET;
+          hosts[j].sin_port = Utils::ByteCopy::toBE(ports[i + j]);
+          hosts[j].sin_addr.s_addr = addrs[i + j].toInteger();
+          iovs[j].iov_base = (void*)bfrs[i + j];
+          iovs[j].iov_len = sizes[i + j];
+          msgs[j].msg_hdr.msg_name = &hosts[j];
+          msgs[j].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+          msgs[j].msg_hdr.msg_iov = &iovs[j];
+          msgs[j].msg_hdr.msg_iovlen = 1;
+        }
+
+        // Stops at the first datagram that cannot be sent.
+        int rv = ::sendmmsg(m_handle, msgs, n, 0);
+        if (rv > 0)
+        {
+          sent += rv;
+          i += rv;
+        }
+        else
+        {
+          ++i;
+        }
+      }
+#else
+      for (size_t i = 0; i < count; ++i)
+      {
+        try
+        {
+          write(bfrs[i], sizes[i], addrs[i], ports[i]);
+          ++sent;
+        }
+        catch (std::runtime_error&)
+        { }
+      }
+#endif
+
+      return sent;
+    }
+
+    size_t
+    UDPSocket::readBatch(uint8_t* const* bfrs, size_t* sizes,
+                         Address* addrs, uint16_t* ports, size_t count)
+    {
+      if (count == 0)
+        return 0;
+
+#if defined(DUNE_SYS_HAS_RECVMMSG)
+      mmsghdr msgs[c_max_batch];
+      iovec iovs[c_max_batch];
+      sockaddr_in hosts[c_max_batch];
+
+      if (count > c_max_batch)
+        count = c_max_batch;
+
+      std::memset(msgs, 0, count * sizeof(mmsghdr));
+      std::memset(hosts, 0, count * sizeof(sockaddr_in));
+
+      for (size_t i = 0; i < count; ++i)
+      {
+        iovs[i].iov_base = bfrs[i];
+        iovs[i].iov_len = sizes[i];
+        msgs[i].msg_hdr.msg_name = &hosts[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+      }
+
+      int rv = ::recvmmsg(m_handle, msgs, count, MSG_DONTWAIT, NULL);
+      if (rv < 0)
+      {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+          return 0;
+        throw NetworkError(DTR("error receiving data"), DUNE_SOCKET_ERROR);
+      }
+
+      for (int i = 0; i < rv; ++i)
+      {
+        sizes[i] = msgs[i].msg_len;
+
+        if (addrs != NULL)
+          addrs[i] = (::sockaddr*)&hosts[i];
+
+        if (ports != NULL)
+          ports[i] = Utils::ByteCopy::fromBE(hosts[i].sin_port);
+      }
+
+      return rv;
+
+#elif defined(MSG_DONTWAIT)
+      size_t n = 0;
+      for (; n < count; ++n)
+      {
+        sockaddr_in host;
+        socklen_t sock_len = sizeof(host);
+        std::memset((char*)&host, 0, sock_len);
+
+        int rv = recvfrom(m_handle, (char*)bfrs[n], sizes[n], MSG_DONTWAIT,
+                          (::sockaddr*)&host, (::socklen_t*)&sock_len);
+        if (rv < 0)
+        {
+          if (n > 0 || errno == EAGAIN || errno == EWOULDBLOCK)
+            break;
+          throw NetworkError(DTR("error receiving data"), DUNE_SOCKET_ERROR);
+        }
+
+        sizes[n] = rv;
+
+        if (addrs != NULL)
+          addrs[n] = (::sockaddr*)&host;
+
+        if (ports != NULL)
+          ports[n] = Utils::ByteCopy::fromBE(host.sin_port);
+      }
+
+      return n;
+
+#else
+      sizes[0] = read(bfrs[0], sizes[0], addrs, ports);
+      return 1;
+#endif
+    }
+
     void
     UDPSocket::createEventHandle(void)
     {
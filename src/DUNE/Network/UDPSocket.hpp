@@ -97,6 +97,36 @@ namespace DUNE
       size_t
       read(uint8_t* buffer, size_t size, Address* addr = NULL, uint16_t* port = NULL);
 
+      //! Send several UDP datagrams using as few system calls as
+      //! possible. Datagrams that cannot be sent are skipped.
+      //! @param[in] bfrs datagram buffers.
+      //! @param[in] sizes size of each datagram.
+      //! @param[in] addrs destination address of each datagram.
+      //! @param[in] ports destination port of each datagram.
+      //! @param[in] count number of datagrams.
+      //! @return number of datagrams sent.
+      size_t
+      writeBatch(const uint8_t* const* bfrs, const size_t* sizes,
+                 const Address* addrs, const uint16_t* ports, size_t count);
+
+      //! Receive the UDP datagrams that are already queued in the
+      //! socket, up to a maximum number, using as few system calls
+      //! as possible. On systems without non-blocking reads this
+      //! call receives a single datagram and may block.
+      //! @param[in] bfrs destination buffers.
+      //! @param[in,out] sizes capacity of each buffer on input, size
+      //! of each received datagram on output.
+      //! @param[out] addrs source address of each datagram (may be
+      //! NULL).
+      //! @param[out] ports source port of each datagram (may be NULL).
+      //! @param[in] count maximum number of datagrams.
+      //! @return number of datagrams received, zero if none was
+      //! queued.
+      //! @throw NetworkError if no datagram could be received.
+      size_t
+      readBatch(uint8_t* const* bfrs, size_t* sizes,
+                Address* addrs, uint16_t* ports, size_t count);
+
     private:
       //! Platform specific handle.
 #if defined(DUNE_OS_WINDOWS)
@@ -71,6 +71,10 @@
 #  include <sys/mman.h>
 #endif
 
+#if defined(DUNE_SYS_HAS_WINDOWS_H)
+#  include <windows.h>
+#endif
+
 #if defined(DUNE_OS_RTEMS)
 extern "C" int
 getrusage(int who, struct rusage* r_usage);
@@ -225,5 +229,22 @@ namespace DUNE
       (void)length;
 #endif
     }
+
+    unsigned
+    Resources::getProcessorCount(void)
+    {
+#if defined(DUNE_SYS_HAS_UNISTD_H) && defined(_SC_NPROCESSORS_ONLN)
+      long count = sysconf(_SC_NPROCESSORS_ONLN);
+      if (count > 0)
+        return (unsigned)count;
+#elif defined(DUNE_SYS_HAS_WINDOWS_H)
+      SYSTEM_INFO info;
+      GetSystemInfo(&info);
+      if (info.dwNumberOfProcessors > 0)
+        return info.dwNumberOfProcessors;
+#endif
+
+      return 1;
+    }
   }
 }
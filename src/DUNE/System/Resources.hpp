@@ -83,6 +83,11 @@ namespace DUNE
       static void
       unlockMemory(const void* addr, size_t length);
 
+      //! Retrieve the number of processors available.
+      //! @return number of online processors, 1 if unknown.
+      static unsigned
+      getProcessorCount(void);
+
     private:
       //! Last process's CPU time.
       uint64_t m_last_proc_time;
@@ -43,15 +43,46 @@ namespace DUNE
     class AbstractConsumer
     {
     public:
-      AbstractConsumer(void)
+      //! Function used to deliver a message to a consumer.
+      typedef void (*Function)(AbstractConsumer*, const IMC::Message*);
+
+      AbstractConsumer(void):
+        m_function(&AbstractConsumer::dispatch)
       { }
 
       virtual void
       consume(const IMC::Message*) = 0;
 
+      //! Retrieve the function that delivers messages to this
+      //! consumer. Calling it is equivalent to calling consume().
+      //! @return delivery function.
+      Function
+      getFunction(void) const
+      {
+        return m_function;
+      }
+
       virtual
       ~AbstractConsumer(void)
       { }
+
+    protected:
+      //! Constructor used by consumers that know the concrete type of
+      //! their callback and can bypass consume().
+      //! @param function delivery function.
+      AbstractConsumer(Function function):
+        m_function(function)
+      { }
+
+    private:
+      //! Delivery function.
+      Function m_function;
+
+      static void
+      dispatch(AbstractConsumer* consumer, const IMC::Message* msg)
+      {
+        consumer->consume(msg);
+      }
     };
   }
 }
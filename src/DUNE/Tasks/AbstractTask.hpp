@@ -37,6 +37,8 @@
 // DUNE headers.
 #include <DUNE/Concurrency/Thread.hpp>
 #include <DUNE/IMC/Message.hpp>
+#include <DUNE/IMC/SharedMessage.hpp>
+#include <DUNE/IMC/DeliveryStatistics.hpp>
 
 namespace DUNE
 {
@@ -61,6 +63,45 @@ namespace DUNE
       virtual void
       receive(const IMC::Message* msg) = 0;
 
+      //! Queue a shared message for later consumption. The message
+      //! is not copied, so it must not be modified by the caller
+      //! afterwards.
+      //! @param msg message handle.
+      virtual void
+      receive(const IMC::SharedMessage& msg) = 0;
+
+      //! Queue a shared message for later consumption and count it in
+      //! the delivery statistics of the message to the task.
+      //! @param msg message handle.
+      //! @param stats delivery statistics.
+      virtual void
+      receive(const IMC::SharedMessage& msg, IMC::DeliveryStatistics& stats)
+      {
+        stats.enqueued(0);
+        receive(msg);
+      }
+
+      //! Test if the task consumed every queued message and has no
+      //! periodic run due.
+      //! @return true if the task is idle, false otherwise.
+      virtual bool
+      isIdle(void)
+      {
+        return true;
+      }
+
+      //! Wait until the task is idle (see isIdle()).
+      //! @param deadline deadline in nanoseconds of the real
+      //! monotonic clock (Time::Clock::getRealNsec()).
+      //! @return true if the task is idle, false if the deadline was
+      //! reached.
+      virtual bool
+      waitIdle(uint64_t deadline)
+      {
+        (void)deadline;
+        return true;
+      }
+
       //! Retrieve task name.
       //! @return task name.
       virtual const char*
@@ -45,6 +45,7 @@ namespace DUNE
 
       //! Constructor.
       Consumer(T& o, Routine f):
+        AbstractConsumer(&Consumer::call),
         m_obj(o),
         m_fun(f)
       { }
@@ -61,6 +62,15 @@ namespace DUNE
     private:
       T& m_obj;
       Routine m_fun;
+
+      //! Deliver a message without going through the virtual
+      //! consume().
+      static void
+      call(AbstractConsumer* consumer, const IMC::Message* msg)
+      {
+        Consumer* self = static_cast<Consumer*>(consumer);
+        ((self->m_obj).*(self->m_fun))(reinterpret_cast<const M*>(msg));
+      }
     };
   }
 }
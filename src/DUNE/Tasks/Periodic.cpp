@@ -28,49 +28,128 @@
 //***************************************************************************
 
 // ISO C++ 98 headers.
+#include <algorithm>
 #include <iomanip>
 #include <cmath>
 
 // DUNE headers.
 #include <DUNE/IMC/Bus.hpp>
+#include <DUNE/IMC/Factory.hpp>
 #include <DUNE/Tasks/Context.hpp>
 #include <DUNE/Tasks/Periodic.hpp>
 #include <DUNE/Time/Clock.hpp>
+#include <DUNE/Time/Constants.hpp>
 #include <DUNE/Time/Delay.hpp>
 
 namespace DUNE
 {
   namespace Tasks
   {
+    //! Period of jitter reports.
+    static const double c_jitter_report_period = 60.0;
+
     Periodic::Periodic(const std::string& name, Context& ctx):
       Task(name, ctx),
       m_run_count(0),
-      m_run_time(0)
+      m_run_time(0),
+      m_jitter_sum(0),
+      m_jitter_max(0),
+      m_jitter_count(0),
+      m_overruns(0),
+      m_jitter_report(0)
     {
       param(DTR_RT("Execution Frequency"), m_frequency)
       .units(Units::Hertz)
       .defaultValue("1.0")
       .description(DTR("Frequency at which task is executed"));
+
+      param(DTR_RT("Immediate Messages"), m_immediate)
+      .defaultValue("Abort")
+      .description(DTR("Messages that are consumed as soon as they arrive"
+                       " instead of before the next execution"));
+    }
+
+    bool
+    Periodic::waitUntil(double deadline)
+    {
+      setNextRun(deadline);
+
+      // A virtual clock does not follow the monotonic clock.
+      if (Time::Clock::isVirtual())
+      {
+        double now = Time::Clock::get();
+        if (deadline > now)
+          Time::Clock::waitVirtual(deadline - now);
+        return false;
+      }
+
+      return waitForMessagesUntil((uint64_t)(deadline * Time::c_nsec_per_sec_fp));
+    }
+
+    void
+    Periodic::updateJitter(double jitter, double period)
+    {
+      m_jitter_sum += jitter;
+      m_jitter_max = std::max(m_jitter_max, jitter);
+      ++m_jitter_count;
+
+      if (jitter >= period)
+        ++m_overruns;
+
+      if (m_run_time - m_jitter_report < c_jitter_report_period)
+        return;
+
+      debug("jitter: mean %0.6f s, max %0.6f s, %u overruns in %u runs",
+            getJitterMean(), m_jitter_max, m_overruns, m_jitter_count);
+
+      m_jitter_sum = 0;
+      m_jitter_max = 0;
+      m_jitter_count = 0;
+      m_overruns = 0;
+      m_jitter_report = m_run_time;
     }
 
     void
     Periodic::onMain(void)
     {
+      // Only messages that are consumed immediately interrupt waits.
+      std::vector<uint32_t> ids;
+      for (size_t i = 0; i < m_immediate.size(); ++i)
+      {
+        try
+        {
+          ids.push_back(IMC::Factory::getIdFromAbbrev(m_immediate[i]));
+        }
+        catch (...)
+        {
+          war(DTR("unknown message '%s'"), m_immediate[i].c_str());
+        }
+      }
+      setWakeMessages(ids);
+
       double now = Time::Clock::get();
       double delay = (1 / m_frequency);
       double next_inv = now + delay;
       m_run_time = now;
+      m_jitter_report = now;
 
       while (!stopping())
       {
         delay = (1.0 / m_frequency);
 
         if (next_inv > now)
-          Time::Delay::wait(next_inv - now);
+        {
+          if (waitUntil(next_inv))
+            consumeMessages();
+
+          now = Time::Clock::get();
+          if (next_inv > now)
+            continue;
+        }
 
-        next_inv += delay;
-        now = Time::Clock::get();
         m_run_time = now;
+        updateJitter(now - next_inv, delay);
+        next_inv += delay;
 
         // Perform job.
         consumeMessages();
@@ -95,6 +95,33 @@ namespace DUNE
         return m_run_count;
       }
 
+      //! Retrieve the mean delay between the scheduled and the actual
+      //! start of runs since the last report.
+      //! @return mean jitter in seconds.
+      inline double
+      getJitterMean(void) const
+      {
+        return (m_jitter_count == 0) ? 0.0 : m_jitter_sum / m_jitter_count;
+      }
+
+      //! Retrieve the maximum delay between the scheduled and the
+      //! actual start of runs since the last report.
+      //! @return maximum jitter in seconds.
+      inline double
+      getJitterMax(void) const
+      {
+        return m_jitter_max;
+      }
+
+      //! Retrieve the number of runs that started one period or more
+      //! late since the last report.
+      //! @return number of overruns.
+      inline unsigned
+      getOverrunCount(void) const
+      {
+        return m_overruns;
+      }
+
       //! The task to be executed on each cycle.
       virtual void
       task(void) = 0;
@@ -106,6 +133,31 @@ namespace DUNE
       double m_run_time;
       //! Task frequency (Hz).
       double m_frequency;
+      //! Messages consumed as soon as they arrive.
+      std::vector<std::string> m_immediate;
+      //! Sum of the jitter of runs.
+      double m_jitter_sum;
+      //! Maximum jitter of runs.
+      double m_jitter_max;
+      //! Number of runs in jitter statistics.
+      unsigned m_jitter_count;
+      //! Number of runs that started one period or more late.
+      unsigned m_overruns;
+      //! Time of the last jitter report.
+      double m_jitter_report;
+
+      //! Wait for the next run or for messages that are consumed
+      //! as soon as they arrive.
+      //! @param[in] deadline time of the next run.
+      //! @return true if messages arrived before the deadline.
+      bool
+      waitUntil(double deadline);
+
+      //! Update jitter statistics and report them periodically.
+      //! @param[in] jitter delay of the current run.
+      //! @param[in] period task period.
+      void
+      updateJitter(double jitter, double period);
 
       //! Task entry point.
       void
@@ -28,11 +28,15 @@
 //***************************************************************************
 
 // ISO C++ 98 headers.
+#include <algorithm>
 #include <cstddef>
 
 // DUNE headers.
+#include <DUNE/I18N.hpp>
+#include <DUNE/Concurrency/ScopedMutex.hpp>
 #include <DUNE/IMC/Bus.hpp>
 #include <DUNE/IMC/Factory.hpp>
+#include <DUNE/Time/Clock.hpp>
 #include <DUNE/Tasks/Context.hpp>
 #include <DUNE/Tasks/Recipient.hpp>
 
@@ -40,21 +44,34 @@ namespace DUNE
 {
   namespace Tasks
   {
+    //! Maximum time a blocked producer waits before checking the
+    //! inbox again.
+    static const double c_overflow_block_period = 0.1;
+    //! Minimum time between reports of discarded messages.
+    static const double c_drops_report_period = 10.0;
+    //! Size of the bitmap of messages that wake up the task, enough
+    //! for all message identification numbers.
+    static const size_t c_wake_filter_words = 65536 / 32;
+
     Recipient::Recipient(AbstractTask* task, Context& ctx):
       m_task(task),
-      m_ctx(ctx)
-    { }
+      m_ctx(ctx),
+      m_mqueue(NULL),
+      m_next_run(-1.0),
+      m_policy(OVERFLOW_DROP_OLDEST),
+      m_drops_reported(0),
+      m_drops_report_time(0),
+      m_reactor(NULL),
+      m_wake_filter(NULL)
+    {
+      m_mqueue = new Concurrency::LockFreeQueue<IMC::SharedMessage>(c_default_capacity);
+    }
 
     Recipient::~Recipient(void)
     {
       unbindAll();
-
-      while (!m_mqueue.empty())
-      {
-        IMC::Message* msg = m_mqueue.pop();
-        if (msg)
-          delete msg;
-      }
+      delete m_mqueue;
+      delete [] m_wake_filter;
     }
 
     void
@@ -71,6 +88,15 @@ namespace DUNE
 
         itr->second.clear();
       }
+
+      m_cbacks.clear();
+
+      {
+        Concurrency::ScopedMutex l(m_delivery_lock);
+        m_delivery.clear();
+      }
+
+      compile();
     }
 
     void
@@ -78,40 +104,326 @@ namespace DUNE
     {
       std::map<uint32_t, std::vector<AbstractConsumer*> >::iterator itr = m_cbacks.find(id);
       if (itr == m_cbacks.end())
-        m_ctx.mbus.registerRecipient(m_task, id);
+      {
+        IMC::DeliveryStatistics* stats = m_ctx.mbus.registerRecipient(m_task, id);
+        Concurrency::ScopedMutex l(m_delivery_lock);
+        m_delivery[id] = stats;
+      }
 
       m_cbacks[id].push_back(consumer);
+      compile();
+    }
+
+    void
+    Recipient::compile(void)
+    {
+      // The offset table never shrinks, so that it stays valid for
+      // consumers that bind or unbind while callbacks are running.
+      size_t size = m_offsets.size();
+      if (!m_cbacks.empty())
+        size = std::max(size, (size_t)m_cbacks.rbegin()->first + 2);
+
+      std::vector<CallBack> table;
+      std::vector<uint32_t> offsets(size, 0);
+      std::vector<IMC::DeliveryStatistics*> stats(size, NULL);
+
+      {
+        Concurrency::ScopedMutex l(m_delivery_lock);
+        std::map<uint32_t, IMC::DeliveryStatistics*>::iterator sitr = m_delivery.begin();
+        for (; sitr != m_delivery.end(); ++sitr)
+          stats[sitr->first] = sitr->second;
+      }
+
+      std::map<uint32_t, std::vector<AbstractConsumer*> >::iterator itr = m_cbacks.begin();
+      for (uint32_t id = 0; id + 1 < size; ++id)
+      {
+        if (itr != m_cbacks.end() && itr->first == id)
+        {
+          for (size_t i = 0; i < itr->second.size(); ++i)
+          {
+            CallBack cb;
+            cb.consumer = itr->second[i];
+            cb.function = itr->second[i]->getFunction();
+            table.push_back(cb);
+          }
+
+          ++itr;
+        }
+
+        offsets[id + 1] = table.size();
+      }
+
+      m_table.swap(table);
+      m_offsets.swap(offsets);
+      m_stats.swap(stats);
+    }
+
+    void
+    Recipient::setCapacity(size_t capacity)
+    {
+      if (capacity == m_mqueue->capacity())
+        return;
+
+      Concurrency::LockFreeQueue<IMC::SharedMessage>* old = m_mqueue;
+      m_mqueue = new Concurrency::LockFreeQueue<IMC::SharedMessage>(capacity);
+
+      IMC::SharedMessage msg;
+      while (old->pop(msg))
+        m_unconsumed.sub(1);
+
+      delete old;
     }
 
     void
     Recipient::waitForMessages(double timeout)
     {
-      if (m_mqueue.waitForItems(timeout))
+      if (m_mqueue->empty())
+      {
+        m_ready.prepareWait();
+
+        if (m_mqueue->empty())
+          m_ready.wait(timeout);
+        else
+          m_ready.cancelWait();
+      }
+
+      if (!m_mqueue->empty())
         runCallBacks();
     }
 
+    bool
+    Recipient::waitUntil(uint64_t deadline)
+    {
+      if (m_pending.add(0) == 0)
+      {
+        m_ready.prepareWait();
+
+        if (m_pending.add(0) == 0)
+          m_ready.waitUntil(deadline);
+        else
+          m_ready.cancelWait();
+      }
+
+      return m_pending.add(0) > 0;
+    }
+
+    bool
+    Recipient::isIdle(void)
+    {
+      if (m_wake_filter != NULL)
+      {
+        if (m_pending.add(0) > 0)
+          return false;
+      }
+      else if (m_unconsumed.add(0) > 0)
+      {
+        return false;
+      }
+
+      Concurrency::ScopedMutex l(m_next_run_lock);
+      return m_next_run < 0 || m_next_run > Time::Clock::get();
+    }
+
+    bool
+    Recipient::waitIdle(uint64_t deadline)
+    {
+      while (!isIdle())
+      {
+        m_idle.prepareWait();
+
+        if (isIdle())
+        {
+          m_idle.cancelWait();
+          break;
+        }
+
+        if (!m_idle.waitUntil(deadline))
+          return isIdle();
+      }
+
+      return true;
+    }
+
+    void
+    Recipient::setNextRun(double time)
+    {
+      {
+        Concurrency::ScopedMutex l(m_next_run_lock);
+        m_next_run = time;
+      }
+
+      m_idle.signal();
+    }
+
+    void
+    Recipient::setWakeFilter(const std::vector<uint32_t>& ids)
+    {
+      // The bitmap is never reallocated, so producers can read it
+      // while it is updated.
+      uint32_t* filter = m_wake_filter;
+      if (filter == NULL)
+        filter = new uint32_t[c_wake_filter_words];
+
+      for (size_t i = 0; i < c_wake_filter_words; ++i)
+        filter[i] = 0;
+
+      for (size_t i = 0; i < ids.size(); ++i)
+      {
+        if (ids[i] < c_wake_filter_words * 32)
+          filter[ids[i] / 32] |= 1u << (ids[i] % 32);
+      }
+
+      m_wake_filter = filter;
+    }
+
     void
     Recipient::put(const IMC::Message* msg)
     {
-      m_mqueue.push(msg->clone());
+      put(IMC::SharedMessage::copy(msg));
+    }
+
+    void
+    Recipient::put(const IMC::SharedMessage& msg, IMC::DeliveryStatistics* stats)
+    {
+      m_unconsumed.add(1);
+
+      if (!m_mqueue->push(msg))
+        overflow(msg);
+
+      if (stats != NULL)
+        stats->enqueued(m_mqueue->size());
+
+      uint32_t* filter = m_wake_filter;
+      if (filter != NULL)
+      {
+        uint32_t id = msg->getId();
+        if (id >= c_wake_filter_words * 32 || (filter[id / 32] & (1u << (id % 32))) == 0)
+          return;
+      }
+
+      m_pending.add(1);
+      m_ready.signal();
+
+      IO::Reactor* reactor = m_reactor;
+      if (reactor != NULL)
+        reactor->wakeup();
+    }
+
+    void
+    Recipient::overflow(const IMC::SharedMessage& msg)
+    {
+      switch (m_policy)
+      {
+        case OVERFLOW_DROP_NEWEST:
+          drop(msg);
+          break;
+
+        case OVERFLOW_DROP_OLDEST:
+          {
+            IMC::SharedMessage oldest;
+            while (!m_mqueue->push(msg))
+            {
+              if (m_mqueue->pop(oldest))
+                drop(oldest);
+            }
+          }
+          break;
+
+        case OVERFLOW_BLOCK:
+          while (!m_mqueue->push(msg))
+          {
+            // A task that is stopping will not make room anymore.
+            if (m_task->isStopping() || m_task->isDead())
+            {
+              drop(msg);
+              break;
+            }
+
+            m_room.prepareWait();
+
+            if (m_mqueue->push(msg))
+            {
+              m_room.cancelWait();
+              break;
+            }
+
+            m_ready.signal();
+            if (m_reactor != NULL)
+              m_reactor->wakeup();
+
+            m_room.wait(c_overflow_block_period);
+          }
+          break;
+      }
+    }
+
+    void
+    Recipient::drop(const IMC::SharedMessage& msg)
+    {
+      m_drops.add(1);
+      m_unconsumed.sub(1);
+
+      // Only reached when the inbox is full, the lock is not taken
+      // in the common path.
+      Concurrency::ScopedMutex l(m_delivery_lock);
+      std::map<uint32_t, IMC::DeliveryStatistics*>::iterator itr = m_delivery.find(msg->getId());
+      if (itr != m_delivery.end())
+        itr->second->dropped();
+    }
+
+    void
+    Recipient::reportDrops(void)
+    {
+      unsigned drops = (unsigned)m_drops.add(0);
+      if (drops == m_drops_reported)
+        return;
+
+      double now = Time::Clock::getReal();
+      if (m_drops_reported != 0 && (now - m_drops_report_time) < c_drops_report_period)
+        return;
+
+      m_task->war(DTR("inbox full, %u messages discarded"), drops - m_drops_reported);
+      m_drops_reported = drops;
+      m_drops_report_time = now;
     }
 
     void
     Recipient::runCallBacks(void)
     {
-      unsigned int size = m_mqueue.size();
+      reportDrops();
 
-      for (unsigned int i = 0; i < size; ++i)
+      // Consumers may wait for messages themselves, so the batch
+      // buffer is taken out of the object while it is in use.
+      std::vector<IMC::SharedMessage> batch;
+      batch.swap(m_batch);
+
+      m_pending.sub(m_pending.add(0));
+
+      m_mqueue->pop(batch, m_mqueue->size());
+      m_room.signal();
+
+      for (size_t i = 0; i < batch.size(); ++i)
       {
-        const IMC::Message* msg = m_mqueue.pop();
-        if (msg)
+        const IMC::Message* msg = batch[i].get();
+        uint32_t id = msg->getId();
+        if (id + 1 >= m_offsets.size())
+          continue;
+
+        if (m_stats[id] != NULL)
+          m_stats[id]->dequeued(Time::Clock::getRealNsec() - batch[i].getCreationTime());
+
+        for (uint32_t j = m_offsets[id]; j < m_offsets[id + 1]; ++j)
         {
-          uint32_t id = msg->getId();
-          for (size_t j = 0; j < m_cbacks[id].size(); ++j)
-            m_cbacks[id][j]->consume(msg);
-          delete msg;
+          CallBack cb = m_table[j];
+          cb.function(cb.consumer, msg);
         }
       }
+
+      m_unconsumed.sub(batch.size());
+      m_idle.signal();
+
+      batch.clear();
+      batch.swap(m_batch);
     }
   }
 }
@@ -35,7 +35,13 @@
 #include <vector>
 
 // DUNE headers.
-#include <DUNE/Concurrency/TSQueue.hpp>
+#include <DUNE/Concurrency/AtomicCounter.hpp>
+#include <DUNE/Concurrency/Event.hpp>
+#include <DUNE/Concurrency/LockFreeQueue.hpp>
+#include <DUNE/Concurrency/Mutex.hpp>
+#include <DUNE/IMC/SharedMessage.hpp>
+#include <DUNE/IMC/DeliveryStatistics.hpp>
+#include <DUNE/IO/Reactor.hpp>
 #include <DUNE/Tasks/Consumer.hpp>
 #include <DUNE/Tasks/AbstractTask.hpp>
 
@@ -52,6 +58,27 @@ namespace DUNE
     class Recipient
     {
     public:
+      //! What to do when a message arrives and the inbox is full.
+      enum OverflowPolicy
+      {
+        //! Discard the oldest queued message.
+        OVERFLOW_DROP_OLDEST,
+        //! Discard the incoming message.
+        OVERFLOW_DROP_NEWEST,
+        //! Block the producer until there is room, or discard the
+        //! incoming message if the task is stopping. Producers include
+        //! every task dispatching the message, so no task defaults to
+        //! this policy, it must be selected by the configuration.
+        //! Consumers may bind and unbind messages while producers are
+        //! blocked, but two tasks using this policy must not dispatch
+        //! to each other from their callbacks, since each could wait
+        //! for the other.
+        OVERFLOW_BLOCK
+      };
+
+      //! Default inbox capacity.
+      static const size_t c_default_capacity = 1024;
+
       //! Constructor.
       Recipient(AbstractTask* task, Context& ctx);
 
@@ -61,8 +88,17 @@ namespace DUNE
       void
       unbindAll(void);
 
+      //! Queue a private copy of a message.
+      //! @param msg message object.
+      void
+      put(const IMC::Message* msg);
+
+      //! Queue a shared message without copying it.
+      //! @param msg message handle.
+      //! @param stats delivery statistics that count the message and
+      //! the depth of the queue, may be NULL.
       void
-      put(const IMC::Message*);
+      put(const IMC::SharedMessage& msg, IMC::DeliveryStatistics* stats = NULL);
 
       void
       bind(uint32_t id, AbstractConsumer* c);
@@ -70,18 +106,186 @@ namespace DUNE
       void
       waitForMessages(double timeout);
 
+      //! Wait until a message that wakes up the task is queued or
+      //! until a deadline, without consuming messages.
+      //! @param deadline deadline in nanoseconds of the real
+      //! monotonic clock (Time::Clock::getRealNsec()).
+      //! @return true if such a message was queued, false if the
+      //! deadline was reached.
+      bool
+      waitUntil(uint64_t deadline);
+
+      //! Select the messages that wake up the task when queued. Other
+      //! messages are still queued, but are only consumed when the
+      //! task wakes up for other reasons.
+      //! @param ids identification numbers of the messages that wake
+      //! up the task.
+      void
+      setWakeFilter(const std::vector<uint32_t>& ids);
+
       void
       runCallBacks(void);
 
+      //! Test if every queued message was consumed and the next run
+      //! of the task, if any, is due after the current time. Tasks
+      //! with a wake filter are idle once the messages that wake them
+      //! up were consumed, others are consumed on their next run.
+      //! @return true if the task is idle, false otherwise.
+      bool
+      isIdle(void);
+
+      //! Wait until the task is idle (see isIdle()). Only one thread
+      //! may wait at a time.
+      //! @param deadline deadline in nanoseconds of the real
+      //! monotonic clock (Time::Clock::getRealNsec()).
+      //! @return true if the task is idle, false if the deadline was
+      //! reached.
+      bool
+      waitIdle(uint64_t deadline);
+
+      //! Set the time of the next run of a task that runs
+      //! periodically.
+      //! @param time time in seconds (Time::Clock::get()).
+      void
+      setNextRun(double time);
+
+      //! Change the maximum number of queued messages. Queued
+      //! messages are discarded, so this must only be called before
+      //! the task starts receiving messages.
+      //! @param capacity maximum number of queued messages.
+      void
+      setCapacity(size_t capacity);
+
+      //! Retrieve the maximum number of queued messages.
+      //! @return inbox capacity.
+      size_t
+      getCapacity(void) const
+      {
+        return m_mqueue->capacity();
+      }
+
+      //! Change the overflow policy.
+      //! @param policy overflow policy.
+      void
+      setOverflowPolicy(OverflowPolicy policy)
+      {
+        m_policy = policy;
+      }
+
+      //! Retrieve the overflow policy.
+      //! @return overflow policy.
+      OverflowPolicy
+      getOverflowPolicy(void) const
+      {
+        return m_policy;
+      }
+
+      //! Wake up a reactor whenever a message is queued, so that a
+      //! task waiting for I/O can consume messages without polling.
+      //! @param reactor reactor or NULL to disable.
+      void
+      setReactor(IO::Reactor* reactor)
+      {
+        m_reactor = reactor;
+      }
+
+      //! Retrieve the number of messages discarded because the inbox
+      //! was full.
+      //! @return number of discarded messages.
+      unsigned
+      getDropCount(void)
+      {
+        return (unsigned)m_drops.add(0);
+      }
+
     private:
       //! Task.
       AbstractTask* m_task;
       //! Context.
       Context& m_ctx;
+      //! Bound callback, resolved when it is bound.
+      struct CallBack
+      {
+        //! Consumer object.
+        AbstractConsumer* consumer;
+        //! Function that delivers messages to the consumer.
+        AbstractConsumer::Function function;
+      };
+
       //! Callbacks.
       std::map<uint32_t, std::vector<AbstractConsumer*> > m_cbacks;
+      //! Callbacks of all bound messages, grouped by message
+      //! identification number.
+      std::vector<CallBack> m_table;
+      //! Callbacks of message id are m_table[m_offsets[id]] up to,
+      //! but not including, m_table[m_offsets[id + 1]].
+      std::vector<uint32_t> m_offsets;
+      //! Delivery statistics of bound messages.
+      std::map<uint32_t, IMC::DeliveryStatistics*> m_delivery;
+      //! Lock for delivery statistics of bound messages, which are
+      //! also used by producers to count discarded messages.
+      Concurrency::Mutex m_delivery_lock;
+      //! Delivery statistics indexed by message identification number.
+      std::vector<IMC::DeliveryStatistics*> m_stats;
       //! Message queue.
-      Concurrency::TSQueue<IMC::Message*> m_mqueue;
+      Concurrency::LockFreeQueue<IMC::SharedMessage>* m_mqueue;
+      //! Signalled when messages are queued.
+      Concurrency::Event m_ready;
+      //! Signalled when messages are removed from the queue.
+      Concurrency::Event m_room;
+      //! Signalled when messages were consumed or the next run of
+      //! the task changed.
+      Concurrency::Event m_idle;
+      //! Number of queued messages not consumed yet.
+      Concurrency::AtomicCounter m_unconsumed;
+      //! Time of the next periodic run, negative if none.
+      double m_next_run;
+      //! Lock for the time of the next periodic run.
+      Concurrency::Mutex m_next_run_lock;
+      //! Overflow policy.
+      volatile OverflowPolicy m_policy;
+      //! Number of discarded messages.
+      Concurrency::AtomicCounter m_drops;
+      //! Number of discarded messages already reported.
+      unsigned m_drops_reported;
+      //! Time of the last report of discarded messages.
+      double m_drops_report_time;
+      //! Reactor woken up when messages are queued.
+      IO::Reactor* volatile m_reactor;
+      //! Number of queued messages that wake up the task since the
+      //! last time messages were consumed.
+      Concurrency::AtomicCounter m_pending;
+      //! Bitmap of the messages that wake up the task, NULL if all
+      //! messages do.
+      uint32_t* volatile m_wake_filter;
+      //! Batch of messages being consumed.
+      std::vector<IMC::SharedMessage> m_batch;
+
+      //! Rebuild the callback table from the bound consumers.
+      void
+      compile(void);
+
+      //! Handle a message that does not fit in the queue.
+      //! @param msg message handle.
+      void
+      overflow(const IMC::SharedMessage& msg);
+
+      //! Count a discarded message.
+      //! @param msg message handle.
+      void
+      drop(const IMC::SharedMessage& msg);
+
+      //! Warn about messages discarded since the last report, at most
+      //! once per report period.
+      void
+      reportDrops(void);
+
+      //! Non-copyable.
+      Recipient(const Recipient&);
+
+      //! Non-assignable.
+      Recipient&
+      operator=(const Recipient&);
     };
   }
 }
@@ -36,9 +36,16 @@ namespace DUNE
 {
   namespace Tasks
   {
+    //! Reception timeout when messages are only consumed between
+    //! receptions.
+    static const double c_poll_timeout = 0.005;
+    //! Reception timeout when messages interrupt receptions.
+    static const double c_reactor_timeout = 1.0;
+
     SimpleTransport::SimpleTransport(const std::string& name, Tasks::Context& ctx):
       Tasks::Task(name, ctx),
-      m_buf(2048)
+      m_buf(2048),
+      m_reactor(NULL)
     {
       param("Transports", m_gargs.transports)
       .defaultValue("")
@@ -58,10 +65,32 @@ namespace DUNE
       param("Trace - Outgoing Messages", m_gargs.trace_out)
       .defaultValue("false")
       .description("Enable verbose output regarding outgoing messages");
+
+      param("Keep Raw Frames", m_gargs.raw_frames)
+      .defaultValue("false")
+      .description("Attach the received bytes to incoming messages so that"
+                   " forwarding transports and logging reuse them instead"
+                   " of serializing the messages again. Costs one copy per"
+                   " message");
     }
 
     SimpleTransport::~SimpleTransport(void)
-    { }
+    {
+      wakeOnMessages(NULL);
+      delete m_reactor;
+    }
+
+    IO::Reactor&
+    SimpleTransport::getReactor(void)
+    {
+      if (m_reactor == NULL)
+      {
+        m_reactor = new IO::Reactor;
+        wakeOnMessages(m_reactor);
+      }
+
+      return *m_reactor;
+    }
 
     void
     SimpleTransport::consume(const IMC::Message* msg)
@@ -69,6 +98,17 @@ namespace DUNE
       if (m_rl.filter(msg))
         return;
 
+      if (m_gargs.trace_out)
+        inf(DTR("outgoing: %s"), msg->getName());
+
+      // Forward the bytes the message was received with, if any.
+      const IMC::RawFrame& frame = msg->getRawFrame();
+      if (!frame.isNull())
+      {
+        onDataTransmission(frame.getData(), frame.getSize());
+        return;
+      }
+
       unsigned int n = msg->getSerializationSize();
 
       m_buf.grow(n);
@@ -77,9 +117,6 @@ namespace DUNE
 
       IMC::Packet::serialize(msg, p, n);
 
-      if (m_gargs.trace_out)
-        inf(DTR("outgoing: %s"), msg->getName());
-
       onDataTransmission(p, n);
     }
 
@@ -94,27 +131,27 @@ namespace DUNE
       {
         consumeMessages();
 
-        onDataReception(m_buf.getBuffer(), m_buf.getCapacity(), 0.005);
+        double timeout = (m_reactor == NULL) ? c_poll_timeout : c_reactor_timeout;
+        onDataReception(m_buf.getBuffer(), m_buf.getCapacity(), timeout);
       }
     }
 
     void
     SimpleTransport::handleData(IMC::Parser& parser, const uint8_t* p, unsigned int n)
     {
-      for (const uint8_t* e = p + n; p != e; ++p)
-      {
-        IMC::Message* m = parser.parse(*p);
+      parser.setRawFrames(m_gargs.raw_frames);
+      parser.parse(p, n, this, &SimpleTransport::handleMessage);
+    }
 
-        if (m)
-        {
-          dispatch(m, DF_KEEP_TIME | DF_KEEP_SRC_EID);
+    void
+    SimpleTransport::handleMessage(IMC::Message* m)
+    {
+      dispatch(m, DF_KEEP_TIME | DF_KEEP_SRC_EID);
 
-          if (m_gargs.trace_in)
-            inf(DTR("incoming: %s"), m->getName());
+      if (m_gargs.trace_in)
+        inf(DTR("incoming: %s"), m->getName());
 
-          delete m;
-        }
-      }
+      delete m;
     }
   }
 }
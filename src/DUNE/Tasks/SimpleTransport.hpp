@@ -36,6 +36,7 @@
 // DUNE headers.
 #include <DUNE/Config.hpp>
 #include <DUNE/Utils/ByteBuffer.hpp>
+#include <DUNE/IO/Reactor.hpp>
 #include <DUNE/IMC/Parser.hpp>
 #include <DUNE/Tasks/Task.hpp>
 #include <DUNE/Tasks/MessageFilter.hpp>
@@ -70,6 +71,15 @@ namespace DUNE
       void
       handleData(IMC::Parser& parser, const uint8_t* p, unsigned int n);
 
+    protected:
+      //! Retrieve the reactor onDataReception() should wait on,
+      //! creating it on first use. Incoming messages interrupt its
+      //! waits, so onDataReception() is then called with a long
+      //! timeout instead of polling.
+      //! @return reactor.
+      IO::Reactor&
+      getReactor(void);
+
     private:
       struct GArguments
       {
@@ -83,10 +93,19 @@ namespace DUNE
         bool trace_in;
         // Trace outgoing messages.
         bool trace_out;
+        // Attach received frames to incoming messages.
+        bool raw_frames;
       };
       GArguments m_gargs;
       Utils::ByteBuffer m_buf;
       MessageFilter m_rl;
+      //! Reactor woken up by incoming messages.
+      IO::Reactor* m_reactor;
+
+      //! Dispatch a message received from the transport.
+      //! @param m message, deleted after being dispatched.
+      void
+      handleMessage(IMC::Message* m);
     };
   }
 }
@@ -88,6 +88,18 @@ namespace DUNE
       .defaultValue("None")
       .values("None, Debug, Trace, Spew");
 
+      param(DTR_RT("Inbox Capacity"), m_args.inbox_capacity)
+      .visibility(Parameter::VISIBILITY_DEVELOPER)
+      .defaultValue(uncastLexical(Recipient::c_default_capacity))
+      .minimumValue("16")
+      .description(DTR("Maximum number of messages waiting to be consumed"));
+
+      param(DTR_RT("Inbox Overflow Policy"), m_args.inbox_policy)
+      .visibility(Parameter::VISIBILITY_DEVELOPER)
+      .defaultValue("Drop Oldest")
+      .values("Drop Oldest, Drop Newest, Block")
+      .description(DTR("Action taken when a message arrives and the inbox is full"));
+
       m_recipient = new Recipient(this, ctx);
       m_entity = new Entities::StatefulEntity(this, m_ctx);
       m_entities.push_back(m_entity);
@@ -220,6 +232,13 @@ namespace DUNE
       .description(DTR("True to activate task, false otherwise"));
     }
 
+    void
+    Task::setInboxDefaults(unsigned capacity, const std::string& policy)
+    {
+      m_params.find(DTR_RT("Inbox Capacity"))->second->defaultValue(uncastLexical(capacity));
+      m_params.find(DTR_RT("Inbox Overflow Policy"))->second->defaultValue(policy);
+    }
+
     void
     Task::updateParameters(bool act_deact)
     {
@@ -239,6 +258,22 @@ namespace DUNE
       else
         m_debug_level = DEBUG_LEVEL_NONE;
 
+      if (m_args.inbox_policy == "Drop Newest")
+        m_recipient->setOverflowPolicy(Recipient::OVERFLOW_DROP_NEWEST);
+      else if (m_args.inbox_policy == "Block")
+        m_recipient->setOverflowPolicy(Recipient::OVERFLOW_BLOCK);
+      else
+        m_recipient->setOverflowPolicy(Recipient::OVERFLOW_DROP_OLDEST);
+
+      if (paramChanged(m_args.inbox_capacity))
+      {
+        // The inbox can only be replaced before messages start flowing.
+        if (!isCreated())
+          m_recipient->setCapacity(m_args.inbox_capacity);
+        else
+          war(DTR("inbox capacity change requires a restart"));
+      }
+
       onUpdateParameters();
 
       if (m_honours_active)
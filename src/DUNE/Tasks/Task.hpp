@@ -336,6 +336,32 @@ namespace DUNE
         m_recipient->put(msg);
       }
 
+      //! Add shared message to the message queue.
+      //! @param msg message handle.
+      void
+      receive(const IMC::SharedMessage& msg)
+      {
+        m_recipient->put(msg);
+      }
+
+      void
+      receive(const IMC::SharedMessage& msg, IMC::DeliveryStatistics& stats)
+      {
+        m_recipient->put(msg, &stats);
+      }
+
+      bool
+      isIdle(void)
+      {
+        return m_recipient->isIdle();
+      }
+
+      bool
+      waitIdle(uint64_t deadline)
+      {
+        return m_recipient->waitIdle(deadline);
+      }
+
       //! Instruct task to reserve all entity identifiers that it
       //! needs for normal execution.
       void
@@ -504,6 +530,46 @@ namespace DUNE
         m_recipient->runCallBacks();
       }
 
+      //! Interrupt waits of a reactor whenever a message is queued.
+      //! Tasks that wait for I/O on the reactor can then consume
+      //! messages as soon as they arrive.
+      //! @param[in] reactor reactor or NULL to stop waking it up.
+      void
+      wakeOnMessages(IO::Reactor* reactor)
+      {
+        m_recipient->setReactor(reactor);
+      }
+
+      //! Wait until a message that wakes up the task is queued or
+      //! until a deadline, without consuming messages.
+      //! @param[in] deadline deadline in nanoseconds of the real
+      //! monotonic clock (Time::Clock::getRealNsec()).
+      //! @return true if such a message was queued, false if the
+      //! deadline was reached.
+      bool
+      waitForMessagesUntil(uint64_t deadline)
+      {
+        return m_recipient->waitUntil(deadline);
+      }
+
+      //! Select the messages that wake up the task when queued. By
+      //! default all messages do.
+      //! @param[in] ids identification numbers of the messages.
+      void
+      setWakeMessages(const std::vector<uint32_t>& ids)
+      {
+        m_recipient->setWakeFilter(ids);
+      }
+
+      //! Announce the next run of a task that runs periodically, so
+      //! that the task is not idle once that time is reached.
+      //! @param[in] time time in seconds (Time::Clock::get()).
+      void
+      setNextRun(double time)
+      {
+        m_recipient->setNextRun(time);
+      }
+
       //! Declare a configuration parameter that can be parsed using
       //! the basic parameter parser.
       //! @tparam T type of the destination variable.
@@ -551,6 +617,15 @@ namespace DUNE
                   Parameter::Visibility def_visibility,
                   bool def_value = false);
 
+      //! Change the defaults of parameters 'Inbox Capacity' and 'Inbox
+      //! Overflow Policy', for tasks that must not lose messages.
+      //! Must be called in the constructor of the task.
+      //! @param[in] capacity maximum number of queued messages.
+      //! @param[in] policy one of "Drop Oldest", "Drop Newest" or
+      //! "Block".
+      void
+      setInboxDefaults(unsigned capacity, const std::string& policy);
+
       //! Set the name of the parameter editor that should be used to
       //! interact with the parameters of the task.
       //! @param[in] name editor name (free-form string).
@@ -774,6 +849,10 @@ namespace DUNE
         std::string active_scope;
         //! Visibility of 'Active' parameter.
         std::string active_visibility;
+        //! Maximum number of queued messages.
+        unsigned inbox_capacity;
+        //! Inbox overflow policy.
+        std::string inbox_policy;
       };
 
       //! Message recipient (queue).
@@ -37,6 +37,8 @@
 #include <DUNE/Time/Constants.hpp>
 #include <DUNE/Time/Clock.hpp>
 #include <DUNE/System/Error.hpp>
+#include <DUNE/Concurrency/Condition.hpp>
+#include <DUNE/Concurrency/ScopedCondition.hpp>
 
 // Platform headers.
 #if defined(DUNE_SYS_HAS_SYS_TIME_H)
@@ -55,8 +57,102 @@ namespace DUNE
 {
   namespace Time
   {
+    //! Virtual clock modes.
+    enum VirtualMode
+    {
+      //! Virtual clock inactive.
+      VM_NONE,
+      //! Virtual clock runs at a multiple of the real clock.
+      VM_SCALED,
+      //! Virtual clock only advances on request.
+      VM_STEPPED
+    };
+
+    //! Virtual clock state.
+    struct VirtualClock
+    {
+      //! Protects the state and signals changes.
+      Concurrency::Condition cond;
+      //! Current mode.
+      volatile int mode;
+      //! Rate relative to the real clock.
+      double speed;
+      //! Real monotonic time of the last anchor.
+      uint64_t real;
+      //! Virtual monotonic time at the last anchor.
+      uint64_t mono;
+      //! Virtual time since the epoch at the last anchor.
+      uint64_t epoch;
+
+      VirtualClock(void):
+        mode(VM_NONE),
+        speed(1.0),
+        real(0),
+        mono(0),
+        epoch(0)
+      { }
+
+      //! Virtual time elapsed since the last anchor, must be called
+      //! with the lock held.
+      uint64_t
+      getElapsed(void) const
+      {
+        if (mode != VM_SCALED)
+          return 0;
+
+        return (uint64_t)((Clock::getRealNsec() - real) * speed);
+      }
+
+      //! Re-anchor the virtual clock, must be called with the lock
+      //! held.
+      //! @param[in] jump amount of time to move forward.
+      void
+      anchor(uint64_t jump)
+      {
+        uint64_t elapsed = getElapsed();
+        real = Clock::getRealNsec();
+        mono += elapsed + jump;
+        epoch += elapsed + jump;
+      }
+    };
+
+    static VirtualClock&
+    getVirtualClock(void)
+    {
+      static VirtualClock vc;
+      return vc;
+    }
+
     uint64_t
     Clock::getNsec(void)
+    {
+      VirtualClock& vc = getVirtualClock();
+      if (vc.mode == VM_NONE)
+        return getRealNsec();
+
+      Concurrency::ScopedCondition l(vc.cond);
+      if (vc.mode == VM_NONE)
+        return getRealNsec();
+
+      return vc.mono + vc.getElapsed();
+    }
+
+    uint64_t
+    Clock::getSinceEpochNsec(void)
+    {
+      VirtualClock& vc = getVirtualClock();
+      if (vc.mode == VM_NONE)
+        return getRealSinceEpochNsec();
+
+      Concurrency::ScopedCondition l(vc.cond);
+      if (vc.mode == VM_NONE)
+        return getRealSinceEpochNsec();
+
+      return vc.epoch + vc.getElapsed();
+    }
+
+    uint64_t
+    Clock::getRealNsec(void)
     {
       // POSIX RT.
 #if defined(DUNE_SYS_HAS_CLOCK_GETTIME)
@@ -73,14 +169,14 @@ namespace DUNE
         QueryPerformanceCounter(&li);
         return (uint64_t)(li.QuadPart * (1000000000L / (double)frequency.QuadPart));
       }
-      return getSinceEpochNsec();
+      return getRealSinceEpochNsec();
 #else
-      return getSinceEpochNsec();
+      return getRealSinceEpochNsec();
 #endif
     }
 
     uint64_t
-    Clock::getSinceEpochNsec(void)
+    Clock::getRealSinceEpochNsec(void)
     {
       // POSIX RT.
 #if defined(DUNE_SYS_HAS_CLOCK_GETTIME)
@@ -109,7 +205,7 @@ namespace DUNE
 
       // Unsupported system.
 #else
-#  error Clock::getSinceEpochNsec() is not yet implemented in this system.
+#  error Clock::getRealSinceEpochNsec() is not yet implemented in this system.
 
 #endif
     }
@@ -127,5 +223,93 @@ namespace DUNE
       (void)value;
 #endif
     }
+
+    void
+    Clock::startVirtual(double value, double speed)
+    {
+      VirtualClock& vc = getVirtualClock();
+      Concurrency::ScopedCondition l(vc.cond);
+
+      // Keep the monotonic clock from going backwards.
+      if (vc.mode == VM_NONE)
+        vc.mono = getRealNsec();
+      else
+        vc.mono += vc.getElapsed();
+
+      vc.real = getRealNsec();
+      vc.epoch = (uint64_t)(value * c_nsec_per_sec_fp);
+      vc.speed = (speed > 0) ? speed : 0;
+      vc.mode = (speed > 0) ? VM_SCALED : VM_STEPPED;
+      vc.cond.broadcast();
+    }
+
+    void
+    Clock::setVirtual(double value)
+    {
+      VirtualClock& vc = getVirtualClock();
+      Concurrency::ScopedCondition l(vc.cond);
+
+      if (vc.mode == VM_NONE)
+        return;
+
+      uint64_t target = (uint64_t)(value * c_nsec_per_sec_fp);
+      uint64_t now = vc.epoch + vc.getElapsed();
+      if (target <= now)
+        return;
+
+      vc.anchor(target - now);
+      vc.cond.broadcast();
+    }
+
+    void
+    Clock::stopVirtual(void)
+    {
+      VirtualClock& vc = getVirtualClock();
+      Concurrency::ScopedCondition l(vc.cond);
+      vc.mode = VM_NONE;
+      vc.speed = 1.0;
+      vc.cond.broadcast();
+    }
+
+    bool
+    Clock::isVirtual(void)
+    {
+      return getVirtualClock().mode != VM_NONE;
+    }
+
+    double
+    Clock::getSpeed(void)
+    {
+      VirtualClock& vc = getVirtualClock();
+      Concurrency::ScopedCondition l(vc.cond);
+      return vc.speed;
+    }
+
+    void
+    Clock::waitVirtualNsec(uint64_t nsec)
+    {
+      VirtualClock& vc = getVirtualClock();
+      Concurrency::ScopedCondition l(vc.cond);
+
+      if (vc.mode == VM_NONE)
+        return;
+
+      uint64_t deadline = vc.mono + vc.getElapsed() + nsec;
+
+      while (vc.mode != VM_NONE)
+      {
+        uint64_t now = vc.mono + vc.getElapsed();
+        if (now >= deadline)
+          break;
+
+        // Stepped clocks are woken up by setVirtual(), the timeout
+        // only guards against missed wake ups.
+        double timeout = 1.0;
+        if (vc.mode == VM_SCALED)
+          timeout = (deadline - now) / (vc.speed * c_nsec_per_sec_fp);
+
+        vc.cond.wait(timeout);
+      }
+    }
   }
 }
@@ -42,6 +42,12 @@ namespace DUNE
     class DUNE_DLL_SYM Clock;
 
     //! %System clock routines.
+    //!
+    //! The clock can be switched to a process-wide virtual clock
+    //! (e.g., when replaying logs) which either runs at a multiple of
+    //! the real time or only advances when explicitly told to. All
+    //! getters except the getReal* ones follow the virtual clock
+    //! while it is active.
     class Clock
     {
     public:
@@ -52,6 +58,21 @@ namespace DUNE
       static uint64_t
       getNsec(void);
 
+      //! Same as getNsec() but always uses the real clock, even if
+      //! the virtual clock is active.
+      //! @return time in nanoseconds.
+      static uint64_t
+      getRealNsec(void);
+
+      //! Same as get() but always uses the real clock, even if the
+      //! virtual clock is active.
+      //! @return time in seconds.
+      static double
+      getReal(void)
+      {
+        return getRealNsec() / c_nsec_per_sec_fp;
+      }
+
       //! Get the amount of time (in microseconds) since an unspecified
       //! point in the past. If the system permits, this point does
       //! not change after system start-up time.
@@ -88,6 +109,21 @@ namespace DUNE
       static uint64_t
       getSinceEpochNsec(void);
 
+      //! Same as getSinceEpochNsec() but always uses the real clock,
+      //! even if the virtual clock is active.
+      //! @return time in nanoseconds.
+      static uint64_t
+      getRealSinceEpochNsec(void);
+
+      //! Same as getSinceEpoch() but always uses the real clock, even
+      //! if the virtual clock is active.
+      //! @return time in seconds.
+      static double
+      getRealSinceEpoch(void)
+      {
+        return getRealSinceEpochNsec() / c_nsec_per_sec_fp;
+      }
+
       //! Get the amount of time (in microseconds) elapsed since the
       //! UNIX Epoch (Midnight UTC of January 1, 1970).
       //! @return time in microseconds.
@@ -120,6 +156,55 @@ namespace DUNE
       //! @param value time in seconds.
       static void
       set(double value);
+
+      //! Start the virtual clock. If the virtual clock is already
+      //! active it is restarted with the new settings.
+      //! @param[in] value initial time in the form of seconds
+      //! elapsed since the UNIX Epoch.
+      //! @param[in] speed rate of the virtual clock relative to the
+      //! real clock. If zero or negative the virtual clock only
+      //! advances when setVirtual() is called.
+      static void
+      startVirtual(double value, double speed);
+
+      //! Move the virtual clock forward. Values in the past are
+      //! ignored. Does nothing if the virtual clock is not active.
+      //! @param[in] value time in the form of seconds elapsed since
+      //! the UNIX Epoch.
+      static void
+      setVirtual(double value);
+
+      //! Stop the virtual clock and go back to the real clock.
+      static void
+      stopVirtual(void);
+
+      //! Test if the virtual clock is active.
+      //! @return true if the virtual clock is active, false otherwise.
+      static bool
+      isVirtual(void);
+
+      //! Get the rate of the virtual clock.
+      //! @return rate relative to the real clock, zero if the virtual
+      //! clock only advances when setVirtual() is called and one if
+      //! the virtual clock is not active.
+      static double
+      getSpeed(void);
+
+      //! Suspend the calling thread until the virtual clock advances
+      //! a given amount of time. Returns early if the virtual clock
+      //! is stopped.
+      //! @param[in] nsec amount of virtual time to wait for (in
+      //! nanoseconds).
+      static void
+      waitVirtualNsec(uint64_t nsec);
+
+      //! Same as waitVirtualNsec() but in seconds.
+      //! @param[in] s amount of virtual time to wait for (in seconds).
+      static void
+      waitVirtual(double s)
+      {
+        waitVirtualNsec((uint64_t)(s * c_nsec_per_sec_fp));
+      }
     };
   }
 }
@@ -41,7 +41,10 @@ namespace DUNE
     // Export DLL Symbol.
     class DUNE_DLL_SYM Delay;
 
-    //! Routines to control timed delays.
+    //! Routines to control timed delays. Delays always use the real
+    //! clock, even if the virtual clock is active, so that they
+    //! cannot hang while a stepped virtual clock is not advanced. Use
+    //! Clock::waitVirtual() to wait on the virtual clock.
     class Delay
     {
     public:
@@ -0,0 +1,438 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+#ifndef MAIN_BATCH_HPP_INCLUDED_
+#define MAIN_BATCH_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+// POSIX headers.
+#if defined(DUNE_SYS_HAS_UNISTD_H)
+#  include <unistd.h>
+#endif
+
+#if defined(DUNE_SYS_HAS_SIGNAL_H)
+#  include <signal.h>
+#endif
+
+#if defined(DUNE_SYS_HAS_SYS_WAIT_H)
+#  include <sys/wait.h>
+#endif
+
+//! Configuration section of the replay task.
+static const char* c_batch_replay = "Transports.Replay";
+//! Task namespaces that only process messages and are kept enabled
+//! in batch replays.
+static const char* c_batch_namespaces[] =
+{
+  "Autonomy", "Control", "Maneuver", "Monitors", "Navigation",
+  "Plan", "Supervisors", NULL
+};
+//! Tasks kept enabled in batch replays outside those namespaces.
+static const char* c_batch_tasks[] =
+{
+  "Transports.Replay", "Transports.Logging", NULL
+};
+//! Tasks of those namespaces that drive hardware, run system
+//! commands or set the system clock, disabled in batch replays.
+static const char* c_batch_excluded[] =
+{
+  "Autonomy.TREX", "Control.UAV.Ardupilot", "Monitors.Clock",
+  "Supervisors.Power", NULL
+};
+
+static bool s_batch_stop = false;
+
+#if defined(DUNE_OS_POSIX)
+extern "C" void
+handleBatchTerminate(int signo)
+{
+  switch (signo)
+  {
+    case SIGINT:
+    case SIGTERM:
+      s_batch_stop = true;
+      break;
+  }
+}
+
+//! State of one log of a batch.
+struct BatchJob
+{
+  //! Log file.
+  std::string log;
+  //! Output folder.
+  DUNE::FileSystem::Path output;
+  //! Time at which the job started.
+  double start;
+};
+
+//! Test if a string is in a NULL terminated list.
+//! @param[in] list list of strings.
+//! @param[in] str string.
+//! @return true if the string is in the list.
+static bool
+isBatchListed(const char** list, const std::string& str)
+{
+  for (unsigned i = 0; list[i] != NULL; ++i)
+  {
+    if (str == list[i])
+      return true;
+  }
+
+  return false;
+}
+
+//! Disable every task that is not part of the processing chain, so
+//! that concurrent replays do not compete for ports or devices and
+//! replayed traffic never reaches the network.
+//! @param[in] context execution context.
+static void
+isolateBatchJob(DUNE::Tasks::Context& context)
+{
+  std::vector<std::string> sections = context.config.sections();
+  for (unsigned i = 0; i < sections.size(); ++i)
+  {
+    std::string task = DUNE::Tasks::Manager::getTaskName(sections[i]);
+    if (!DUNE::Tasks::Factory::exists(task))
+      continue;
+
+    std::string ns = task.substr(0, task.find('.'));
+    if (isBatchListed(c_batch_tasks, task))
+      continue;
+
+    if (isBatchListed(c_batch_namespaces, ns) && !isBatchListed(c_batch_excluded, task))
+      continue;
+
+    context.config.set(sections[i], "Enabled", "Never");
+  }
+}
+
+//! Write the delivery statistics of a replay, one line per task and
+//! message type.
+//! @param[in] context execution context.
+//! @param[in] file output file.
+static void
+writeBatchStatistics(DUNE::Tasks::Context& context, const DUNE::FileSystem::Path& file)
+{
+  std::vector<const DUNE::IMC::DeliveryStatistics*> stats;
+  context.mbus.getStatistics(stats);
+
+  std::ofstream ofs(file.c_str());
+  ofs << "Task,Message,Enqueued,Dequeued,Dropped,Max Depth,Latency p50 (us),Latency p99 (us)" << std::endl;
+
+  for (unsigned i = 0; i < stats.size(); ++i)
+  {
+    const DUNE::IMC::DeliveryStatistics* s = stats[i];
+    if (s->getEnqueued() == 0)
+      continue;
+
+    ofs << s->getTask()->getName() << ","
+        << DUNE::IMC::Factory::getAbbrevFromId(s->getId()) << ","
+        << s->getEnqueued() << ","
+        << s->getDequeued() << ","
+        << s->getDropped() << ","
+        << s->getMaxDepth() << ","
+        << s->getLatencyPercentile(0.5) << ","
+        << s->getLatencyPercentile(0.99) << std::endl;
+  }
+}
+
+//! Totals of the delivery statistics of a replay.
+struct BatchTotals
+{
+  //! Number of message types delivered.
+  unsigned messages;
+  //! Number of messages queued for tasks.
+  unsigned long enqueued;
+  //! Number of messages delivered to tasks.
+  unsigned long dequeued;
+  //! Number of discarded messages.
+  unsigned long dropped;
+  //! Largest queue depth.
+  unsigned long max_depth;
+};
+
+//! Read the totals of the delivery statistics written by a replay.
+//! @param[in] file statistics file.
+//! @return totals, all zero if the file is missing.
+static BatchTotals
+readBatchTotals(const DUNE::FileSystem::Path& file)
+{
+  BatchTotals totals = {0, 0, 0, 0, 0};
+  std::set<std::string> messages;
+
+  std::ifstream ifs(file.c_str());
+  std::string line;
+  std::getline(ifs, line);
+
+  while (std::getline(ifs, line))
+  {
+    std::vector<std::string> fields;
+    DUNE::Utils::String::split(line, ",", fields);
+    if (fields.size() < 6)
+      continue;
+
+    unsigned long value = 0;
+    messages.insert(fields[1]);
+    if (DUNE::castLexical(fields[2], value))
+      totals.enqueued += value;
+    if (DUNE::castLexical(fields[3], value))
+      totals.dequeued += value;
+    if (DUNE::castLexical(fields[4], value))
+      totals.dropped += value;
+    if (DUNE::castLexical(fields[5], value) && value > totals.max_depth)
+      totals.max_depth = value;
+  }
+
+  totals.messages = messages.size();
+  return totals;
+}
+
+//! Replay one log through the task graph of the configuration,
+//! called in the child process.
+//! @param[in] context execution context.
+//! @param[in] profiles execution profiles.
+//! @param[in] job job to run.
+//! @return exit status of the child process.
+static int
+runBatchJob(DUNE::Tasks::Context& context, const std::string& profiles,
+            const BatchJob& job)
+{
+  job.output.create();
+
+  DUNE::FileSystem::Path out = job.output / "Output.txt";
+  if (std::freopen(out.c_str(), "w", stdout) == NULL
+      || dup2(fileno(stdout), fileno(stderr)) == -1)
+    return 1;
+
+  // Each job has its own databases, so that concurrent jobs never
+  // write the operator's plan database or message cache.
+  context.dir_log = job.output;
+  context.dir_db = job.output / "db";
+  context.dir_db.create();
+
+  isolateBatchJob(context);
+  context.config.set(c_batch_replay, "Enabled", "Always");
+  context.config.set(c_batch_replay, "Load At Start", job.log);
+  context.config.set(c_batch_replay, "Speed", "0");
+  context.config.set(c_batch_replay, "Stop At End", "true");
+
+  try
+  {
+    DUNE::Daemon daemon(context, profiles);
+    daemon.start();
+
+    // The daemon stops itself when the replay finishes.
+    while (!s_batch_stop && daemon.isRunning())
+      DUNE::Time::Delay::wait(0.5);
+
+    daemon.stopAndJoin();
+    writeBatchStatistics(context, job.output / "Statistics.csv");
+  }
+  catch (std::exception& e)
+  {
+    DUNE_ERR("Batch", e.what());
+    return 1;
+  }
+
+  return s_batch_stop ? 1 : 0;
+}
+
+//! Describe the exit status of a child process.
+//! @param[in] status status returned by waitpid().
+//! @return description.
+static std::string
+getBatchStatus(int status)
+{
+  if (WIFSIGNALED(status))
+    return DUNE::Utils::String::str("signal %d", WTERMSIG(status));
+
+  if (WEXITSTATUS(status) != 0)
+    return DUNE::Utils::String::str("exit %d", WEXITSTATUS(status));
+
+  return "ok";
+}
+#endif
+
+//! Replay a list of logs through the task graph of the
+//! configuration without external interfaces: transports other than
+//! replay and logging, hardware drivers and simulators are disabled.
+//! Each log is replayed as fast as possible in its own process, so
+//! that each one has its own context, message bus and virtual clock,
+//! and several logs are replayed concurrently.
+//! @param[in] context execution context.
+//! @param[in] profiles execution profiles.
+//! @param[in] list file with the path of one log per line.
+//! @param[in] output output folder, with one folder per log.
+//! @param[in] jobs maximum number of concurrent replays, zero to
+//! use the number of processors.
+//! @return exit status of the program.
+static int
+runBatch(DUNE::Tasks::Context& context, const std::string& profiles,
+         const std::string& list, const std::string& output, unsigned jobs)
+{
+#if defined(DUNE_OS_POSIX)
+  std::ifstream ifs(list.c_str());
+  if (!ifs.is_open())
+  {
+    DUNE_ERR("Batch", DTR("failed to open log list ") << list);
+    return 1;
+  }
+
+  std::vector<std::string> logs;
+  std::string line;
+  while (std::getline(ifs, line))
+  {
+    line = DUNE::Utils::String::trim(line);
+    if (!line.empty() && line[0] != '#')
+      logs.push_back(line);
+  }
+
+  DUNE::FileSystem::Path dir(output);
+  dir.create();
+
+  std::ofstream summary((dir / "Summary.csv").c_str());
+  summary << "Log,Status,Time (s),Message Types,Enqueued,Dequeued,Dropped,Max Depth,Output" << std::endl;
+
+  if (jobs == 0)
+    jobs = DUNE::System::Resources::getProcessorCount();
+
+  struct sigaction actions;
+  std::memset(&actions, 0, sizeof(actions));
+  sigemptyset(&actions.sa_mask);
+  actions.sa_handler = handleBatchTerminate;
+  sigaction(SIGINT, &actions, 0);
+  sigaction(SIGTERM, &actions, 0);
+
+  std::map<pid_t, BatchJob> running;
+  size_t next = 0;
+  unsigned failed = 0;
+  bool killed = false;
+  double start = DUNE::Time::Clock::get();
+
+  while (true)
+  {
+    while (!s_batch_stop && next < logs.size() && running.size() < jobs)
+    {
+      BatchJob job;
+      job.log = logs[next];
+      job.output = dir / DUNE::Utils::String::str("%04u", (unsigned)next);
+      job.start = DUNE::Time::Clock::get();
+      ++next;
+
+      // Do not let the child flush buffered output of the parent.
+      std::fflush(0);
+
+      pid_t pid = fork();
+      if (pid == 0)
+        std::exit(runBatchJob(context, profiles, job));
+
+      if (pid == -1)
+      {
+        DUNE_ERR("Batch", DTR("failed to start replay of ") << job.log);
+        summary << job.log << ",fork,0,0,0,0,0,0," << job.output.c_str() << std::endl;
+        ++failed;
+        continue;
+      }
+
+      running[pid] = job;
+    }
+
+    if (running.empty())
+      break;
+
+    if (s_batch_stop && !killed)
+    {
+      std::map<pid_t, BatchJob>::iterator itr = running.begin();
+      for (; itr != running.end(); ++itr)
+        kill(itr->first, SIGTERM);
+      killed = true;
+    }
+
+    int status = 0;
+    pid_t pid = waitpid(-1, &status, 0);
+    if (pid == -1)
+    {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+
+    std::map<pid_t, BatchJob>::iterator itr = running.find(pid);
+    if (itr == running.end())
+      continue;
+
+    const BatchJob& job = itr->second;
+    std::string result = getBatchStatus(status);
+    double elapsed = DUNE::Time::Clock::get() - job.start;
+
+    if (result != "ok")
+      ++failed;
+
+    BatchTotals totals = readBatchTotals(job.output / "Statistics.csv");
+    summary << job.log << "," << result << "," << elapsed << ","
+            << totals.messages << "," << totals.enqueued << ","
+            << totals.dequeued << "," << totals.dropped << ","
+            << totals.max_depth << "," << job.output.c_str() << std::endl;
+    DUNE_MSG("Batch", job.log << ": " << result
+             << DUNE::Utils::String::str(" (%0.1f s)", elapsed));
+
+    running.erase(itr);
+  }
+
+  DUNE_MSG("Batch", DUNE::Utils::String::str("%u/%u logs replayed in %0.1f s, %u failed",
+                                             (unsigned)next, (unsigned)logs.size(),
+                                             DUNE::Time::Clock::get() - start, failed));
+
+  return (failed == 0 && next == logs.size()) ? 0 : 1;
+
+#else
+  (void)context;
+  (void)profiles;
+  (void)list;
+  (void)output;
+  (void)jobs;
+  DUNE_ERR("Batch", DTR("batch mode is not supported in this system"));
+  return 1;
+#endif
+}
+
+#endif
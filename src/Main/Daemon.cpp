@@ -40,6 +40,7 @@
 
 // Local headers.
 #include "Memory.hpp"
+#include "Batch.hpp"
 
 // POSIX headers.
 #if defined(DUNE_SYS_HAS_UNISTD_H)
@@ -211,7 +212,13 @@ main(int argc, char** argv)
   .add("-V", "--vehicle",
        "Vehicle name override", "VEHICLE")
   .add("-X", "--dump-params-xml",
-       "Dump parameters XML to folder DIR", "DIR");
+       "Dump parameters XML to folder DIR", "DIR")
+  .add("-b", "--batch",
+       "Replay the logs listed in file LIST and exit", "LIST")
+  .add("-o", "--batch-output",
+       "Write the output of batch replays to folder DIR", "DIR")
+  .add("-j", "--batch-jobs",
+       "Number of concurrent batch replays", "JOBS");
 
   // Parse command line arguments.
   if (!options.parse(argc, argv))
@@ -280,6 +287,21 @@ main(int argc, char** argv)
   if (!options.value("--vehicle").empty())
     context.config.set("General", "Vehicle", options.value("--vehicle"));
 
+  // Batch replay.
+  if (!options.value("--batch").empty())
+  {
+    std::string output = options.value("--batch-output");
+    if (output.empty())
+      output = "batch";
+
+    unsigned jobs = 0;
+    if (!options.value("--batch-jobs").empty())
+      castLexical(options.value("--batch-jobs"), jobs);
+
+    return runBatch(context, options.value("--profiles"),
+                    options.value("--batch"), output, jobs);
+  }
+
   try
   {
     DUNE::Daemon daemon(context, options.value("--profiles"));
@@ -29,6 +29,9 @@
 
 // ISO C++ 98 headers.
 #include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
 
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
@@ -81,6 +84,10 @@ namespace Plan
     {
       //! Path to DB file
       std::string db_path;
+      //! SQLite journal mode.
+      std::string journal_mode;
+      //! SQLite synchronous mode.
+      std::string synchronous;
     };
 
     struct Task: public DUNE::Tasks::Task
@@ -104,16 +111,41 @@ namespace Plan
       Database::Statement* m_lastchange_query_stmt;
       // Local request counter
       uint16_t m_local_reqid;
+      // Information of all plans, ordered by plan id.
+      std::map<std::string, IMC::PlanDBInformation> m_plans;
+      // Total size of all plans.
+      uint32_t m_plans_size;
+      // Digest of the database state.
+      std::vector<char> m_digest;
+      // True if the digest must be recomputed.
+      bool m_digest_dirty;
+      // True if a write transaction is open.
+      bool m_batch;
+      // Successful replies to writes not yet committed.
+      std::vector<IMC::PlanDB*> m_pending;
 
       Task(const std::string& name, Tasks::Context& ctx):
         DUNE::Tasks::Task(name, ctx),
         m_db(NULL),
-        m_local_reqid(0)
+        m_local_reqid(0),
+        m_plans_size(0),
+        m_digest_dirty(true),
+        m_batch(false)
       {
         param("DB Path", m_args.db_path)
         .defaultValue("")
         .description("Path to DB file");
 
+        param("Journal Mode", m_args.journal_mode)
+        .defaultValue("DELETE")
+        .values("DELETE, TRUNCATE, PERSIST, WAL")
+        .description("SQLite journal mode");
+
+        param("Synchronous", m_args.synchronous)
+        .defaultValue("FULL")
+        .values("OFF, NORMAL, FULL")
+        .description("SQLite synchronous mode, NORMAL is safe with the WAL journal mode");
+
         bind<IMC::PlanControl>(this);
         bind<IMC::PlanDB>(this);
         bind<IMC::PowerOperation>(this);
@@ -141,6 +173,8 @@ namespace Plan
         inf(DTR("database file: '%s'"), db_file.c_str());
 
         m_db = new Database::Connection(db_file.c_str(), Database::Connection::CF_CREATE);
+        m_db->execute(("pragma journal_mode=" + m_args.journal_mode).c_str());
+        m_db->execute(("pragma synchronous=" + m_args.synchronous).c_str());
 
         // Create Plan table and initialize associated statements
         m_db->execute(c_plan_table_stmt);
@@ -166,6 +200,8 @@ namespace Plan
 
         m_lastchange_query_stmt->reset();
 
+        loadState();
+
         setEntityState(IMC::EntityState::ESTA_NORMAL, Status::CODE_ACTIVE);
 
         onSuccess(DTR("initialization complete"));
@@ -177,6 +213,8 @@ namespace Plan
         if (m_db == NULL)
           return;
 
+        commitBatch();
+
         delete m_insert_plan_stmt;
         delete m_delete_plan_stmt;
         delete m_plan_iterator_stmt;
@@ -371,11 +409,11 @@ namespace Plan
         m_plan_info.md5.resize(16);
         MD5::compute((uint8_t*)&plan_data[0], m_plan_info.plan_size, (uint8_t*)&m_plan_info.md5[0]);
 
-        m_db->beginTransaction();
-
         int count = 0;
         try
         {
+          beginWrite();
+
           *m_delete_plan_stmt << m_plan_info.plan_id;
           m_delete_plan_stmt->execute(&count);
           m_delete_plan_stmt->reset();
@@ -388,14 +426,20 @@ namespace Plan
                               << plan_data;
           m_insert_plan_stmt->execute();
           onChange(m_plan_info.change_time, m_plan_info.change_sid, m_plan_info.change_sname);
+
+          endWrite();
         }
         catch (std::runtime_error& e)
         {
+          abortWrite();
           onFailure(e.what());
-          m_db->rollback();
+          return;
         }
 
-        m_db->commit();
+        removeFromState(m_plan_info.plan_id);
+        m_plans[m_plan_info.plan_id] = m_plan_info;
+        m_plans_size += m_plan_info.plan_size;
+        m_digest_dirty = true;
 
         m_reply.arg.set(m_plan_info);
         onSuccess(count ? DTR("OK (updated)") : DTR("OK (new entry)"));
@@ -411,24 +455,27 @@ namespace Plan
         }
 
         inProgress();
-        m_db->beginTransaction();
 
         int count = 0;
         try
         {
+          beginWrite();
+
           *m_delete_plan_stmt << req.plan_id;
           m_delete_plan_stmt->execute(&count);
           if (count)
             onChange(req);
+
+          endWrite();
         }
         catch (std::runtime_error& e)
         {
+          abortWrite();
           onFailure(e.what());
-          m_db->rollback();
           return;
         }
 
-        m_db->commit();
+        removeFromState(req.plan_id);
 
         if (!count)
           onFailure(DTR("undefined plan"));
@@ -503,72 +550,190 @@ namespace Plan
       clearDatabase(const IMC::PlanDB& req)
       {
         inProgress();
-        m_db->beginTransaction();
 
         try
         {
+          beginWrite();
           m_delete_all_plans_stmt->execute();
           onChange(req);
+          endWrite();
         }
         catch (std::runtime_error& e)
         {
+          abortWrite();
           onFailure(e.what());
-          m_db->rollback();
           return;
         }
 
-        m_db->commit();
+        m_plans.clear();
+        m_plans_size = 0;
+        m_digest_dirty = true;
+
         onSuccess();
       }
 
       void
       getDatabaseState(const IMC::PlanDB& req)
       {
-        (void)req;
-        IMC::PlanDBState* state = new IMC::PlanDBState;
+        IMC::PlanDBState state;
+        state.plan_count = m_plans.size();
+        state.plan_size = m_plans_size;
 
-        state->plan_size = 0;
-        state->plan_count = 0;
+        // The MD5 of all MD5s ordered by plan_id.
+        if (m_digest_dirty)
+        {
+          MD5 md5sum;
+          std::map<std::string, IMC::PlanDBInformation>::const_iterator itr = m_plans.begin();
+          for (; itr != m_plans.end(); ++itr)
+            md5sum.update((const uint8_t*)&itr->second.md5[0], 16);
+
+          m_digest.resize(16);
+          md5sum.finalize((uint8_t*)&m_digest[0]);
+          m_digest_dirty = false;
+        }
+
+        state.md5 = m_digest;
+
+        // Plan information is only given for detailed requests.
+        if (req.op == IMC::PlanDB::DBOP_GET_DSTATE)
+        {
+          std::map<std::string, IMC::PlanDBInformation>::const_iterator itr = m_plans.begin();
+          for (; itr != m_plans.end(); ++itr)
+            state.plans_info.push_back(itr->second);
+        }
 
-        MD5 md5sum;
+        m_lastchange_query_stmt->execute();
+        *m_lastchange_query_stmt >> state.change_time
+                                 >> state.change_sid
+                                 >> state.change_sname;
+        m_lastchange_query_stmt->reset();
+
+        m_reply.arg.set(state);
+        onSuccess();
+      }
 
-        IMC::MessageList<PlanDBInformation>* plandbinfo = &state->plans_info;
+      //! Load the information of all plans from the database.
+      void
+      loadState(void)
+      {
+        m_plans.clear();
+        m_plans_size = 0;
+        m_digest_dirty = true;
 
         while (m_plan_iterator_stmt->execute())
         {
-          IMC::PlanDBInformation* pinfo = new IMC::PlanDBInformation;
+          IMC::PlanDBInformation info;
 
-          *m_plan_iterator_stmt >> pinfo->plan_id
-                                >> pinfo->change_time
-                                >> pinfo->change_sid
-                                >> pinfo->change_sname
-                                >> pinfo->md5
-                                >> pinfo->plan_size;
+          *m_plan_iterator_stmt >> info.plan_id
+                                >> info.change_time
+                                >> info.change_sid
+                                >> info.change_sname
+                                >> info.md5
+                                >> info.plan_size;
 
-          md5sum.update((const uint8_t*)&pinfo->md5[0], 16); // the MD5 of all MD5s ordered by plan_id
-          state->plan_size += pinfo->plan_size;
-          state->plan_count++;
+          m_plans_size += info.plan_size;
+          m_plans[info.plan_id] = info;
+        }
+        m_plan_iterator_stmt->reset();
+      }
 
-          plandbinfo->push_back(*pinfo);
+      //! Remove a plan from the in-memory state.
+      //! @param[in] plan_id plan identifier.
+      void
+      removeFromState(const std::string& plan_id)
+      {
+        std::map<std::string, IMC::PlanDBInformation>::iterator itr = m_plans.find(plan_id);
+        if (itr == m_plans.end())
+          return;
+
+        m_plans_size -= itr->second.plan_size;
+        m_plans.erase(itr);
+        m_digest_dirty = true;
+      }
 
-          delete pinfo;
+      //! Start a write. Writes are grouped in a single transaction
+      //! until all pending requests are handled, each one in its own
+      //! savepoint.
+      void
+      beginWrite(void)
+      {
+        if (!m_batch)
+        {
+          m_db->beginTransaction();
+          m_batch = true;
         }
-        m_plan_iterator_stmt->reset();
 
-        // Finalized MD5 digest
-        state->md5.resize(16);
-        md5sum.finalize((uint8_t*)&state->md5[0]);
+        m_db->execute("savepoint request");
+      }
 
-        m_lastchange_query_stmt->execute();
-        *m_lastchange_query_stmt >> state->change_time
-                                 >> state->change_sid
-                                 >> state->change_sname;
-        m_lastchange_query_stmt->reset();
+      //! Finish a successful write.
+      void
+      endWrite(void)
+      {
+        m_db->execute("release request");
+      }
 
-        m_reply.arg.set(*state);
-        onSuccess();
+      //! Undo a failed write.
+      void
+      abortWrite(void)
+      {
+        if (!m_batch)
+          return;
+
+        try
+        {
+          m_db->execute("rollback to request");
+          m_db->execute("release request");
+        }
+        catch (std::runtime_error& e)
+        {
+          err("%s", e.what());
+        }
+      }
+
+      //! Commit the pending writes and send their replies.
+      void
+      commitBatch(void)
+      {
+        if (!m_batch)
+          return;
+
+        m_batch = false;
+
+        std::string error;
+        try
+        {
+          m_db->commit();
+        }
+        catch (std::runtime_error& e)
+        {
+          error = e.what();
+
+          try
+          {
+            m_db->rollback();
+          }
+          catch (std::runtime_error&)
+          { }
+
+          loadState();
+        }
+
+        for (size_t i = 0; i < m_pending.size(); ++i)
+        {
+          if (!error.empty())
+          {
+            m_pending[i]->type = IMC::PlanDB::DBT_FAILURE;
+            m_pending[i]->info = error;
+            m_pending[i]->arg.clear();
+          }
 
-        delete state;
+          dispatch(m_pending[i]);
+          report(*m_pending[i]);
+          delete m_pending[i];
+        }
+
+        m_pending.clear();
       }
 
       void
@@ -576,23 +741,36 @@ namespace Plan
       {
         m_reply.type = type;
         m_reply.info = desc;
+
+        // Writes are acknowledged once committed.
+        if (m_batch && type == IMC::PlanDB::DBT_SUCCESS)
+        {
+          m_pending.push_back(m_reply.clone());
+          return;
+        }
+
         dispatch(m_reply);
+        report(m_reply);
+      }
 
-        switch (m_reply.op)
+      void
+      report(const IMC::PlanDB& reply)
+      {
+        switch (reply.op)
         {
           case IMC::PlanDB::DBOP_SET:
           case IMC::PlanDB::DBOP_DEL:
           case IMC::PlanDB::DBOP_CLEAR:
             {
-              if (type == IMC::PlanDB::DBT_FAILURE)
-                err("%s (%s) -- %s", DTR(c_op_desc[m_reply.op]),
-                    m_reply.plan_id.c_str(), desc);
-              else if (type == IMC::PlanDB::DBT_SUCCESS)
-                inf("%s (%s) -- %s", DTR(c_op_desc[m_reply.op]),
-                    m_reply.plan_id.c_str(), desc);
+              if (reply.type == IMC::PlanDB::DBT_FAILURE)
+                err("%s (%s) -- %s", DTR(c_op_desc[reply.op]),
+                    reply.plan_id.c_str(), reply.info.c_str());
+              else if (reply.type == IMC::PlanDB::DBT_SUCCESS)
+                inf("%s (%s) -- %s", DTR(c_op_desc[reply.op]),
+                    reply.plan_id.c_str(), reply.info.c_str());
               else
-                debug("%s (%s) -- %s", DTR(c_op_desc[m_reply.op]),
-                      m_reply.plan_id.c_str(), desc);
+                debug("%s (%s) -- %s", DTR(c_op_desc[reply.op]),
+                      reply.plan_id.c_str(), reply.info.c_str());
             }
         }
       }
@@ -621,6 +799,7 @@ namespace Plan
         while (!stopping())
         {
           waitForMessages(1.0);
+          commitBatch();
         }
       }
     };
@@ -0,0 +1,379 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+#ifndef TRANSPORTS_CACHE_JOURNAL_HPP_INCLUDED_
+#define TRANSPORTS_CACHE_JOURNAL_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cstdio>
+#include <cerrno>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+#if defined(DUNE_SYS_HAS_FDATASYNC) || defined(DUNE_SYS_HAS_FSYNC)
+// POSIX headers.
+#  include <unistd.h>
+#endif
+
+namespace Transports
+{
+  namespace Cache
+  {
+    using DUNE_NAMESPACES;
+
+    //! Minimum amount of superseded data before compacting.
+    static const uint64_t c_min_garbage = 64 * 1024;
+
+    //! Append-only cache storage. Messages are appended to a single
+    //! LSF file and an in-memory index maps each (message id, sub id)
+    //! to its latest copy. Superseded copies are dropped by
+    //! compaction, which rewrites the live messages in loading order
+    //! to a temporary file and atomically replaces the journal.
+    //! Incomplete or corrupted messages at the end of the journal,
+    //! left by a crash, are discarded when the journal is opened.
+    class Journal
+    {
+    public:
+      //! Open a journal, creating it if it does not exist.
+      //! @param[in] path journal file.
+      //! @param[in] order identifiers of the messages that must be
+      //! loaded first, in order.
+      //! @throw System::Error if the journal cannot be opened.
+      Journal(const Path& path, const std::vector<uint16_t>& order):
+        m_path(path),
+        m_order(order),
+        m_file(NULL),
+        m_size(0),
+        m_live(0)
+      {
+        recover();
+      }
+
+      //! Destructor.
+      ~Journal(void)
+      {
+        if (m_file != NULL)
+          std::fclose(m_file);
+      }
+
+      //! Append a message, superseding any previous message with the
+      //! same identifier and sub identifier.
+      //! @param[in] msg message.
+      //! @throw System::Error if the message cannot be written.
+      void
+      store(const IMC::Message* msg)
+      {
+        uint16_t size = msg->getSerializationSize();
+        m_bfr.resize(size);
+        IMC::Packet::serialize(msg, &m_bfr[0], size);
+
+        // Reads move the file position.
+        if (std::fseek(m_file, 0, SEEK_END) != 0
+            || std::fwrite(&m_bfr[0], 1, size, m_file) != size
+            || std::fflush(m_file) != 0)
+          throw System::Error(errno, "failed to write cache journal", m_path.str());
+
+        index(Key(msg->getId(), msg->getSubId()), m_size, size);
+        m_size += size;
+
+        if (isFragmented())
+          compact();
+      }
+
+      //! Read all live messages in loading order.
+      //! @param[out] msgs messages, to be deleted by the caller.
+      void
+      read(std::vector<IMC::Message*>& msgs)
+      {
+        std::vector<const Record*> records;
+        getRecords(records);
+
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+          readRecord(*records[i]);
+
+          try
+          {
+            msgs.push_back(IMC::Packet::deserialize(&m_bfr[0], m_bfr.size()));
+          }
+          catch (std::exception& e)
+          {
+            DUNE_ERR("Cache", e.what());
+          }
+        }
+      }
+
+      //! Remove all messages.
+      void
+      clear(void)
+      {
+        std::fclose(m_file);
+        m_file = NULL;
+        m_path.remove();
+        m_index.clear();
+        m_size = 0;
+        m_live = 0;
+        open();
+      }
+
+      //! Rewrite the journal with only the live messages, in loading
+      //! order.
+      //! @throw System::Error if the journal cannot be rewritten.
+      void
+      compact(void)
+      {
+        std::vector<const Record*> records;
+        getRecords(records);
+
+        Path tmp = m_path + ".tmp";
+        std::FILE* ofd = std::fopen(tmp.c_str(), "wb");
+        if (ofd == NULL)
+          throw System::Error(errno, "failed to create", tmp.str());
+
+        Index index;
+        uint64_t offset = 0;
+        bool good = true;
+
+        for (size_t i = 0; good && i < records.size(); ++i)
+        {
+          readRecord(*records[i]);
+          good = std::fwrite(&m_bfr[0], 1, m_bfr.size(), ofd) == m_bfr.size();
+
+          Record& rec = index[records[i]->key];
+          rec.key = records[i]->key;
+          rec.offset = offset;
+          rec.size = records[i]->size;
+          offset += rec.size;
+        }
+
+        good = good && std::fflush(ofd) == 0;
+#if defined(DUNE_SYS_HAS_FDATASYNC)
+        good = good && ::fdatasync(fileno(ofd)) == 0;
+#elif defined(DUNE_SYS_HAS_FSYNC)
+        good = good && ::fsync(fileno(ofd)) == 0;
+#endif
+        int error = errno;
+        std::fclose(ofd);
+
+        if (!good || std::rename(tmp.c_str(), m_path.c_str()) != 0)
+        {
+          error = good ? errno : error;
+          tmp.remove();
+          throw System::Error(error, "failed to compact cache journal", m_path.str());
+        }
+
+        std::fclose(m_file);
+        m_file = NULL;
+        m_index.swap(index);
+        m_size = offset;
+        m_live = offset;
+        open();
+      }
+
+      //! Test if the journal has enough superseded data to be
+      //! compacted.
+      //! @return true if the journal should be compacted.
+      bool
+      isFragmented(void) const
+      {
+        uint64_t garbage = m_size - m_live;
+        return garbage >= c_min_garbage && garbage > m_live;
+      }
+
+      //! Test if the journal contains superseded data.
+      //! @return true if the journal contains superseded data.
+      bool
+      hasGarbage(void) const
+      {
+        return m_size > m_live;
+      }
+
+      //! Retrieve the number of live messages.
+      //! @return number of live messages.
+      size_t
+      getCount(void) const
+      {
+        return m_index.size();
+      }
+
+      //! Retrieve the journal size.
+      //! @return size in bytes.
+      uint64_t
+      getSize(void) const
+      {
+        return m_size;
+      }
+
+      //! Retrieve the journal path.
+      //! @return journal path.
+      const Path&
+      getPath(void) const
+      {
+        return m_path;
+      }
+
+    private:
+      //! Message identifier and sub identifier.
+      typedef std::pair<uint16_t, uint16_t> Key;
+
+      //! Location of a message in the journal.
+      struct Record
+      {
+        Record(void):
+          offset(0),
+          size(0)
+        { }
+
+        //! Message key.
+        Key key;
+        //! Offset of the message.
+        uint64_t offset;
+        //! Size of the message.
+        uint32_t size;
+      };
+
+      //! Latest copy of each message.
+      typedef std::map<Key, Record> Index;
+
+      //! Journal file.
+      Path m_path;
+      //! Loading order.
+      std::vector<uint16_t> m_order;
+      //! Journal file handle.
+      std::FILE* m_file;
+      //! Journal index.
+      Index m_index;
+      //! Journal size.
+      uint64_t m_size;
+      //! Size of the live messages.
+      uint64_t m_live;
+      //! Serialization buffer.
+      std::vector<uint8_t> m_bfr;
+
+      //! Open the journal for appending.
+      void
+      open(void)
+      {
+        m_file = std::fopen(m_path.c_str(), "a+b");
+        if (m_file == NULL)
+          throw System::Error(errno, "failed to open cache journal", m_path.str());
+      }
+
+      //! Rebuild the index from the journal, discarding corrupted
+      //! data.
+      void
+      recover(void)
+      {
+        if (m_path.isFile())
+        {
+          IMC::LsfReader reader(m_path.str());
+          IMC::PacketView pkt;
+          uint64_t offset = 0;
+
+          while (reader.next(offset, pkt))
+          {
+            IMC::Message* msg = pkt.materialize();
+            index(Key(msg->getId(), msg->getSubId()), offset - pkt.getSize(), pkt.getSize());
+            delete msg;
+          }
+
+          m_size = reader.getSize();
+        }
+
+        open();
+
+        // Drop superseded and corrupted data.
+        if (m_size != m_live)
+          compact();
+      }
+
+      //! Update the index with a new copy of a message.
+      //! @param[in] key message key.
+      //! @param[in] offset offset of the message.
+      //! @param[in] size size of the message.
+      void
+      index(const Key& key, uint64_t offset, uint32_t size)
+      {
+        Record& rec = m_index[key];
+        if (rec.size == 0)
+          rec.key = key;
+        else
+          m_live -= rec.size;
+
+        rec.offset = offset;
+        rec.size = size;
+        m_live += size;
+      }
+
+      //! Read a message from the journal to the internal buffer.
+      //! @param[in] rec message location.
+      void
+      readRecord(const Record& rec)
+      {
+        m_bfr.resize(rec.size);
+        if (std::fseek(m_file, (long)rec.offset, SEEK_SET) != 0
+            || std::fread(&m_bfr[0], 1, rec.size, m_file) != rec.size)
+          throw System::Error(errno, "failed to read cache journal", m_path.str());
+      }
+
+      //! Retrieve the live messages in loading order: messages in the
+      //! loading order list first and the remaining ones by
+      //! identifier.
+      //! @param[out] records live messages.
+      void
+      getRecords(std::vector<const Record*>& records) const
+      {
+        std::set<uint16_t> ordered;
+
+        for (size_t i = 0; i < m_order.size(); ++i)
+        {
+          if (!ordered.insert(m_order[i]).second)
+            continue;
+
+          Index::const_iterator itr = m_index.lower_bound(Key(m_order[i], 0));
+          for (; itr != m_index.end() && itr->first.first == m_order[i]; ++itr)
+            records.push_back(&itr->second);
+        }
+
+        Index::const_iterator itr = m_index.begin();
+        for (; itr != m_index.end(); ++itr)
+        {
+          if (ordered.find(itr->first.first) == ordered.end())
+            records.push_back(&itr->second);
+        }
+      }
+    };
+  }
+}
+
+#endif
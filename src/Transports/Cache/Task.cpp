@@ -29,13 +29,14 @@
 
 // ISO C++ 98 headers.
 #include <string>
-#include <fstream>
-#include <iostream>
-#include <algorithm>
+#include <vector>
 
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
 
+// Local headers.
+#include "Journal.hpp"
+
 namespace Transports
 {
   namespace Cache
@@ -52,27 +53,22 @@ namespace Transports
     {
       // Cache directory path.
       Path m_path;
-      // Path to snapshot file.
+      // Path to snapshot file, which is also the cache journal.
       Path m_snapshot;
-      // Internal buffer.
-      uint8_t* m_buffer;
-      // Internal buffer size.
-      uint16_t m_buffer_size;
+      // Cache journal.
+      Journal* m_journal;
       // Task arguments.
       Arguments m_args;
 
       Task(const std::string& name, Tasks::Context& ctx):
-        DUNE::Tasks::Task(name, ctx)
+        DUNE::Tasks::Task(name, ctx),
+        m_journal(NULL)
       {
         // Define configuration parameters.
         param("Loading Order", m_args.order)
         .defaultValue("")
         .description("List of messages ordered by loading order");
 
-        // Initialize internal buffer.
-        m_buffer_size = 128;
-        m_buffer = new uint8_t[m_buffer_size];
-
         // Create cache directory.
         m_path = m_ctx.dir_db / "Cache";
         m_path.create();
@@ -84,172 +80,108 @@ namespace Transports
         bind<IMC::CacheControl>(this);
       }
 
-      ~Task(void)
-      {
-        delete [] m_buffer;
-      }
-
       void
-      onResourceInitialization(void)
+      onResourceAcquisition(void)
       {
-        setEntityState(IMC::EntityState::ESTA_NORMAL, Status::CODE_ACTIVE);
-      }
-
-      void
-      consume(const IMC::CacheControl* msg)
-      {
-        switch (msg->op)
-        {
-          case IMC::CacheControl::COP_STORE:
-            if (!msg->message.isNull())
-              store(msg->message.get());
-            break;
-          case IMC::CacheControl::COP_LOAD:
-            load();
-            break;
-          case IMC::CacheControl::COP_CLEAR:
-            clear();
-            break;
-          case IMC::CacheControl::COP_COPY:
-            copySnapshot(msg->snapshot);
-            break;
-          default:
-            break;
-        }
-      }
+        // Caches of other IMC versions are not compatible.
+        if (m_snapshot.type() != Path::PT_FILE)
+          clear();
 
-      void
-      getMessageFiles(std::vector<std::string>& files)
-      {
-        std::vector<std::string> msgs = m_args.order;
-        const char* fname = 0;
+        removeLegacyFiles();
 
-        // Retrieve the name of all cached messages that are not in the
-        // loading order list.
-        try
+        std::vector<uint16_t> order;
+        for (unsigned i = 0; i < m_args.order.size(); ++i)
         {
-          Directory dir(m_path);
-
-          while ((fname = dir.readEntry(Directory::RD_FILE_NAME)))
+          try
           {
-            if (std::find(msgs.begin(), msgs.end(), fname) == msgs.end()
-                && ((m_path / fname).type() == Path::PT_DIRECTORY))
-            {
-              msgs.push_back(fname);
-            }
+            order.push_back(IMC::Factory::getIdFromAbbrev(m_args.order[i]));
           }
-        }
-        catch (...)
-        { }
-
-        // Load cached messages.
-        for (unsigned int i = 0; i < msgs.size(); ++i)
-        {
-          try
+          catch (std::exception& e)
           {
-            Directory md(m_path / msgs[i]);
-            while ((fname = md.readEntry(Directory::RD_FULL_NAME)))
-              files.push_back(fname);
+            war(DTR("unknown message '%s'"), m_args.order[i].c_str());
           }
-          catch (...)
-          { }
         }
+
+        m_journal = new Journal(m_snapshot, order);
+        debug("%u cached messages, %llu bytes", (unsigned)m_journal->getCount(),
+              (unsigned long long)m_journal->getSize());
       }
 
       void
-      growBuffer(int size)
+      onResourceRelease(void)
       {
-        if (size > m_buffer_size)
-        {
-          delete [] m_buffer;
-          m_buffer_size = size;
-          m_buffer = new uint8_t[m_buffer_size];
-        }
+        Memory::clear(m_journal);
       }
 
       void
-      store(const IMC::Message* msg)
+      onResourceInitialization(void)
       {
-        std::string id = String::str(msg->getSubId());
-        uint16_t size = msg->getSerializationSize();
-
-        // Create destination directory.
-        Path path = m_path / msg->getName();
-        path.create();
-
-        // Open file for writing.
-        path = path / id;
-        std::ofstream ofs(path.c_str(), std::ios::binary);
-
-        growBuffer(size);
-
-        // Write message to file.
-        IMC::Packet::serialize(msg, m_buffer, size);
-        ofs.write((char*)m_buffer, size);
-        ofs.close();
-
-        storeSnapshot();
+        setEntityState(IMC::EntityState::ESTA_NORMAL, Status::CODE_ACTIVE);
       }
 
       void
-      loadSnapshot(void)
+      consume(const IMC::CacheControl* msg)
       {
-        if (m_snapshot.type() != Path::PT_FILE)
-        {
-          clear();
-          return;
-        }
-
-        std::ifstream ifs(m_snapshot.c_str(), std::ios::binary);
-
-        if (!ifs.is_open())
-          return;
-
-        while (!ifs.eof())
+        try
         {
-          IMC::Message* msg = IMC::Packet::deserialize(ifs);
-          if (msg)
+          switch (msg->op)
           {
-            dispatch(msg, DF_KEEP_TIME);
-            delete msg;
+            case IMC::CacheControl::COP_STORE:
+              if (!msg->message.isNull())
+                m_journal->store(msg->message.get());
+              break;
+            case IMC::CacheControl::COP_LOAD:
+              load();
+              break;
+            case IMC::CacheControl::COP_CLEAR:
+              m_journal->clear();
+              break;
+            case IMC::CacheControl::COP_COPY:
+              copySnapshot(msg->snapshot);
+              break;
+            default:
+              break;
           }
         }
+        catch (System::Error& e)
+        {
+          err("%s", e.what());
+        }
       }
 
+      //! Remove the per message files of the previous cache layout.
       void
-      storeSnapshot(void)
+      removeLegacyFiles(void)
       {
-        // Retrieve file list.
-        std::vector<std::string> files;
-        getMessageFiles(files);
-
-        std::ofstream ofs(m_snapshot.c_str(), std::ios::binary);
+        std::vector<Path> legacy;
+        const char* fname = 0;
 
-        // Copy all cached messages to a single file.
-        for (unsigned int i = 0; i < files.size(); ++i)
+        try
         {
-          int64_t size = Path(files[i]).size();
-
-          if (size < 0)
-            continue;
-
-          growBuffer(size);
-
-          std::ifstream ifs(files[i].c_str(), std::ios::binary);
-          ifs.read((char*)m_buffer, size);
-          ofs.write((char*)m_buffer, size);
+          Directory dir(m_path);
+          while ((fname = dir.readEntry(Directory::RD_FULL_NAME)))
+          {
+            if (Path(fname).type() == Path::PT_DIRECTORY)
+              legacy.push_back(fname);
+          }
         }
+        catch (...)
+        { }
+
+        for (unsigned i = 0; i < legacy.size(); ++i)
+          legacy[i].remove(Path::MODE_RECURSIVE);
       }
 
       void
       copySnapshot(Path destination)
       {
-        if (!Path(m_snapshot).exists())
-          return;
+        // A compacted journal is a snapshot of the cache.
+        if (m_journal->hasGarbage())
+          m_journal->compact();
 
         try
         {
-          Path(m_snapshot).copy(destination);
+          m_snapshot.copy(destination);
           IMC::CacheControl cc;
           cc.op = IMC::CacheControl::COP_COPY_COMPLETE;
           cc.snapshot = destination.str();
@@ -264,18 +196,13 @@ namespace Transports
       void
       load(void)
       {
-        std::vector<std::string> files;
-        getMessageFiles(files);
+        std::vector<IMC::Message*> msgs;
+        m_journal->read(msgs);
 
-        for (unsigned int i = 0; i < files.size(); ++i)
+        for (unsigned int i = 0; i < msgs.size(); ++i)
         {
-          std::ifstream ifs(files[i].c_str(), std::ios::binary);
-          IMC::Message* msg = IMC::Packet::deserialize(ifs);
-          if (msg)
-          {
-            dispatch(msg, DF_KEEP_TIME);
-            delete msg;
-          }
+          dispatch(msgs[i], DF_KEEP_TIME);
+          delete msgs[i];
         }
       }
 
@@ -290,7 +217,7 @@ namespace Transports
       void
       onMain(void)
       {
-        loadSnapshot();
+        load();
 
         while (!stopping())
         {
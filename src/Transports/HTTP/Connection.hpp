@@ -0,0 +1,127 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+#ifndef TRANSPORTS_HTTP_CONNECTION_HPP_INCLUDED_
+#define TRANSPORTS_HTTP_CONNECTION_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <string>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+namespace Transports
+{
+  namespace HTTP
+  {
+    using DUNE_NAMESPACES;
+
+    //! Persistent client connection. Received data is kept in a
+    //! buffer until it holds complete requests, so several pipelined
+    //! requests can be served from a single read.
+    class Connection
+    {
+    public:
+      //! Constructor.
+      //! @param sock connected socket, owned by the connection.
+      Connection(TCPSocket* sock):
+        m_sock(sock),
+        m_last_activity(Clock::getReal())
+      { }
+
+      //! Destructor.
+      ~Connection(void)
+      {
+        delete m_sock;
+      }
+
+      //! Get connection socket.
+      //! @return socket.
+      TCPSocket*
+      getSocket(void)
+      {
+        return m_sock;
+      }
+
+      //! Give up ownership of the socket, which is no longer closed
+      //! when the connection is destroyed.
+      void
+      detach(void)
+      {
+        m_sock = NULL;
+      }
+
+      //! Get received data that was not yet handled.
+      //! @return buffer.
+      std::string&
+      getBuffer(void)
+      {
+        return m_bfr;
+      }
+
+      //! Read data that is waiting in the socket. Must only be called
+      //! when the socket is readable, otherwise it blocks.
+      //! @return number of bytes read.
+      size_t
+      receive(void)
+      {
+        char bfr[c_read_size];
+        size_t rv = m_sock->read(bfr, sizeof(bfr));
+        m_bfr.append(bfr, rv);
+        m_last_activity = Clock::getReal();
+        return rv;
+      }
+
+      //! Get time of the last received data.
+      //! @return real time in seconds, not affected by the clock speed.
+      double
+      getLastActivity(void) const
+      {
+        return m_last_activity;
+      }
+
+    private:
+      //! Size of each read.
+      static const size_t c_read_size = 4096;
+      //! Connection socket.
+      TCPSocket* m_sock;
+      //! Received data.
+      std::string m_bfr;
+      //! Time of the last received data.
+      double m_last_activity;
+
+      Connection(const Connection&);
+
+      Connection&
+      operator=(const Connection&);
+    };
+  }
+}
+
+#endif
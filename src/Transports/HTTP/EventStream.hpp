@@ -0,0 +1,242 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+#ifndef TRANSPORTS_HTTP_EVENT_STREAM_HPP_INCLUDED_
+#define TRANSPORTS_HTTP_EVENT_STREAM_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <list>
+#include <set>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+// Local headers.
+#include "MessageMonitor.hpp"
+
+namespace Transports
+{
+  namespace HTTP
+  {
+    using DUNE_NAMESPACES;
+
+    //! Time between heartbeats in seconds.
+    static const double c_heartbeat_period = 15.0;
+
+    //! Server-sent events stream of message updates. Each client
+    //! receives the messages it subscribed to as events named after
+    //! the message abbreviation. Events are written without blocking
+    //! and clients that fall too far behind are disconnected.
+    class EventStream
+    {
+    public:
+      //! Constructor.
+      //! @param[in] capacity maximum number of bytes waiting to be sent
+      //! to a client.
+      EventStream(size_t capacity = 262144):
+        m_capacity(capacity),
+        m_last_heartbeat(0)
+      { }
+
+      //! Destructor.
+      ~EventStream(void)
+      {
+        std::list<Client>::iterator itr = m_clients.begin();
+        for (; itr != m_clients.end(); ++itr)
+          delete itr->sock;
+      }
+
+      //! Add a client. Can be called from any thread.
+      //! @param[in] sock client socket, owned by the stream.
+      //! @param[in] ids identification numbers of the messages to
+      //! send, all messages if empty.
+      //! @param[in] snapshot current messages, sent first.
+      void
+      subscribe(TCPSocket* sock, const std::set<unsigned>& ids,
+                const std::vector<MessageMonitor::Update>& snapshot)
+      {
+        Client client;
+        client.sock = sock;
+        client.ids = ids;
+        client.bfr = "HTTP/1.1 200 OK\r\n"
+        "Server: DUNE/" DUNE_VERSION_STR "\r\n"
+        "Content-Type: text/event-stream\r\n"
+        "Cache-Control: no-cache\r\n"
+        "\r\n";
+
+        for (unsigned i = 0; i < snapshot.size(); ++i)
+        {
+          if (client.accepts(snapshot[i].id))
+            client.bfr += format(snapshot[i]);
+        }
+
+        Concurrency::ScopedMutex l(m_mutex);
+        m_clients.push_back(client);
+      }
+
+      //! Test if there are subscribed clients.
+      //! @return true if there are no clients.
+      bool
+      empty(void)
+      {
+        Concurrency::ScopedMutex l(m_mutex);
+        return m_clients.empty();
+      }
+
+      //! Send message updates to subscribed clients. A comment is sent
+      //! when there is nothing else to send so that closed
+      //! connections are detected.
+      //! @param[in] updates message updates.
+      void
+      publish(const std::vector<MessageMonitor::Update>& updates)
+      {
+        std::vector<std::string> events(updates.size());
+        for (unsigned i = 0; i < updates.size(); ++i)
+          events[i] = format(updates[i]);
+
+        double now = Clock::getReal();
+        bool heartbeat = (now - m_last_heartbeat) >= c_heartbeat_period;
+        if (heartbeat)
+          m_last_heartbeat = now;
+
+        Concurrency::ScopedMutex l(m_mutex);
+
+        std::list<Client>::iterator itr = m_clients.begin();
+        while (itr != m_clients.end())
+        {
+          for (unsigned i = 0; i < updates.size(); ++i)
+          {
+            if (itr->accepts(updates[i].id))
+              itr->bfr += events[i];
+          }
+
+          if (heartbeat && itr->bfr.empty())
+            itr->bfr = ":\n\n";
+
+          // Only what the socket did not accept counts towards the
+          // capacity, the first write may carry a large snapshot.
+          if (!flush(*itr) || itr->bfr.size() > m_capacity)
+          {
+            delete itr->sock;
+            itr = m_clients.erase(itr);
+            continue;
+          }
+
+          ++itr;
+        }
+      }
+
+    private:
+      //! Subscribed client.
+      struct Client
+      {
+        //! Client socket.
+        TCPSocket* sock;
+        //! Identification numbers of subscribed messages.
+        std::set<unsigned> ids;
+        //! Data waiting to be sent.
+        std::string bfr;
+
+        bool
+        accepts(unsigned id) const
+        {
+          return ids.empty() || (ids.find(id) != ids.end());
+        }
+      };
+
+      //! Subscribed clients.
+      std::list<Client> m_clients;
+      //! Lock for clients.
+      Concurrency::Mutex m_mutex;
+      //! Maximum number of bytes waiting to be sent to a client.
+      size_t m_capacity;
+      //! Time of the last heartbeat.
+      double m_last_heartbeat;
+
+      //! Write pending data to a client.
+      //! @param[in] client client.
+      //! @return false if the connection was closed.
+      static bool
+      flush(Client& client)
+      {
+        if (client.bfr.empty())
+          return true;
+
+        try
+        {
+          const uint8_t* bfr = (const uint8_t*)client.bfr.data();
+          size_t size = client.bfr.size();
+          size_t n = client.sock->writeNonBlocking(&bfr, &size, 1);
+          client.bfr.erase(0, n);
+          return true;
+        }
+        catch (std::runtime_error&)
+        {
+          return false;
+        }
+      }
+
+      //! Format a message update as an event. Every line of the JSON
+      //! text is sent as a data field.
+      //! @param[in] update message update.
+      //! @return event.
+      static std::string
+      format(const MessageMonitor::Update& update)
+      {
+        std::string event("event: ");
+        event += update.name;
+        event += '\n';
+
+        size_t beg = 0;
+        while (beg < update.json.size())
+        {
+          size_t end = update.json.find('\n', beg);
+          if (end == std::string::npos)
+            end = update.json.size();
+
+          if (end > beg)
+          {
+            event += "data: ";
+            event.append(update.json, beg, end - beg);
+            event += '\n';
+          }
+
+          beg = end + 1;
+        }
+
+        event += '\n';
+        return event;
+      }
+    };
+  }
+}
+
+#endif
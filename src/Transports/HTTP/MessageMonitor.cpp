@@ -60,9 +60,9 @@ namespace Transports
       ScopedMutex l(m_mutex);
 
       {
-        std::map<unsigned, IMC::Message*>::iterator itr = m_msgs.begin();
+        MessageMap::iterator itr = m_msgs.begin();
         for (; itr != m_msgs.end(); ++itr)
-          delete itr->second;
+          delete itr->second.msg;
       }
 
       {
@@ -119,15 +119,12 @@ namespace Transports
 
       os << "  'dune_messages': [\n";
 
-      std::map<unsigned, IMC::Message*>::iterator itr = m_msgs.begin();
-      itr->second->toJSON(os);
+      MessageMap::iterator itr = m_msgs.begin();
+      os << encode(itr->second);
       ++itr;
 
       for (; itr != m_msgs.end(); ++itr)
-      {
-        os << ",\n";
-        itr->second->toJSON(os);
-      }
+        os << ",\n" << encode(itr->second);
 
       for (PowerChannelMap::iterator pitr = m_power_channels.begin(); pitr != m_power_channels.end(); ++pitr)
       {
@@ -153,13 +150,91 @@ namespace Transports
       if (msg->getId() == DUNE_IMC_POWERCHANNELSTATE)
         updatePowerChannel(static_cast<const IMC::PowerChannelState*>(msg));
 
-      IMC::Message* tmsg = msg->clone();
-      unsigned key = tmsg->getId() << 24 | tmsg->getSubId() << 8 | tmsg->getSourceEntity();
+      unsigned key = msg->getId() << 24 | msg->getSubId() << 8 | msg->getSourceEntity();
+
+      MessageMap::iterator itr = m_msgs.find(key);
+      if (itr == m_msgs.end())
+      {
+        Entry entry;
+        entry.msg = msg->clone();
+        entry.dirty = true;
+        m_msgs[key] = entry;
+      }
+      else
+      {
+        delete itr->second.msg;
+        itr->second.msg = msg->clone();
+        itr->second.dirty = true;
+      }
+
+      m_changed.insert(key);
+    }
+
+    void
+    MessageMonitor::getUpdates(double period, std::vector<Update>& updates)
+    {
+      ScopedMutex l(m_mutex);
+
+      double now = Clock::get();
+      std::set<unsigned> sent;
 
-      if (m_msgs[key])
-        delete m_msgs[key];
+      std::set<unsigned>::iterator itr = m_changed.begin();
+      while (itr != m_changed.end())
+      {
+        unsigned id = *itr >> 24;
+        if (sent.find(id) == sent.end())
+        {
+          std::map<unsigned, double>::iterator last = m_last_update.find(id);
+          if (last != m_last_update.end() && (now - last->second) < period)
+          {
+            ++itr;
+            continue;
+          }
+        }
+
+        Entry& entry = m_msgs[*itr];
+        Update update;
+        update.id = id;
+        update.name = entry.msg->getName();
+        update.json = encode(entry);
+        updates.push_back(update);
+
+        sent.insert(id);
+        m_changed.erase(itr++);
+      }
+
+      for (std::set<unsigned>::iterator sitr = sent.begin(); sitr != sent.end(); ++sitr)
+        m_last_update[*sitr] = now;
+    }
+
+    void
+    MessageMonitor::getSnapshot(std::vector<Update>& updates)
+    {
+      ScopedMutex l(m_mutex);
+
+      MessageMap::iterator itr = m_msgs.begin();
+      for (; itr != m_msgs.end(); ++itr)
+      {
+        Update update;
+        update.id = itr->first >> 24;
+        update.name = itr->second.msg->getName();
+        update.json = encode(itr->second);
+        updates.push_back(update);
+      }
+    }
+
+    const std::string&
+    MessageMonitor::encode(Entry& entry)
+    {
+      if (entry.dirty)
+      {
+        std::ostringstream os;
+        entry.msg->toJSON(os);
+        entry.json = os.str();
+        entry.dirty = false;
+      }
 
-      m_msgs[key] = tmsg;
+      return entry.json;
     }
 
     ByteBuffer*
@@ -32,7 +32,9 @@
 
 // ISO C++ 98 headers.
 #include <map>
+#include <set>
 #include <string>
+#include <vector>
 
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
@@ -44,6 +46,17 @@ namespace Transports
     class MessageMonitor
     {
     public:
+      //! Latest state of a message.
+      struct Update
+      {
+        //! Message identification number.
+        unsigned id;
+        //! Message abbreviated name.
+        const char* name;
+        //! Message in JSON.
+        std::string json;
+      };
+
       MessageMonitor(const std::string& system, uint64_t uid);
 
       ~MessageMonitor(void);
@@ -63,6 +76,20 @@ namespace Transports
       void
       updateMessage(const DUNE::IMC::Message* msg);
 
+      //! Retrieve the messages that changed since the last call.
+      //! Messages of a given type are retrieved at most once per
+      //! period, newer instances are retrieved in later calls.
+      //! @param[in] period minimum time between updates of the same
+      //! message type, in seconds.
+      //! @param[out] updates changed messages.
+      void
+      getUpdates(double period, std::vector<Update>& updates);
+
+      //! Retrieve all messages.
+      //! @param[out] updates messages.
+      void
+      getSnapshot(std::vector<Update>& updates);
+
       void
       readLock(void)
       {
@@ -76,6 +103,19 @@ namespace Transports
       }
 
     private:
+      //! Latest message of a given type, subtype and entity.
+      struct Entry
+      {
+        //! Message.
+        DUNE::IMC::Message* msg;
+        //! Message in JSON.
+        std::string json;
+        //! True if the JSON is out of date.
+        bool dirty;
+      };
+
+      //! Convenience type definition for a map of messages.
+      typedef std::map<unsigned, Entry> MessageMap;
       //! Convenience type definition for a map of power channels.
       typedef std::map<std::string, DUNE::IMC::PowerChannelState*> PowerChannelMap;
       // Convenience type definition for a map of entity labels.
@@ -83,7 +123,11 @@ namespace Transports
       // Software meta information.
       std::string m_meta;
       // Table of messages.
-      std::map<unsigned, DUNE::IMC::Message*> m_msgs;
+      MessageMap m_msgs;
+      // Messages changed since the last update.
+      std::set<unsigned> m_changed;
+      // Time of the last update of each message type.
+      std::map<unsigned, double> m_last_update;
       // Entity map.
       EntityMap m_entities;
       // Concurrency mutex.
@@ -107,6 +151,9 @@ namespace Transports
 
       void
       updatePowerChannel(const DUNE::IMC::PowerChannelState* msg);
+
+      const std::string&
+      encode(Entry& entry);
     };
   }
 }
@@ -45,22 +45,24 @@
 #include "RequestHandler.hpp"
 
 #define SERVER_VERSION "Server: DUNE/" DUNE_VERSION_STR "\r\n"
-#define STATUS_LINE_100 "HTTP/1.0 100 Continue\r\n"
-#define STATUS_LINE_200 "HTTP/1.0 200 OK\r\n"
-#define STATUS_LINE_201 "HTTP/1.0 201 Created\r\n"
-#define STATUS_LINE_206 "HTTP/1.0 206 Partial Content\r\n"
-#define STATUS_LINE_403 "HTTP/1.0 403 Forbidden\r\n"
-#define STATUS_LINE_404 "HTTP/1.0 404 Not Found\r\n"
-#define STATUS_LINE_416 "HTTP/1.0 416 Requested Range Not Satisfiable\r\n"
-#define STATUS_LINE_500 "HTTP/1.0 500 Internal Server Error\r\n"
-#define STATUS_LINE_503 "HTTP/1.0 503 Service Unavailable\r\n"
+#define STATUS_LINE_100 "HTTP/1.1 100 Continue\r\n"
+#define STATUS_LINE_200 "HTTP/1.1 200 OK\r\n"
+#define STATUS_LINE_201 "HTTP/1.1 201 Created\r\n"
+#define STATUS_LINE_206 "HTTP/1.1 206 Partial Content\r\n"
+#define STATUS_LINE_403 "HTTP/1.1 403 Forbidden\r\n"
+#define STATUS_LINE_404 "HTTP/1.1 404 Not Found\r\n"
+#define STATUS_LINE_416 "HTTP/1.1 416 Requested Range Not Satisfiable\r\n"
+#define STATUS_LINE_500 "HTTP/1.1 500 Internal Server Error\r\n"
+#define STATUS_LINE_503 "HTTP/1.1 503 Service Unavailable\r\n"
 
 namespace Transports
 {
   namespace HTTP
   {
-    // Maximum size of a request.
+    // Maximum size of a request header.
     static const unsigned c_max_request_size = 2048;
+    // Maximum size of a request body.
+    static const unsigned c_max_body_size = 65535;
 
     void
     RequestHandler::sendHeader(TCPSocket* sock, const char* status_line, int64_t length, HeaderFieldsMap* hdr_fields)
@@ -158,7 +160,7 @@ namespace Transports
 
       while (remaining > 0)
       {
-        rv = sock->write(data, size);
+        rv = sock->write(data + (size - remaining), remaining);
 
         if (rv < 0)
         {
@@ -226,91 +228,113 @@ namespace Transports
     }
 
     void
-    RequestHandler::handlePOST(TCPSocket* sock, Utils::TupleList& headers, const char* uri)
+    RequestHandler::handlePOST(TCPSocket* sock, Utils::TupleList& headers, const char* uri, const std::string& body)
     {
       (void)headers;
       (void)uri;
+      (void)body;
       sendResponse404(sock);
     }
 
     void
-    RequestHandler::handlePUT(TCPSocket* sock, Utils::TupleList& headers, const char* uri)
+    RequestHandler::handlePUT(TCPSocket* sock, Utils::TupleList& headers, const char* uri, const std::string& body)
     {
       (void)headers;
       (void)uri;
+      (void)body;
       sendResponse404(sock);
     }
 
-    void
-    RequestHandler::handleRequest(TCPSocket* sock)
+    bool
+    RequestHandler::handleConnection(Connection& conn)
     {
-      char mtd[16];
-      char uri[512];
-      char bfr[c_max_request_size] = {0};
-
-      // Search for end of request.
-      unsigned idx = 0;
-      unsigned didx = 0;
-      bool eor = false;
-      while (!eor && (idx < (c_max_request_size - 1)))
+      conn.receive();
+
+      TCPSocket* sock = conn.getSocket();
+      std::string& bfr = conn.getBuffer();
+
+      while (true)
       {
-        int rv = sock->read(bfr + idx, 1);
-
-        if (rv <= 0)
-          throw ConnectionClosed();
-
-        if (didx == 0 && bfr[idx] == '\r')
-          didx = 1;
-        else if (didx == 1 && bfr[idx] == '\n')
-          didx = 2;
-        else if (didx == 2 && bfr[idx] == '\r')
-          didx = 3;
-        else if (didx == 3 && bfr[idx] == '\n')
+        // Search for end of request header.
+        size_t eoh = bfr.find("\r\n\r\n");
+        if (eoh == std::string::npos)
         {
-          eor = true;
-          didx = 0;
+          if (bfr.size() < c_max_request_size)
+            return true;
+
+          DUNE_WRN("HTTP", "request too long");
+          return false;
         }
-        else
-          didx = 0;
 
-        ++idx;
-      }
+        if (eoh == 0)
+        {
+          DUNE_WRN("HTTP", "request too short");
+          return false;
+        }
 
-      // Get header.
-      int size = idx - 4;
-      if (size <= 0)
-      {
-        DUNE_WRN("HTTP", "request too short");
-        return;
-      }
+        std::string hdr = bfr.substr(0, eoh);
+        Utils::TupleList headers(hdr, ":", "\r\n", true);
 
-      char* hdr = new char[size + 1];
-      std::memcpy(hdr, bfr, size);
-      hdr[size] = 0;
+        // Wait for the whole body.
+        unsigned length = headers.get("content-length", 0u);
+        if (length > c_max_body_size)
+        {
+          DUNE_WRN("HTTP", "request body too long");
+          return false;
+        }
 
-      Utils::TupleList headers(hdr, ":", "\r\n", true);
+        if (bfr.size() < eoh + 4 + length)
+          return true;
+
+        std::string body = bfr.substr(eoh + 4, length);
+        bfr.erase(0, eoh + 4 + length);
+
+        // Parse request line.
+        char mtd[16];
+        char uri[512];
+        char version[16] = {0};
+        if (std::sscanf(hdr.c_str(), "%15s %511s %15s", mtd, uri, version) < 2)
+        {
+          DUNE_WRN("HTTP", "invalid request line");
+          return false;
+        }
+
+        // HTTP/1.1 connections are persistent unless the client asks
+        // otherwise, older versions are closed after each response.
+        std::string connection = headers.get("connection");
+        String::toLowerCase(connection);
+        bool keep_alive = (std::strcmp(version, "HTTP/1.1") == 0)
+        && (connection.find("close") == std::string::npos);
 
-      // Parse request line.
-      if (std::sscanf(hdr, "%s %s %*s", mtd, uri) == 2)
-      {
         std::string uri_dec = URL::decode(uri);
         const char* uri_clean = uri_dec.c_str();
 
         if (std::strcmp(mtd, "GET") == 0)
         {
+          if (handleStream(sock, headers, uri_clean))
+          {
+            conn.detach();
+            return false;
+          }
+
           handleGET(sock, headers, uri_clean);
         }
         else if (std::strcmp(mtd, "POST") == 0)
         {
-          handlePOST(sock, headers, uri_clean);
+          handlePOST(sock, headers, uri_clean, body);
         }
         else if (std::strcmp(mtd, "PUT") == 0)
         {
-          handlePUT(sock, headers, uri_clean);
+          handlePUT(sock, headers, uri_clean, body);
+        }
+        else
+        {
+          sendResponse403(sock);
         }
-      }
 
-      delete[] hdr;
+        if (!keep_alive)
+          return false;
+      }
     }
   }
 }
@@ -38,6 +38,9 @@
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
 
+// Local headers.
+#include "Connection.hpp"
+
 namespace Transports
 {
   namespace HTTP
@@ -60,10 +63,26 @@ namespace Transports
       handleGET(TCPSocket* sock, Utils::TupleList& headers, const char* uri);
 
       virtual void
-      handlePOST(TCPSocket* sock, Utils::TupleList& headers, const char* uri);
+      handlePOST(TCPSocket* sock, Utils::TupleList& headers, const char* uri, const std::string& body);
 
       virtual void
-      handlePUT(TCPSocket* sock, Utils::TupleList& headers, const char* uri);
+      handlePUT(TCPSocket* sock, Utils::TupleList& headers, const char* uri, const std::string& body);
+
+      //! Handle a GET request for a stream that keeps the connection
+      //! for itself.
+      //! @param sock client socket.
+      //! @param headers request headers.
+      //! @param uri request URI.
+      //! @return true if the handler took ownership of the socket,
+      //! false if the request must be handled by handleGET().
+      virtual bool
+      handleStream(TCPSocket* sock, Utils::TupleList& headers, const char* uri)
+      {
+        (void)sock;
+        (void)headers;
+        (void)uri;
+        return false;
+      }
 
       void
       sendHeader(TCPSocket* sock, const char* status_line, int64_t length, HeaderFieldsMap* hdr_fields = 0);
@@ -110,8 +129,13 @@ namespace Transports
       void
       sendFile(TCPSocket* sock, const std::string& file, HeaderFieldsMap& hdr_fields, int64_t off_beg = -1, int64_t off_end = -1);
 
-      void
-      handleRequest(TCPSocket* sock);
+      //! Read data from a readable connection and handle all the
+      //! complete requests it holds, in order.
+      //! @param conn client connection.
+      //! @return true if the connection should be kept open to wait
+      //! for more requests, false if it should be closed.
+      bool
+      handleConnection(Connection& conn);
     };
   }
 }
@@ -47,17 +47,22 @@ namespace Transports
 {
   namespace HTTP
   {
+    // Time in seconds after which an idle connection is closed.
+    static const double c_idle_timeout = 30.0;
+
     class Handler: public Concurrency::Thread
     {
     public:
-      Handler(RequestHandler& hdler, Concurrency::TSQueue<TCPSocket*>& queue):
+      Handler(Server& server, RequestHandler& hdler, Concurrency::TSQueue<Connection*>& queue):
+        m_server(server),
         m_handler(hdler),
         m_queue(queue)
       { }
 
     private:
+      Server& m_server;
       RequestHandler& m_handler;
-      Concurrency::TSQueue<TCPSocket*>& m_queue;
+      Concurrency::TSQueue<Connection*>& m_queue;
 
       void
       run(void)
@@ -70,32 +75,38 @@ namespace Transports
           if (m_queue.closed())
             break;
 
-          TCPSocket* sock = m_queue.pop();
-          if (!sock)
+          Connection* conn = m_queue.pop();
+          if (!conn)
             continue;
 
+          bool keep = false;
+
           try
           {
-            m_handler.handleRequest(sock);
+            keep = m_handler.handleConnection(*conn);
           }
           catch (...)
           { }
 
-          delete sock;
+          if (keep)
+            m_server.release(conn);
+          else
+            delete conn;
         }
       }
     };
 
     Server::Server(int port, unsigned threads, RequestHandler& handler):
-      m_handler(handler)
+      m_handler(handler),
+      m_last_sweep(Time::Clock::getReal())
     {
       m_sock.bind(port);
       m_sock.listen(1024);
-      m_poll.add(m_sock);
+      m_reactor.add(m_sock, IO::Reactor::EV_READ);
 
       for (unsigned int i = 0; i < threads; ++i)
       {
-        Concurrency::Thread* t = new Handler(handler, m_queue);
+        Concurrency::Thread* t = new Handler(*this, handler, m_queue);
         m_pool.push_back(t);
         t->start();
       }
@@ -119,30 +130,112 @@ namespace Transports
 
       while (!m_queue.empty())
       {
-        TCPSocket* sock = m_queue.pop();
-        if (sock)
-          delete sock;
+        Connection* conn = m_queue.pop();
+        if (conn)
+          delete conn;
+      }
+
+      for (unsigned i = 0; i < m_released.size(); ++i)
+        delete m_released[i];
+
+      std::set<Connection*>::iterator itr = m_idle.begin();
+      for (; itr != m_idle.end(); ++itr)
+        delete *itr;
+    }
+
+    void
+    Server::release(Connection* conn)
+    {
+      {
+        Concurrency::ScopedMutex l(m_released_lock);
+        m_released.push_back(conn);
+      }
+
+      m_reactor.wakeup();
+    }
+
+    void
+    Server::watch(Connection* conn)
+    {
+      try
+      {
+        m_reactor.add(*conn->getSocket(), IO::Reactor::EV_READ, conn);
+        m_idle.insert(conn);
+      }
+      catch (std::runtime_error& e)
+      {
+        DUNE_ERR("Server", e.what());
+        delete conn;
+      }
+    }
+
+    void
+    Server::sweep(void)
+    {
+      double now = Time::Clock::getReal();
+      if (now - m_last_sweep < 1.0)
+        return;
+
+      m_last_sweep = now;
+
+      std::set<Connection*>::iterator itr = m_idle.begin();
+      while (itr != m_idle.end())
+      {
+        Connection* conn = *itr;
+        if (now - conn->getLastActivity() < c_idle_timeout)
+        {
+          ++itr;
+          continue;
+        }
+
+        m_reactor.remove(*conn->getSocket());
+        m_idle.erase(itr++);
+        delete conn;
       }
     }
 
     void
     Server::poll(double timeout)
     {
-      if (m_poll.poll(timeout))
+      m_reactor.wait(timeout, m_events);
+
+      for (unsigned i = 0; i < m_events.size(); ++i)
       {
-        if (m_poll.wasTriggered(m_sock))
+        // The server socket is registered without user data.
+        if (m_events[i].data == 0)
         {
           try
           {
-            TCPSocket* nc = m_sock.accept();
-            m_queue.push(nc);
+            watch(new Connection(m_sock.accept()));
           }
           catch (std::runtime_error& e)
           {
             DUNE_ERR("Server", e.what());
           }
+
+          continue;
         }
+
+        // Stop watching a connection while a worker thread owns it.
+        Connection* conn = static_cast<Connection*>(m_events[i].data);
+        if (m_idle.erase(conn) == 0)
+          continue;
+
+        m_reactor.remove(*conn->getSocket());
+        m_queue.push(conn);
       }
+
+      std::vector<Connection*> released;
+      {
+        Concurrency::ScopedMutex l(m_released_lock);
+        released.swap(m_released);
+      }
+
+      // Data that arrived meanwhile is reported by the next wait.
+      for (unsigned i = 0; i < released.size(); ++i)
+        watch(released[i]);
+
+      sweep();
     }
   }
 }
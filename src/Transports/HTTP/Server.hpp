@@ -32,12 +32,14 @@
 
 // ISO C++ 98 headers.
 #include <vector>
+#include <set>
 
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
 
 // Local headers.
 #include "RequestHandler.hpp"
+#include "Connection.hpp"
 
 namespace Transports
 {
@@ -55,9 +57,29 @@ namespace Transports
       //! Destructor.
       ~Server(void);
 
+      //! Wait for and accept new connections, dispatch connections
+      //! with pending requests to the worker threads and close idle
+      //! connections.
+      //! @param timeout timeout in seconds.
       void
       poll(double timeout);
 
+      //! Give back a connection handled by a worker thread so that
+      //! the server waits for its next request. Can be called from any
+      //! thread.
+      //! @param conn client connection.
+      void
+      release(Connection* conn);
+
+      //! Retrieve the reactor used to wait for new connections, which
+      //! can be woken up to interrupt poll().
+      //! @return reactor.
+      IO::Reactor&
+      getReactor(void)
+      {
+        return m_reactor;
+      }
+
     private:
       //! HTTP request handler.
       RequestHandler& m_handler;
@@ -65,10 +87,26 @@ namespace Transports
       TCPSocket m_sock;
       //! Worker threads pool.
       std::vector<Concurrency::Thread*> m_pool;
-      //! Socket queue.
-      Concurrency::TSQueue<TCPSocket*> m_queue;
+      //! Queue of connections with pending requests.
+      Concurrency::TSQueue<Connection*> m_queue;
       //! I/O multiplexing.
-      IO::Poll m_poll;
+      IO::Reactor m_reactor;
+      //! Ready events.
+      std::vector<IO::Reactor::Event> m_events;
+      //! Idle connections waiting for requests.
+      std::set<Connection*> m_idle;
+      //! Connections given back by worker threads.
+      std::vector<Connection*> m_released;
+      //! Lock for released connections.
+      Concurrency::Mutex m_released_lock;
+      //! Time of the last check for stale connections.
+      double m_last_sweep;
+
+      void
+      watch(Connection* conn);
+
+      void
+      sweep(void);
     };
   }
 }
@@ -35,6 +35,7 @@
 #include <cstdlib>
 #include <algorithm>
 #include <cstddef>
+#include <set>
 
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
@@ -43,6 +44,7 @@
 #include "MessageMonitor.hpp"
 #include "RequestHandler.hpp"
 #include "Server.hpp"
+#include "EventStream.hpp"
 
 namespace Transports
 {
@@ -61,6 +63,8 @@ namespace Transports
       unsigned threads;
       //! List of messages to transport.
       std::vector<std::string> messages;
+      //! Minimum time between streamed updates of a message type.
+      double stream_period;
     };
 
     //! Buffer length.
@@ -78,6 +82,10 @@ namespace Transports
       std::string m_agent;
       //! Message Monitor.
       MessageMonitor m_msg_mon;
+      //! Streaming clients.
+      EventStream m_stream;
+      //! Streamed message updates.
+      std::vector<MessageMonitor::Update> m_updates;
       //! Task arguments.
       Arguments m_args;
 
@@ -100,6 +108,12 @@ namespace Transports
         .defaultValue("")
         .description("List of messages to transport");
 
+        param("Stream Period", m_args.stream_period)
+        .defaultValue("0.25")
+        .minimumValue("0.05")
+        .units(Units::Second)
+        .description("Minimum time between streamed updates of a message type");
+
         m_cfg_dir = ctx.dir_cfg.str();
         m_agent = getSystemName();
 
@@ -119,6 +133,7 @@ namespace Transports
           {
             inf(DTR("listening on %s:%u"), Address(Address::Any).c_str(), port);
             m_server = new Server(port, m_args.threads, *this);
+            wakeOnMessages(&m_server->getReactor());
 
             // Initialize and dispatch AnnounceService.
             std::vector<Interface> itfs = Interface::get();
@@ -151,6 +166,7 @@ namespace Transports
       void
       onResourceRelease(void)
       {
+        wakeOnMessages(NULL);
         Memory::clear(m_server);
       }
 
@@ -191,6 +207,57 @@ namespace Transports
         return (std::strcmp(url, str) == 0);
       }
 
+      bool
+      handleStream(TCPSocket* sock, TupleList& headers, const char* uri)
+      {
+        (void)headers;
+
+        if (!matchURL(uri, "/dune/state/stream", true))
+          return false;
+
+        debug("stream request: %s", uri);
+
+        // Messages are selected with "?messages=Abbrev1,Abbrev2".
+        std::set<unsigned> ids;
+        std::string query = String::getRemaining("/dune/state/stream", uri);
+        if (query.compare(0, 10, "?messages=") == 0)
+        {
+          std::vector<std::string> names;
+          String::split(query.substr(10), ",", names);
+
+          try
+          {
+            for (unsigned i = 0; i < names.size(); ++i)
+              ids.insert(IMC::Factory::getIdFromAbbrev(names[i]));
+          }
+          catch (std::runtime_error& e)
+          {
+            debug("%s", e.what());
+            return false;
+          }
+        }
+        else if (!query.empty())
+        {
+          return false;
+        }
+
+        std::vector<MessageMonitor::Update> snapshot;
+        m_msg_mon.getSnapshot(snapshot);
+        m_stream.subscribe(sock, ids, snapshot);
+        return true;
+      }
+
+      void
+      publishUpdates(void)
+      {
+        if (m_stream.empty())
+          return;
+
+        m_updates.clear();
+        m_msg_mon.getUpdates(m_args.stream_period, m_updates);
+        m_stream.publish(m_updates);
+      }
+
       void
       handleGET(TCPSocket* sock, TupleList& headers, const char* uri)
       {
@@ -210,6 +277,8 @@ namespace Transports
             handlePowerChannel(sock, headers, uri);
           else if (matchURL(uri, "/dune/state/logbook.js", true))
             showLogBook(sock, headers, uri);
+          else if (matchURL(uri, "/dune/state/delivery.js"))
+            showDeliveryStatistics(sock, headers, uri);
           else
             sendResponse404(sock);
         }
@@ -226,14 +295,16 @@ namespace Transports
       }
 
       void
-      handlePOST(TCPSocket* sock, TupleList& headers, const char* uri)
+      handlePOST(TCPSocket* sock, TupleList& headers, const char* uri, const std::string& body)
       {
         debug("POST request: %s", uri);
 
+        (void)headers;
+
         if (isSpecialURI(uri))
         {
           if (matchURL(uri, "/dune/messages/imc/", true))
-            getMessage(sock, headers, uri);
+            getMessage(sock, body);
           else
             sendResponse403(sock);
         }
@@ -244,11 +315,12 @@ namespace Transports
       }
 
       void
-      handlePUT(TCPSocket* sock, TupleList& headers, const char* uri)
+      handlePUT(TCPSocket* sock, TupleList& headers, const char* uri, const std::string& body)
       {
         debug("PUT request: %s", uri);
 
         (void)headers;
+        (void)body;
 
         if (isSpecialURI(uri))
         {
@@ -292,17 +364,13 @@ namespace Transports
       }
 
       void
-      getMessage(TCPSocket* sock, TupleList& headers, const char* uri)
+      getMessage(TCPSocket* sock, const std::string& body)
       {
-        (void)uri;
-
-        unsigned int size = headers.get("content-length", 0);
-        char* bfr = new char[size];
-        sock->read(bfr, size);
-        IMC::Message* msg = IMC::Packet::deserialize((uint8_t*)bfr, size);
+        IMC::Message* msg = IMC::Packet::deserialize((const uint8_t*)body.data(), (uint16_t)body.size());
         dispatch(msg, DF_KEEP_TIME);
         std::ostringstream ss;
         msg->toText(ss);
+        delete msg;
         sendData(sock, ss.str());
       }
 
@@ -354,6 +422,46 @@ namespace Transports
         sendData(sock, bfr->getBufferSigned(), bfr->getSize(), &hdr);
       }
 
+      void
+      showDeliveryStatistics(TCPSocket* sock, TupleList& headers, const char* uri)
+      {
+        (void)headers;
+        (void)uri;
+
+        std::vector<const IMC::DeliveryStatistics*> stats;
+        m_ctx.mbus.getStatistics(stats);
+
+        std::ostringstream os;
+        os << "var delivery = {\n"
+           << "  'dune_delivery': [";
+
+        for (size_t i = 0; i < stats.size(); ++i)
+        {
+          const IMC::DeliveryStatistics* s = stats[i];
+
+          os << (i == 0 ? "\n" : ",\n")
+             << "{\"task\": \"" << s->getTask()->getName() << "\""
+             << ", \"message\": \"" << IMC::Factory::getAbbrevFromId(s->getId()) << "\""
+             << ", \"enqueued\": " << s->getEnqueued()
+             << ", \"dequeued\": " << s->getDequeued()
+             << ", \"dropped\": " << s->getDropped()
+             << ", \"max_depth\": " << s->getMaxDepth()
+             << ", \"latency_us\": [";
+
+          for (unsigned j = 0; j < IMC::DeliveryStatistics::c_latency_buckets; ++j)
+            os << (j == 0 ? "" : ", ") << s->getLatency(j);
+
+          os << "]}";
+        }
+
+        os << "\n]"
+           << "\n};";
+
+        RequestHandler::HeaderFieldsMap hdr;
+        hdr["Content-Type"] = "text/javascript";
+        sendData(sock, os.str(), &hdr);
+      }
+
       void
       sendVersionJSON(TCPSocket* sock, TupleList& headers, const char* uri)
       {
@@ -454,8 +562,9 @@ namespace Transports
         while (!stopping())
         {
           setEntityState(IMC::EntityState::ESTA_NORMAL, Status::CODE_ACTIVE);
-          m_server->poll(1.0);
+          m_server->poll(std::min(m_args.stream_period, 1.0));
           consumeMessages();
+          publishUpdates();
         }
       }
     };
@@ -37,6 +37,9 @@
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
 
+// Local headers.
+#include "Writer.hpp"
+
 namespace Transports
 {
   namespace Logging
@@ -45,6 +48,8 @@ namespace Transports
 
     // Bytes per Mebibyte.
     static const unsigned c_bytes_per_mib = 1048576U;
+    // Bytes per Kibibyte.
+    static const unsigned c_bytes_per_kib = 1024U;
 
     struct Arguments
     {
@@ -58,6 +63,12 @@ namespace Transports
       unsigned lsf_volume_size;
       // Compression method.
       std::string lsf_compression;
+      // Size of writer buffers.
+      unsigned lsf_buffer_size;
+      // True to force data to the storage device after every write.
+      bool lsf_sync;
+      // Slice period of the LSF index.
+      double lsf_index_period;
     };
 
     struct Task: public Tasks::Task
@@ -72,10 +83,14 @@ namespace Transports
       std::string m_volume_dir;
       // Compression format.
       Compression::Methods m_compression;
-      // Output file stream for LSF/LSF_GZ formats.
-      std::ostream* m_lsf;
+      // Writer of LSF/LSF_GZ files.
+      Writer* m_lsf;
       // Path to LSF file.
       Path m_lsf_file;
+      // Index of the LSF file.
+      IMC::LsfIndex m_index;
+      // Number of bytes written to the LSF file.
+      uint64_t m_offset;
       // Serialization buffer.
       ByteBuffer m_buffer;
       // Logging control message.
@@ -84,12 +99,19 @@ namespace Transports
       bool m_active;
       // Task arguments.
       Arguments m_args;
+      // Bytes written at the time of the last flush.
+      uint64_t m_last_bytes;
+      // Time spent waiting for the writer at the time of the last flush.
+      double m_last_stall;
 
       Task(const std::string& name, Tasks::Context& ctx):
         Tasks::Task(name, ctx),
         m_last_flush(0),
         m_lsf(NULL),
-        m_active(true)
+        m_offset(0),
+        m_active(true),
+        m_last_bytes(0),
+        m_last_stall(0)
       {
         // Define configuration parameters.
         param("Flush Interval", m_args.flush_interval)
@@ -101,6 +123,22 @@ namespace Transports
         .defaultValue("none")
         .description("Compression method");
 
+        param("LSF Buffer Size", m_args.lsf_buffer_size)
+        .units(Units::Kibibyte)
+        .defaultValue("256")
+        .minimumValue("4")
+        .description("Size of each of the two buffers used to write the log file");
+
+        param("LSF Synchronize", m_args.lsf_sync)
+        .defaultValue("false")
+        .description("Force data to the storage device after every buffer write");
+
+        param("LSF Index Period", m_args.lsf_index_period)
+        .units(Units::Second)
+        .defaultValue("1.0")
+        .minimumValue("0.0")
+        .description("Log time spanned by each entry of the LSF index, 0 disables the index");
+
         param("LSF Volume Size", m_args.lsf_volume_size)
         .units(Units::Mebibyte)
         .defaultValue("0");
@@ -111,6 +149,11 @@ namespace Transports
         param("Transports", m_args.messages)
         .defaultValue("");
 
+        // Absorb bursts while the writer waits for the disk. Producers
+        // are never blocked by disk latency, messages discarded when
+        // the inbox is full are reported.
+        setInboxDefaults(8192, "Drop Oldest");
+
         m_log_ctl.setSource(getSystemId());
 
         bind<IMC::CacheControl>(this);
@@ -136,7 +179,22 @@ namespace Transports
       void
       onResourceRelease(void)
       {
+        if (m_lsf == NULL)
+          return;
+
         Memory::clear(m_lsf);
+
+        if (m_args.lsf_index_period <= 0)
+          return;
+
+        try
+        {
+          m_index.write(IMC::LsfIndex::getPath(m_lsf_file.str()));
+        }
+        catch (std::exception& e)
+        {
+          war("%s", e.what());
+        }
       }
 
       void
@@ -283,16 +341,23 @@ namespace Transports
       void
       logFile(const std::string& file)
       {
+        if (m_lsf == NULL)
+          return;
+
         std::ifstream ifs(file.c_str(), std::ios::binary);
 
         if (!ifs.is_open())
           return;
 
-        char bfr[16 * 1024];
-        while (!ifs.eof())
+        try
         {
-          ifs.read(bfr, sizeof(bfr));
-          m_lsf->write(bfr, ifs.gcount());
+          IMC::PacketView pkt;
+          while (pkt.read(ifs))
+            logPacket(pkt.getId(), pkt.getTimeStamp(), pkt.getData(), pkt.getSize());
+        }
+        catch (std::exception& e)
+        {
+          war(DTR("failed to log %s: %s"), file.c_str(), e.what());
         }
       }
 
@@ -350,10 +415,14 @@ namespace Transports
 
         m_lsf_file = m_dir / "Data.lsf" + Compression::Factory::extension(m_compression);
 
-        if (m_compression == METHOD_UNKNOWN)
-          m_lsf = new std::ofstream(m_lsf_file.c_str(), std::ios::binary);
-        else
-          m_lsf = new Compression::FileOutput(m_lsf_file.c_str(), m_compression);
+        m_lsf = new Writer(m_lsf_file, m_compression,
+                           m_args.lsf_buffer_size * c_bytes_per_kib,
+                           m_args.lsf_sync);
+        m_lsf->start();
+        m_index = IMC::LsfIndex(m_args.lsf_index_period);
+        m_offset = 0;
+        m_last_bytes = 0;
+        m_last_stall = 0;
 
         // Log LoggingControl to facilitate posterior conversion to LLF.
         m_log_ctl.op = IMC::LoggingControl::COP_STARTED;
@@ -376,11 +445,34 @@ namespace Transports
 
         if (now > (m_last_flush + m_args.flush_interval))
         {
+          if (m_lsf != NULL)
+            reportStatistics(now - m_last_flush);
+
           tryRotate();
           m_last_flush = now;
         }
       }
 
+      void
+      reportStatistics(double elapsed)
+      {
+        m_lsf->checkErrors();
+
+        uint64_t bytes = 0;
+        double stall = 0;
+        m_lsf->getStatistics(bytes, stall);
+
+        double rate = (bytes - m_last_bytes) / elapsed;
+        double stalled = stall - m_last_stall;
+        m_last_bytes = bytes;
+        m_last_stall = stall;
+
+        debug("writing %0.1f KiB/s, stalled %0.3f s", rate / c_bytes_per_kib, stalled);
+
+        if (stalled > 0)
+          war(DTR("log writer stalled for %0.3f s"), stalled);
+      }
+
       void
       tryRotate(void)
       {
@@ -424,8 +516,26 @@ namespace Transports
         if (m_lsf == NULL)
           return;
 
+        // Log the bytes the message was received with, if any.
+        const IMC::RawFrame& frame = msg->getRawFrame();
+        if (!frame.isNull())
+        {
+          logPacket(msg->getId(), msg->getTimeStamp(), frame.getData(), frame.getSize());
+          return;
+        }
+
         IMC::Packet::serialize(msg, m_buffer);
-        m_lsf->write(m_buffer.getBufferSigned(), m_buffer.getSize());
+        logPacket(msg->getId(), msg->getTimeStamp(), m_buffer.getBuffer(), m_buffer.getSize());
+      }
+
+      void
+      logPacket(uint16_t id, double timestamp, const uint8_t* data, size_t size)
+      {
+        if (m_args.lsf_index_period > 0)
+          m_index.add(id, timestamp, m_offset, size);
+
+        m_lsf->write((const char*)data, size);
+        m_offset += size;
       }
 
       void
@@ -0,0 +1,271 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+#ifndef TRANSPORTS_LOGGING_WRITER_HPP_INCLUDED_
+#define TRANSPORTS_LOGGING_WRITER_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cstddef>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+#if defined(DUNE_SYS_HAS_FDATASYNC) || defined(DUNE_SYS_HAS_FSYNC)
+// POSIX headers.
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+namespace Transports
+{
+  namespace Logging
+  {
+    using DUNE_NAMESPACES;
+
+    //! Writes a log file from a separate thread. Data is appended to
+    //! a front buffer by the task and, once the buffer is full, the
+    //! buffers are swapped and the back buffer is written (and
+    //! compressed) by the writer thread. The task only blocks if the
+    //! front buffer fills up while the writer thread is still busy
+    //! with the back buffer.
+    class Writer: public Concurrency::Thread
+    {
+    public:
+      //! Constructor.
+      //! @param[in] file log file.
+      //! @param[in] method compression method.
+      //! @param[in] capacity size of each buffer in bytes.
+      //! @param[in] sync true to force data to the storage device
+      //! after every write.
+      Writer(const Path& file, Compression::Methods method, size_t capacity, bool sync):
+        m_os(NULL),
+        m_fd(-1),
+        m_capacity(capacity),
+        m_back_busy(false),
+        m_flush(false),
+        m_stop(false),
+        m_bytes(0),
+        m_stall(0)
+      {
+        if (method == METHOD_UNKNOWN)
+          m_os = new std::ofstream(file.c_str(), std::ios::binary);
+        else
+          m_os = new Compression::FileOutput(file.c_str(), method);
+
+#if defined(DUNE_SYS_HAS_FDATASYNC) || defined(DUNE_SYS_HAS_FSYNC)
+        if (sync)
+          m_fd = ::open(file.c_str(), O_WRONLY);
+#else
+        (void)sync;
+#endif
+
+        m_front.reserve(m_capacity);
+        m_back.reserve(m_capacity);
+      }
+
+      //! Destructor. Writes all buffered data before closing the file.
+      ~Writer(void)
+      {
+        if (isCreated())
+        {
+          m_cond.lock();
+          m_stop = true;
+          m_cond.broadcast();
+          m_cond.unlock();
+          stopAndJoin();
+        }
+
+#if defined(DUNE_SYS_HAS_FDATASYNC) || defined(DUNE_SYS_HAS_FSYNC)
+        if (m_fd >= 0)
+          ::close(m_fd);
+#endif
+
+        delete m_os;
+      }
+
+      //! Append data to the log file.
+      //! @param[in] data data.
+      //! @param[in] size data size.
+      void
+      write(const char* data, size_t size)
+      {
+        ScopedCondition l(m_cond);
+
+        if (!m_front.empty() && m_front.size() + size > m_capacity)
+        {
+          if (m_back_busy)
+          {
+            double start = Clock::get();
+            while (m_back_busy)
+              m_cond.wait();
+            m_stall += Clock::get() - start;
+          }
+
+          m_front.swap(m_back);
+          m_back_busy = true;
+          m_cond.broadcast();
+        }
+
+        m_front.insert(m_front.end(), data, data + size);
+      }
+
+      //! Request buffered data to be written and flushed to the file.
+      //! This function does not wait for the request to be completed.
+      void
+      flush(void)
+      {
+        ScopedCondition l(m_cond);
+        m_flush = true;
+        m_cond.broadcast();
+      }
+
+      //! Retrieve writer statistics.
+      //! @param[out] bytes number of bytes written to the file (before
+      //! compression).
+      //! @param[out] stall time spent waiting for the writer thread,
+      //! in seconds.
+      void
+      getStatistics(uint64_t& bytes, double& stall)
+      {
+        ScopedCondition l(m_cond);
+        bytes = m_bytes;
+        stall = m_stall;
+      }
+
+      //! Check if the writer thread failed to write to the file.
+      //! @throw std::runtime_error if writing failed.
+      void
+      checkErrors(void)
+      {
+        ScopedCondition l(m_cond);
+        if (!m_error.empty())
+          throw std::runtime_error(m_error);
+      }
+
+    private:
+      //! Output stream.
+      std::ostream* m_os;
+      //! File descriptor used to synchronize the file.
+      int m_fd;
+      //! Buffer capacity.
+      size_t m_capacity;
+      //! Buffer filled by the task.
+      std::vector<char> m_front;
+      //! Buffer being written by the writer thread.
+      std::vector<char> m_back;
+      //! True if the back buffer is being written.
+      bool m_back_busy;
+      //! True if a flush was requested.
+      bool m_flush;
+      //! True if the writer thread must terminate.
+      bool m_stop;
+      //! Number of bytes written.
+      uint64_t m_bytes;
+      //! Time spent waiting for the writer thread.
+      double m_stall;
+      //! Last write error.
+      std::string m_error;
+      //! Condition protecting the fields above.
+      Condition m_cond;
+
+      void
+      run(void)
+      {
+        bool stop = false;
+
+        while (!stop)
+        {
+          bool flush = false;
+
+          m_cond.lock();
+          while (!m_back_busy && !m_flush && !m_stop)
+            m_cond.wait();
+
+          if (m_flush || m_stop)
+          {
+            flush = true;
+            m_flush = false;
+            stop = m_stop;
+
+            if (!m_back_busy && !m_front.empty())
+            {
+              m_front.swap(m_back);
+              m_back_busy = true;
+            }
+          }
+          m_cond.unlock();
+
+          // The back buffer is owned by this thread while busy.
+          size_t size = m_back.size();
+          if (size > 0)
+            m_os->write(&m_back[0], size);
+
+          if (flush || (m_fd >= 0 && size > 0))
+          {
+            m_os->flush();
+            sync();
+          }
+
+          m_cond.lock();
+          if (m_os->fail() && m_error.empty())
+            m_error = DTR("failed to write log file");
+          m_bytes += size;
+          m_back.clear();
+          m_back_busy = false;
+          m_cond.broadcast();
+
+          // Drain data appended while the last buffer was written.
+          if (stop && !m_front.empty())
+            stop = false;
+          m_cond.unlock();
+        }
+      }
+
+      //! Force written data to the storage device.
+      void
+      sync(void)
+      {
+#if defined(DUNE_SYS_HAS_FDATASYNC)
+        if (m_fd >= 0)
+          ::fdatasync(m_fd);
+#elif defined(DUNE_SYS_HAS_FSYNC)
+        if (m_fd >= 0)
+          ::fsync(m_fd);
+#endif
+      }
+    };
+  }
+}
+
+#endif
@@ -31,6 +31,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
 #include <fstream>
 
 // DUNE headers.
@@ -47,9 +48,15 @@ namespace Transports
       std::string startup_file;
       std::vector<std::string> msgs;
       std::vector<std::string> ents;
+      double start_offset;
+      double speed;
+      bool stop_at_end;
     };
 
     static const int c_stats_period = 10;
+    //! Maximum real time to wait for consumers before each step of a
+    //! stepped replay.
+    static const double c_idle_timeout = 5.0;
 
     struct Task: public DUNE::Tasks::Task
     {
@@ -64,11 +71,17 @@ namespace Transports
       typedef std::map<uint8_t, uint8_t> Eid2Eid;
       Eid2Eid m_eid2eid;
 
-      typedef std::map<std::string, bool> ReplayMsg;
+      typedef std::set<uint32_t> ReplayMsg;
       ReplayMsg m_replay;
 
       double m_ts_delta;
       double m_start_time;
+      // True if the replay drives the virtual clock.
+      bool m_virtual;
+      // True if consumers did not keep up with a stepped replay.
+      bool m_overrun;
+      // True while replaying the startup file.
+      bool m_startup;
 
       // Replay file handle
       std::istream* m_is;
@@ -96,6 +109,9 @@ namespace Transports
 
       Task(const std::string& name, Tasks::Context& ctx):
         Tasks::Task(name, ctx),
+        m_virtual(false),
+        m_overrun(false),
+        m_startup(false),
         m_is(0)
       {
         param("Load At Start", m_args.startup_file)
@@ -110,6 +126,23 @@ namespace Transports
         .defaultValue("")
         .description("Entities for which state should be reported");
 
+        param("Start Offset", m_args.start_offset)
+        .defaultValue("0.0")
+        .minimumValue("0.0")
+        .units(Units::Second)
+        .description("Log time to skip at the start of a replay, requires the log index");
+
+        param("Speed", m_args.speed)
+        .defaultValue("1.0")
+        .minimumValue("0.0")
+        .description("Replay speed relative to log time, zero to replay as fast as"
+                     " consumers handle each message. Other values than one make the"
+                     " replay drive the system clock");
+
+        param("Stop At End", m_args.stop_at_end)
+        .defaultValue("false")
+        .description("Stop the system when the replay of the startup file finishes");
+
         bind<IMC::ReplayControl>(this);
       }
 
@@ -117,9 +150,18 @@ namespace Transports
       onUpdateParameters(void)
       {
         for (unsigned i = 0; i < m_args.msgs.size(); ++i)
-          m_replay[m_args.msgs[i]] = true;
+        {
+          try
+          {
+            m_replay.insert(IMC::Factory::getIdFromAbbrev(m_args.msgs[i]));
+          }
+          catch (std::runtime_error& e)
+          {
+            war("%s", e.what());
+          }
+        }
 
-        if (m_replay.find("EstimatedState") == m_replay.end())
+        if (m_replay.find(DUNE_IMC_ESTIMATEDSTATE) == m_replay.end())
           bind<IMC::EstimatedState>(this);
 
         reset();
@@ -173,6 +215,7 @@ namespace Transports
         switch (rc->op)
         {
           case IMC::ReplayControl::ROP_START:
+            m_startup = false;
             startReplay(rc->file);
             break;
           case IMC::ReplayControl::ROP_STOP:
@@ -207,9 +250,10 @@ namespace Transports
           return;
         }
 
+        Compression::Methods method = Compression::Factory::detect(file.c_str());
+
         try
         {
-          Compression::Methods method = Compression::Factory::detect(file.c_str());
           if (method == Compression::METHOD_UNKNOWN)
             m_is = new std::ifstream(file.c_str(), std::ios::binary);
           else
@@ -252,6 +296,8 @@ namespace Transports
         IMC::LoggingControl* lc = static_cast<IMC::LoggingControl*>(m);
 
         m_ts_delta = lc->getTimeStamp();
+        double log_start = lc->getTimeStamp();
+        uint64_t offset = lc->getSerializationSize();
 
         size_t spos = lc->name.find_last_of('/');
         if (spos != std::string::npos)
@@ -259,6 +305,15 @@ namespace Transports
         lc->name += "_replay";
 
         lc->op = IMC::LoggingControl::COP_REQUEST_START;
+
+        // Run the system clock on log time.
+        m_virtual = (m_args.speed != 1.0);
+        if (m_virtual)
+        {
+          Clock::startVirtual(log_start, m_args.speed);
+          inf("%s %0.1f", DTR("replaying at speed"), m_args.speed);
+        }
+
         dispatch(lc); // change log (if Logging task happens to be active)
 
         m_ts_delta = lc->getTimeStamp() - m_ts_delta;
@@ -266,11 +321,141 @@ namespace Transports
         m_next_stats = m_start_time + c_stats_period;
         delete m;
 
+        if (m_args.start_offset > 0)
+        {
+          try
+          {
+            skipReplay(file, method, log_start + m_args.start_offset, offset);
+
+            if (m_virtual)
+              Clock::setVirtual(log_start + m_args.start_offset);
+            else
+              m_ts_delta -= m_args.start_offset;
+          }
+          catch (std::exception& e)
+          {
+            war("%s: %s", DTR("replaying from start"), e.what());
+          }
+        }
+
         requestActivation();
 
         war("%s '%s'", DTR("started replay of"), file.c_str());
       }
 
+      //! Skip the log up to a given time using the log index. Entity
+      //! information logged before that time is still processed. An
+      //! uncompressed log that does not match the size of its index
+      //! is read sequentially instead.
+      //! @param[in] file log file.
+      //! @param[in] method compression method of the log.
+      //! @param[in] time log time to skip to.
+      //! @param[in] offset current offset in the log.
+      void
+      skipReplay(const std::string& file, Compression::Methods method, double time, uint64_t offset)
+      {
+        IMC::LsfIndex index;
+        index.read(IMC::LsfIndex::getPath(file));
+
+        if (method == Compression::METHOD_UNKNOWN
+            && index.getLogSize() != (uint64_t)FileSystem::Path(file).size())
+        {
+          war(DTR("log index does not match the log, skipping sequentially"));
+          skipSequential(time);
+          return;
+        }
+
+        std::set<uint16_t> ids;
+        ids.insert(DUNE_IMC_ENTITYINFO);
+        std::vector<IMC::LsfIndex::Range> ranges;
+        index.getRanges(ids, 0, time, ranges);
+
+        IMC::PacketView pkt;
+        for (size_t i = 0; i < ranges.size(); ++i)
+        {
+          if (ranges[i].first < offset)
+            ranges[i].first = offset;
+
+          skipTo(method, offset, ranges[i].first);
+          while (offset < ranges[i].second && pkt.read(*m_is))
+          {
+            offset += pkt.getSize();
+            if (pkt.getId() != DUNE_IMC_ENTITYINFO)
+              continue;
+
+            IMC::EntityInfo ei;
+            pkt.materialize(&ei);
+            updateEntityMap(&ei);
+          }
+        }
+
+        ids.clear();
+        index.getRanges(ids, time, time, ranges);
+        if (!ranges.empty())
+          skipTo(method, offset, ranges.front().first);
+      }
+
+      //! Skip the log up to a given time reading every packet. Entity
+      //! information logged before that time is still processed. Only
+      //! used with uncompressed logs, which can be rewound.
+      //! @param[in] time log time to skip to.
+      void
+      skipSequential(double time)
+      {
+        IMC::PacketView pkt;
+        std::streampos pos = m_is->tellg();
+
+        while (pkt.read(*m_is))
+        {
+          if (pkt.getTimeStamp() >= time)
+          {
+            m_is->seekg(pos);
+            return;
+          }
+
+          if (pkt.getId() == DUNE_IMC_ENTITYINFO)
+          {
+            IMC::EntityInfo ei;
+            pkt.materialize(&ei);
+            updateEntityMap(&ei);
+          }
+
+          pos = m_is->tellg();
+        }
+      }
+
+      //! Move forward in the log.
+      //! @param[in] method compression method of the log.
+      //! @param[in,out] offset current offset in the log.
+      //! @param[in] target offset to move to.
+      void
+      skipTo(Compression::Methods method, uint64_t& offset, uint64_t target)
+      {
+        if (target <= offset)
+          return;
+
+        if (method == Compression::METHOD_UNKNOWN)
+          m_is->seekg(target);
+        else
+          m_is->ignore(target - offset);
+
+        offset = target;
+      }
+
+      void
+      updateEntityMap(const IMC::EntityInfo* ei)
+      {
+        // Update entity id map
+        Name2Eid::iterator itr = m_name2eid.find(ei->label);
+
+        if (itr != m_name2eid.end())
+        {
+          m_eid2eid[ei->id] = itr->second;
+
+          trace("entity %s %d --> %d", ei->label.c_str(), (int)ei->id, (int)itr->second);
+        }
+      }
+
       void
       stopReplay(void)
       {
@@ -324,13 +509,26 @@ namespace Transports
         m_eid2eid.clear();
         m_tstats.clear();
         m_tgstats = Stats();
+
+        if (m_virtual)
+        {
+          Clock::stopVirtual();
+          m_virtual = false;
+        }
+
+        m_overrun = false;
       }
 
       void
       onMain(void)
       {
         if (!m_args.startup_file.empty())
+        {
+          m_startup = true;
           startReplay(m_args.startup_file);
+          if (m_is == 0)
+            stopSystem();
+        }
 
         while (!stopping())
         {
@@ -345,34 +543,34 @@ namespace Transports
           if (!isActive())
             continue;
 
-          IMC::Message* m = 0;
+          IMC::PacketView pkt;
 
-          while (!stopping() && (m = DUNE::IMC::Packet::deserialize(*m_is)) != 0 && !m_is->eof())
+          while (!stopping() && pkt.read(*m_is))
           {
             consumeMessages();
 
+            // Only deserialize messages that are going to be used.
+            uint16_t id = pkt.getId();
+            if (id != DUNE_IMC_ESTIMATEDSTATE && id != DUNE_IMC_ENTITYINFO
+                && m_replay.find(id) == m_replay.end()
+                && (id != DUNE_IMC_ENTITYSTATE || mapEntity(pkt.getSourceEntity()) == DUNE_IMC_CONST_UNK_EID))
+              continue;
+
+            IMC::Message* m = pkt.materialize();
+
             if (m->getId() == DUNE_IMC_ESTIMATEDSTATE)
             {
               m_estate = *static_cast<IMC::EstimatedState*>(m);
             }
             else if (m->getId() == DUNE_IMC_ENTITYINFO)
             {
-              // Update entity id map
-              IMC::EntityInfo* ei = static_cast<IMC::EntityInfo*>(m);
-              Name2Eid::iterator itr = m_name2eid.find(ei->label);
-
-              if (itr != m_name2eid.end())
-              {
-                m_eid2eid[ei->id] = itr->second;
-
-                trace("entity %s %d --> %d", ei->label.c_str(), (int)ei->id, (int)itr->second);
-              }
+              updateEntityMap(static_cast<IMC::EntityInfo*>(m));
             }
 
             m->setSourceEntity(mapEntity(m->getSourceEntity()));
             m->setDestinationEntity(mapEntity(m->getDestinationEntity()));
 
-            if ((m->getId() == DUNE_IMC_ENTITYSTATE && m->getSourceEntity() != DUNE_IMC_CONST_UNK_EID) || m_replay.find(m->getName()) != m_replay.end())
+            if ((m->getId() == DUNE_IMC_ENTITYSTATE && m->getSourceEntity() != DUNE_IMC_CONST_UNK_EID) || m_replay.find(m->getId()) != m_replay.end())
             {
               double original_ts;
 
@@ -390,11 +588,24 @@ namespace Transports
 
               double delay;
 
-              if (delta >= 1e-03)
+              if (m_virtual && m_args.speed <= 0)
+              {
+                // Unbounded speed: move the clock to the message and
+                // wait for consumers to handle previous messages and
+                // periodic runs due up to now, so that messages are
+                // not discarded and each step sees the same state.
+                Clock::setVirtual(new_ts);
+                waitConsumers();
+                delay = 0;
+              }
+              else if (delta >= 1e-03)
               {
                 // Delay::wait does not behave satisfactorily otherwise
                 // in some systems
-                Delay::wait(delta);
+                if (m_virtual)
+                  Clock::waitVirtual(delta);
+                else
+                  Delay::wait(delta);
                 delay = Clock::getSinceEpoch() - new_ts;
               }
               else
@@ -419,15 +630,44 @@ namespace Transports
               spew("%s %0.4f %s", m->getName(), (new_ts - m_start_time),
                    m_eid2name[m->getSourceEntity()].c_str());
             }
+
+            delete m;
           }
 
+          if (m_virtual && m_args.speed <= 0)
+            waitConsumers();
+
           stopReplay();
 
-          // Clean up
-          delete m;
+          if (m_startup && !stopping())
+            stopSystem();
         }
       }
 
+      //! Wait for consumers of replayed messages to become idle.
+      void
+      waitConsumers(void)
+      {
+        if (m_ctx.mbus.waitIdle(c_idle_timeout, this) || m_overrun)
+          return;
+
+        war(DTR("consumers did not keep up with the replay"));
+        m_overrun = true;
+      }
+
+      //! Stop the system if so configured.
+      void
+      stopSystem(void)
+      {
+        if (!m_args.stop_at_end)
+          return;
+
+        war(DTR("stopping system"));
+        IMC::RestartSystem restart;
+        restart.setDestination(getSystemId());
+        dispatch(restart);
+      }
+
       void
       updateStats(Stats& s, double delay)
       {
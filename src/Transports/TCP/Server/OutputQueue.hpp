@@ -0,0 +1,278 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+#ifndef TRANSPORTS_TCP_SERVER_OUTPUT_QUEUE_HPP_INCLUDED_
+#define TRANSPORTS_TCP_SERVER_OUTPUT_QUEUE_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cstddef>
+#include <deque>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+namespace Transports
+{
+  namespace TCP
+  {
+    namespace Server
+    {
+      using DUNE_NAMESPACES;
+
+      //! Maximum number of messages written in a single call.
+      static const size_t c_max_batch = 32;
+
+      //! Bounded queue of messages waiting to be sent to a client.
+      //! Messages are shared between the queues of all clients and
+      //! written with gather writes that never block. When the queue
+      //! is full, low priority messages are dropped, oldest first.
+      class OutputQueue
+      {
+      public:
+        //! Constructor.
+        //! @param[in] capacity maximum number of queued bytes.
+        OutputQueue(size_t capacity = 0):
+          m_capacity(capacity),
+          m_bytes(0),
+          m_offset(0)
+        {
+          resetStatistics();
+        }
+
+        //! Queue a message.
+        //! @param[in] frame serialized message.
+        //! @param[in] priority true if the message must not be
+        //! dropped.
+        //! @param[in] time time at which the message was queued.
+        //! @return false if the message could not be queued without
+        //! dropping priority messages, true otherwise.
+        bool
+        push(const IMC::RawFrame& frame, bool priority, double time)
+        {
+          if (!makeRoom(frame.getSize()))
+          {
+            if (priority)
+              return false;
+
+            ++m_dropped;
+            return true;
+          }
+
+          Entry entry;
+          entry.frame = frame;
+          entry.priority = priority;
+          entry.time = time;
+          m_entries.push_back(entry);
+          m_bytes += frame.getSize();
+          return true;
+        }
+
+        //! Write as many queued messages as the socket takes.
+        //! @param[in] sock client socket.
+        //! @param[in] time current time.
+        //! @throw std::runtime_error on socket errors.
+        void
+        flush(TCPSocket& sock, double time)
+        {
+          while (!m_entries.empty())
+          {
+            const uint8_t* bfrs[c_max_batch];
+            size_t sizes[c_max_batch];
+            size_t count = 0;
+            size_t offset = m_offset;
+
+            std::deque<Entry>::const_iterator itr = m_entries.begin();
+            for (; itr != m_entries.end() && count < c_max_batch; ++itr, ++count)
+            {
+              bfrs[count] = itr->frame.getData() + offset;
+              sizes[count] = itr->frame.getSize() - offset;
+              offset = 0;
+            }
+
+            size_t n = sock.writeNonBlocking(bfrs, sizes, count);
+            if (n == 0)
+              return;
+
+            consume(n, time);
+          }
+        }
+
+        //! Test if the queue is empty.
+        //! @return true if the queue is empty.
+        bool
+        empty(void) const
+        {
+          return m_entries.empty();
+        }
+
+        //! Retrieve the number of queued bytes.
+        //! @return number of bytes.
+        size_t
+        getSize(void) const
+        {
+          return m_bytes;
+        }
+
+        //! Retrieve the number of messages dropped since the last
+        //! call to resetStatistics().
+        //! @return number of messages.
+        unsigned
+        getDropped(void) const
+        {
+          return m_dropped;
+        }
+
+        //! Retrieve the number of messages sent since the last call
+        //! to resetStatistics().
+        //! @return number of messages.
+        unsigned
+        getSent(void) const
+        {
+          return m_sent;
+        }
+
+        //! Retrieve the mean time messages sent since the last call
+        //! to resetStatistics() were queued.
+        //! @return latency in seconds.
+        double
+        getMeanLatency(void) const
+        {
+          return (m_sent == 0) ? 0 : m_latency_sum / m_sent;
+        }
+
+        //! Retrieve the maximum time messages sent since the last call
+        //! to resetStatistics() were queued.
+        //! @return latency in seconds.
+        double
+        getMaxLatency(void) const
+        {
+          return m_latency_max;
+        }
+
+        //! Reset statistics.
+        void
+        resetStatistics(void)
+        {
+          m_dropped = 0;
+          m_sent = 0;
+          m_latency_sum = 0;
+          m_latency_max = 0;
+        }
+
+      private:
+        //! Queued message.
+        struct Entry
+        {
+          //! Serialized message.
+          IMC::RawFrame frame;
+          //! True if the message must not be dropped.
+          bool priority;
+          //! Time at which the message was queued.
+          double time;
+        };
+
+        //! Queued messages.
+        std::deque<Entry> m_entries;
+        //! Maximum number of queued bytes.
+        size_t m_capacity;
+        //! Number of queued bytes.
+        size_t m_bytes;
+        //! Bytes of the first message already written.
+        size_t m_offset;
+        //! Number of dropped messages.
+        unsigned m_dropped;
+        //! Number of sent messages.
+        unsigned m_sent;
+        //! Sum of the latencies of sent messages.
+        double m_latency_sum;
+        //! Maximum latency of sent messages.
+        double m_latency_max;
+
+        //! Drop low priority messages until there is room for a new
+        //! message. A partially written message is never dropped.
+        //! @param[in] size size of the new message.
+        //! @return true if there is room for the message.
+        bool
+        makeRoom(size_t size)
+        {
+          std::deque<Entry>::iterator itr = m_entries.begin();
+          if (m_offset > 0 && itr != m_entries.end())
+            ++itr;
+
+          while (m_bytes + size > m_capacity && itr != m_entries.end())
+          {
+            if (itr->priority)
+            {
+              ++itr;
+              continue;
+            }
+
+            m_bytes -= itr->frame.getSize();
+            itr = m_entries.erase(itr);
+            ++m_dropped;
+          }
+
+          return m_bytes + size <= m_capacity;
+        }
+
+        //! Remove written data from the queue.
+        //! @param[in] n number of bytes written.
+        //! @param[in] time current time.
+        void
+        consume(size_t n, double time)
+        {
+          while (n > 0)
+          {
+            Entry& entry = m_entries.front();
+            size_t remaining = entry.frame.getSize() - m_offset;
+
+            if (n < remaining)
+            {
+              m_offset += n;
+              return;
+            }
+
+            n -= remaining;
+            m_offset = 0;
+
+            double latency = time - entry.time;
+            m_latency_sum += latency;
+            if (latency > m_latency_max)
+              m_latency_max = latency;
+            ++m_sent;
+
+            m_bytes -= entry.frame.getSize();
+            m_entries.pop_front();
+          }
+        }
+      };
+    }
+  }
+}
+
+#endif
@@ -27,9 +27,15 @@
 // Author: Eduardo Marques                                                  *
 //***************************************************************************
 
+// ISO C++ 98 headers.
+#include <set>
+
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
 
+// Local headers.
+#include "OutputQueue.hpp"
+
 namespace Transports
 {
   namespace TCP
@@ -45,6 +51,14 @@ namespace Transports
         uint16_t port;
         //! True to announce service.
         bool announce;
+        //! Size of the output queue of each client.
+        unsigned queue_size;
+        //! Policy for clients that cannot keep up.
+        std::string slow_policy;
+        //! Messages that are never dropped.
+        std::vector<std::string> priority;
+        //! Period of client statistics reports.
+        double stats_period;
       };
 
       struct Task: public Tasks::SimpleTransport
@@ -55,8 +69,12 @@ namespace Transports
         static const int c_port_retries = 5;
         // Server socket handle.
         TCPSocket* m_sock;
-        // I/O selector.
-        Poll m_poll;
+        // Ready events.
+        std::vector<Reactor::Event> m_events;
+        // Identifiers of messages that are never dropped.
+        std::set<uint16_t> m_priority;
+        // Statistics report timer.
+        Counter<double> m_stats_timer;
 
         // Client data.
         struct Client
@@ -65,6 +83,8 @@ namespace Transports
           Address address; // Client address.
           uint16_t port; // Client port.
           IMC::Parser parser; // Parser handle
+          OutputQueue queue; // Output queue.
+          bool writing; // True if waiting for room in the socket.
         };
 
         // Client list.
@@ -82,6 +102,49 @@ namespace Transports
           param("Announce Service", m_args.announce)
           .defaultValue("true")
           .description("Set to true to announce the service");
+
+          param("Client Queue Size", m_args.queue_size)
+          .defaultValue("256")
+          .minimumValue("64")
+          .units(Units::Kibibyte)
+          .description("Amount of outgoing data queued for each client");
+
+          param("Slow Client Policy", m_args.slow_policy)
+          .defaultValue("Drop")
+          .values("Drop, Disconnect")
+          .description("What to do when the queue of a client is full: drop"
+                       " messages that are not in the priority list, oldest"
+                       " first, or disconnect the client");
+
+          param("Priority Messages", m_args.priority)
+          .defaultValue("Abort, PlanControl, PlanDB, VehicleCommand")
+          .description("Messages that are never dropped, clients that"
+                       " cannot keep up with them are disconnected");
+
+          param("Statistics Period", m_args.stats_period)
+          .defaultValue("10.0")
+          .minimumValue("1.0")
+          .units(Units::Second)
+          .description("Period of client statistics reports");
+        }
+
+        void
+        onUpdateParameters(void)
+        {
+          m_priority.clear();
+          for (unsigned i = 0; i < m_args.priority.size(); ++i)
+          {
+            try
+            {
+              m_priority.insert(IMC::Factory::getIdFromAbbrev(m_args.priority[i]));
+            }
+            catch (...)
+            {
+              war(DTR("unknown message '%s'"), m_args.priority[i].c_str());
+            }
+          }
+
+          m_stats_timer.setTop(m_args.stats_period);
         }
 
         ~Task(void)
@@ -118,7 +181,8 @@ namespace Transports
           }
 
           m_sock->listen(5);
-          m_poll.add(*m_sock);
+          // The server socket is the only one registered without a client.
+          getReactor().add(*m_sock, Reactor::EV_READ);
           inf(DTR("listening on %s:%u"), Address(Address::Any).c_str(), m_args.port);
 
           if (m_args.announce)
@@ -170,17 +234,36 @@ namespace Transports
 
           debug("closing connection to %s:%u (%s), client count is %lu",
                 c.address.c_str(), c.port, e.what(), client_count);
+          reportStatistics(c);
 
-          m_poll.remove(*c.socket);
+          getReactor().remove(*c.socket);
           delete c.socket;
         }
 
+        //! Close the connection to a client and remove it from the
+        //! client list.
+        //! @param[in] c client.
+        //! @param[in] e reason.
+        void
+        removeClient(Client* c, std::exception& e)
+        {
+          for (ClientList::iterator itr = m_clients.begin(); itr != m_clients.end(); ++itr)
+          {
+            if (&(*itr) == c)
+            {
+              closeConnection(*itr, e);
+              m_clients.erase(itr);
+              return;
+            }
+          }
+        }
+
         void
         onResourceRelease(void)
         {
           for (ClientList::iterator itr = m_clients.begin(); itr != m_clients.end(); ++itr)
           {
-            m_poll.remove(*itr->socket);
+            getReactor().remove(*itr->socket);
             delete itr->socket;
           }
 
@@ -188,7 +271,7 @@ namespace Transports
 
           if (m_sock)
           {
-            m_poll.remove(*m_sock);
+            getReactor().remove(*m_sock);
             delete m_sock;
             m_sock = 0;
           }
@@ -197,13 +280,28 @@ namespace Transports
         void
         onDataTransmission(const uint8_t* p, unsigned int n)
         {
+          if (m_clients.empty())
+            return;
+
+          // The same copy of the message is queued for all clients.
+          IMC::RawFrame frame(p, n);
+          bool priority = m_priority.find(IMC::PacketView(p, n).getId()) != m_priority.end();
+          bool drop = m_args.slow_policy == "Drop";
+          double now = Clock::get();
+
           ClientList::iterator itr = m_clients.begin();
 
           while (itr != m_clients.end())
           {
+            unsigned dropped = itr->queue.getDropped();
+
             try
             {
-              itr->socket->write((char*)p, n);
+              if (!itr->queue.push(frame, priority, now)
+                  || (!drop && itr->queue.getDropped() != dropped))
+                throw std::runtime_error(DTR("client is too slow"));
+
+              flushClient(*itr, now);
             }
             catch (std::runtime_error& e)
             {
@@ -215,79 +313,125 @@ namespace Transports
           }
         }
 
+        //! Send queued data to a client and wait for room in its
+        //! socket while data remains queued.
+        //! @param[in] c client.
+        //! @param[in] now current time.
         void
-        onDataReception(uint8_t* buf, unsigned int cap, double timeout)
+        flushClient(Client& c, double now)
         {
-          // Poll for connections and client data
-          if (!m_poll.poll(timeout))
+          c.queue.flush(*c.socket, now);
+
+          bool writing = !c.queue.empty();
+          if (writing == c.writing)
             return;
 
-          // Check for new clients.
-          if (m_poll.wasTriggered(*m_sock))
-            acceptNewClient();
+          unsigned events = Reactor::EV_READ;
+          if (writing)
+            events |= Reactor::EV_WRITE;
 
-          // Check for client data
-          handleClients(buf, cap);
+          getReactor().modify(*c.socket, events);
+          c.writing = writing;
         }
 
+        //! Report the statistics of a client and reset them.
+        //! @param[in] c client.
         void
-        acceptNewClient(void)
+        reportStatistics(Client& c)
         {
-          Client c;
-          c.socket = 0;
-          try
-          {
-            c.socket = m_sock->accept(&c.address, &c.port);
-            c.socket->setKeepAlive(true);
-            c.socket->setNoDelay(true);
-            c.socket->setReceiveTimeout(5);
-            c.socket->setSendTimeout(5);
-            m_poll.add(*c.socket);
-            m_clients.push_back(c);
-            updateEntityState(m_clients.size());
+          OutputQueue& q = c.queue;
 
-            debug("accepted connection from %s:%u, client count is %lu",
-                  c.address.c_str(), c.port, (long unsigned int)m_clients.size());
-          }
-          catch (std::runtime_error& e)
+          if (q.getDropped() > 0)
           {
-            if (c.socket)
-              delete c.socket;
-            err(DTR("error accepting new client connection: %s"), e.what());
+            war(DTR("%s:%u: dropped %u messages"), c.address.c_str(), c.port, q.getDropped());
           }
+
+          debug("%s:%u: sent %u, dropped %u, queued %u bytes, latency mean %0.3f s, max %0.3f s",
+                c.address.c_str(), c.port, q.getSent(), q.getDropped(),
+                (unsigned)q.getSize(), q.getMeanLatency(), q.getMaxLatency());
+
+          q.resetStatistics();
         }
 
         void
-        handleClients(uint8_t* buf, unsigned int cap)
+        onDataReception(uint8_t* buf, unsigned int cap, double timeout)
         {
-          // Check for new data from clients.
-          ClientList::iterator itr = m_clients.begin();
+          if (m_stats_timer.overflow())
+          {
+            for (ClientList::iterator itr = m_clients.begin(); itr != m_clients.end(); ++itr)
+              reportStatistics(*itr);
 
-          while (itr != m_clients.end())
+            m_stats_timer.reset();
+          }
+
+          // Wait for connections, client data and room in client sockets.
+          if (getReactor().wait(timeout, m_events) == 0)
+            return;
+
+          for (size_t i = 0; i < m_events.size(); ++i)
           {
-            if (!m_poll.wasTriggered(*itr->socket))
+            Client* c = static_cast<Client*>(m_events[i].data);
+            if (c == NULL)
             {
-              ++itr;
+              acceptNewClient();
               continue;
             }
 
-            int n;
-
             try
             {
-              n = itr->socket->read((char*)buf, cap);
+              if (m_events[i].events & Reactor::EV_WRITE)
+                flushClient(*c, Clock::get());
+
+              // Errors are reported as readiness and raised by read().
+              if (m_events[i].events & Reactor::EV_READ)
+              {
+                int n = c->socket->read((char*)buf, cap);
+                if (n > 0)
+                  handleData(c->parser, buf, n);
+              }
             }
             catch (std::runtime_error& e)
             {
-              closeConnection(*itr, e);
-              itr = m_clients.erase(itr);
-              continue;
+              removeClient(c, e);
             }
+          }
+        }
 
-            if (n > 0)
-              handleData(itr->parser, buf, n);
+        void
+        acceptNewClient(void)
+        {
+          Client c;
+          c.socket = 0;
+          try
+          {
+            c.socket = m_sock->accept(&c.address, &c.port);
+            c.socket->setKeepAlive(true);
+            c.socket->setNoDelay(true);
+            c.socket->setReceiveTimeout(5);
+            c.queue = OutputQueue(m_args.queue_size * 1024);
+            c.writing = false;
+            m_clients.push_back(c);
 
-            ++itr;
+            try
+            {
+              getReactor().add(*c.socket, Reactor::EV_READ, &m_clients.back());
+            }
+            catch (...)
+            {
+              m_clients.pop_back();
+              throw;
+            }
+
+            updateEntityState(m_clients.size());
+
+            debug("accepted connection from %s:%u, client count is %lu",
+                  c.address.c_str(), c.port, (long unsigned int)m_clients.size());
+          }
+          catch (std::runtime_error& e)
+          {
+            if (c.socket)
+              delete c.socket;
+            err(DTR("error accepting new client connection: %s"), e.what());
           }
         }
       };
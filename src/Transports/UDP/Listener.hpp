@@ -51,13 +51,16 @@ namespace Transports
     {
     public:
       Listener(Tasks::Task& task, UDPSocket& sock, LimitedComms* lcomms,
-               float contact_timeout, bool trace = false):
+               float contact_timeout, bool trace = false, bool raw_frames = false):
         m_task(task),
         m_sock(sock),
         m_trace(trace),
+        m_raw_frames(raw_frames),
         m_contacts(contact_timeout),
         m_lcomms(lcomms)
-      {  }
+      {
+        m_reactor.add(m_sock, IO::Reactor::EV_READ);
+      }
 
       void
       getContacts(std::vector<Contact>& list)
@@ -80,70 +83,110 @@ namespace Transports
     private:
       // Buffer capacity.
       static const int c_bfr_size = 65535;
-      // Poll timeout in milliseconds.
-      static const int c_poll_tout = 1000;
+      // Maximum number of datagrams received per wake up.
+      static const size_t c_max_datagrams = 8;
       // Parent task.
       Tasks::Task& m_task;
       // Reference to socket used for sending data.
       UDPSocket& m_sock;
       // True to print incoming messages.
       bool m_trace;
+      // True to attach received frames to incoming messages.
+      bool m_raw_frames;
       // Table of contacts.
       ContactTable m_contacts;
       // Lock to serialize access to m_contacts.
       RWLock m_contacts_lock;
       // LimitedComms object
       LimitedComms* m_lcomms;
+      // Waits for datagrams, woken up when stopping.
+      IO::Reactor m_reactor;
+      // Ready events.
+      std::vector<IO::Reactor::Event> m_events;
 
       void
-      run(void)
+      stopImpl(void)
       {
-        Address addr;
-        uint8_t* bfr = new uint8_t[c_bfr_size];
-        double poll_tout = c_poll_tout / 1000.0;
+        Concurrency::Thread::stopImpl();
+        m_reactor.wakeup();
+      }
 
-        while (!isStopping())
+      //! Handle a received datagram.
+      //! @param[in] bfr datagram.
+      //! @param[in] size datagram size.
+      //! @param[in] addr source address.
+      void
+      handleDatagram(const uint8_t* bfr, size_t size, const Address& addr)
+      {
+        try
         {
-          try
-          {
-            if (!Poll::poll(m_sock, poll_tout))
-              continue;
+          IMC::PacketView pkt(bfr, (uint16_t)size);
+          IMC::Message* msg = pkt.materialize();
+          if (m_raw_frames)
+            msg->setRawFrame(pkt.getData(), pkt.getSize());
 
-            uint16_t rv = m_sock.read(bfr, c_bfr_size, &addr);
-            IMC::Message* msg = IMC::Packet::deserialize(bfr, rv);
+          if (m_lcomms->isActive())
+          {
+            if (msg->getId() == DUNE_IMC_ANNOUNCE)
+            {
+              m_lcomms->setAnnounce(static_cast<IMC::Announce*>(msg));
+            }
 
-            if (m_lcomms->isActive())
+            if (!m_lcomms->isNodeWithinRange(msg->getSource(), msg->getId()))
             {
-              if (msg->getId() == DUNE_IMC_ANNOUNCE)
-              {
-                m_lcomms->setAnnounce(static_cast<IMC::Announce*>(msg));
-              }
-
-              if (!m_lcomms->isNodeWithinRange(msg->getSource(), msg->getId()))
-              {
-                delete msg;
-                continue;
-              }
+              delete msg;
+              return;
             }
+          }
+
+          m_contacts_lock.lockWrite();
+          m_contacts.update(msg->getSource(), addr);
+          m_contacts_lock.unlock();
+
+          m_task.dispatch(msg, DF_KEEP_TIME | DF_KEEP_SRC_EID);
 
-            m_contacts_lock.lockWrite();
-            m_contacts.update(msg->getSource(), addr);
-            m_contacts_lock.unlock();
+          if (m_trace)
+            msg->toText(std::cerr);
 
-            m_task.dispatch(msg, DF_KEEP_TIME | DF_KEEP_SRC_EID);
+          delete msg;
+        }
+        catch (std::exception & e)
+        {
+          m_task.debug("error while unpacking message: %s",e.what());
+        }
+      }
+
+      void
+      run(void)
+      {
+        std::vector<uint8_t> storage(c_max_datagrams * c_bfr_size);
+        uint8_t* bfrs[c_max_datagrams];
+        size_t sizes[c_max_datagrams];
+        Address addrs[c_max_datagrams];
 
-            if (m_trace)
-              msg->toText(std::cerr);
+        for (size_t i = 0; i < c_max_datagrams; ++i)
+          bfrs[i] = &storage[i * c_bfr_size];
 
-            delete msg;
+        while (!isStopping())
+        {
+          try
+          {
+            if (m_reactor.wait(-1.0, m_events) == 0)
+              continue;
+
+            // Drain the datagrams that are already queued.
+            for (size_t i = 0; i < c_max_datagrams; ++i)
+              sizes[i] = c_bfr_size;
+
+            size_t count = m_sock.readBatch(bfrs, sizes, addrs, NULL, c_max_datagrams);
+            for (size_t i = 0; i < count; ++i)
+              handleDatagram(bfrs[i], sizes[i], addrs[i]);
           }
           catch (std::exception & e)
           {
-            m_task.debug("error while unpacking message: %s",e.what());
+            m_task.debug("error while receiving datagrams: %s", e.what());
           }
         }
-
-        delete [] bfr;
       }
     };
   }
@@ -39,6 +39,9 @@
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
 
+// Local headers.
+#include "OutputBatch.hpp"
+
 namespace Transports
 {
   namespace UDP
@@ -137,22 +140,15 @@ namespace Transports
         return true;
       }
 
-      //! Send data to node.
-      //! @param[in] sock UDP destination socket.
-      //! @param[in] data data to be transmitted.
-      //! @param[in] data_len length of data to be transmitted.
+      //! Queue the last message of a batch for transmission to node.
+      //! @param[in] batch output batch.
       void
-      send(UDPSocket& sock, const uint8_t* data, unsigned data_len)
+      send(OutputBatch& batch)
       {
         if (m_active == m_addrs.end())
           return;
 
-        try
-        {
-          sock.write(data, data_len, m_active->first, m_active->second);
-        }
-        catch (...)
-        { }
+        batch.addDestination(m_active->first, m_active->second);
       }
 
     private:
@@ -97,7 +97,7 @@ namespace Transports
       }
 
       void
-      send(UDPSocket& sock, const uint8_t* data, unsigned data_len, unsigned msgid)
+      send(OutputBatch& batch, unsigned msgid)
       {
         if (m_lcomms != NULL)
         {
@@ -106,7 +106,7 @@ namespace Transports
             for (Table::iterator itr = m_table.begin(); itr != m_table.end(); ++itr)
             {
               if (m_lcomms->isNodeWithinRange(itr->first, msgid))
-                itr->second.send(sock, data, data_len);
+                itr->second.send(batch);
             }
 
             return;
@@ -114,7 +114,7 @@ namespace Transports
         }
 
         for (Table::iterator itr = m_table.begin(); itr != m_table.end(); ++itr)
-          itr->second.send(sock, data, data_len);
+          itr->second.send(batch);
       }
 
       void
@@ -0,0 +1,115 @@
+//***************************************************************************
+// Copyright 2007-2017 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: agent                                                            *
+//***************************************************************************
+
+#ifndef TRANSPORTS_UDP_OUTPUT_BATCH_HPP_INCLUDED_
+#define TRANSPORTS_UDP_OUTPUT_BATCH_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cstddef>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+namespace Transports
+{
+  namespace UDP
+  {
+    using DUNE_NAMESPACES;
+
+    //! Datagrams waiting to be sent. The messages consumed in one
+    //! iteration of the task are sent to all their destinations
+    //! with batched writes instead of one write per destination.
+    class OutputBatch
+    {
+    public:
+      //! Queue a message. Its destinations are added next.
+      //! @param[in] frame serialized message.
+      void
+      addMessage(const IMC::RawFrame& frame)
+      {
+        m_frames.push_back(frame);
+      }
+
+      //! Add a destination of the last queued message.
+      //! @param[in] addr destination address.
+      //! @param[in] port destination port.
+      void
+      addDestination(const Address& addr, uint16_t port)
+      {
+        const IMC::RawFrame& frame = m_frames.back();
+        m_bfrs.push_back(frame.getData());
+        m_sizes.push_back(frame.getSize());
+        m_addrs.push_back(addr);
+        m_ports.push_back(port);
+      }
+
+      //! Retrieve the number of queued datagrams.
+      //! @return number of datagrams.
+      size_t
+      getSize(void) const
+      {
+        return m_bfrs.size();
+      }
+
+      //! Send all queued datagrams and empty the batch.
+      //! @param[in] sock socket.
+      //! @return number of datagrams sent.
+      size_t
+      flush(UDPSocket& sock)
+      {
+        size_t sent = 0;
+
+        if (!m_bfrs.empty())
+          sent = sock.writeBatch(&m_bfrs[0], &m_sizes[0], &m_addrs[0], &m_ports[0], m_bfrs.size());
+
+        m_frames.clear();
+        m_bfrs.clear();
+        m_sizes.clear();
+        m_addrs.clear();
+        m_ports.clear();
+        return sent;
+      }
+
+    private:
+      //! Queued messages, which own the datagram buffers.
+      std::vector<IMC::RawFrame> m_frames;
+      //! Datagram buffers.
+      std::vector<const uint8_t*> m_bfrs;
+      //! Datagram sizes.
+      std::vector<size_t> m_sizes;
+      //! Destination addresses.
+      std::vector<Address> m_addrs;
+      //! Destination ports.
+      std::vector<uint16_t> m_ports;
+    };
+  }
+}
+
+#endif
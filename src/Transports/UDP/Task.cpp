@@ -42,6 +42,7 @@
 #include "NodeTable.hpp"
 #include "Listener.hpp"
 #include "LimitedComms.hpp"
+#include "OutputBatch.hpp"
 
 namespace Transports
 {
@@ -84,12 +85,16 @@ namespace Transports
       bool only_local;
       // Optional custom service type
       std::string custom_service;
+      // Attach received frames to incoming messages.
+      bool raw_frames;
     };
 
     // Internal buffer size.
     static const int c_bfr_size = 65535;
     // Port bind retries.
     static const int c_port_retries = 5;
+    // Number of queued datagrams that triggers a transmission.
+    static const size_t c_max_batch = 256;
 
     struct Task: public DUNE::Tasks::Task
     {
@@ -115,6 +120,8 @@ namespace Transports
       LimitedComms* m_lcomms;
       //! Message Filter
       MessageFilter m_filter;
+      //! Datagrams waiting to be sent.
+      OutputBatch m_batch;
 
       Task(const std::string& name, Tasks::Context& ctx):
         DUNE::Tasks::Task(name, ctx),
@@ -184,6 +191,12 @@ namespace Transports
         .defaultValue("")
         .description("Optional custom service type (imc+udp+<Custom Service Type>), empty entry gives default service (imc+udp)");
 
+        param("Keep Raw Frames", m_args.raw_frames)
+        .defaultValue("false")
+        .description("Keep a copy of each received packet with the incoming"
+                     " message, so that it can be forwarded or logged without"
+                     " being serialized again");
+
         // Allocate space for internal buffer.
         m_bfr = new uint8_t[c_bfr_size];
 
@@ -299,7 +312,8 @@ namespace Transports
 
         // Start listener thread.
         m_listener = new Listener(*this, m_sock, m_lcomms,
-                                  m_args.contact_timeout, m_args.trace_in);
+                                  m_args.contact_timeout, m_args.trace_in,
+                                  m_args.raw_frames);
         m_listener->start();
 
         setEntityState(IMC::EntityState::ESTA_NORMAL, Status::CODE_ACTIVE);
@@ -339,25 +353,30 @@ namespace Transports
         if (m_args.trace_out)
           msg->toText(std::cerr);
 
-        uint16_t rv = IMC::Packet::serialize(msg, m_bfr, c_bfr_size);
+        // Forward the bytes the message was received with, if any.
+        IMC::RawFrame frame = msg->getRawFrame();
+
+        if (frame.isNull())
+        {
+          uint16_t rv = IMC::Packet::serialize(msg, m_bfr, c_bfr_size);
+          frame = IMC::RawFrame(m_bfr, rv);
+        }
+
+        m_batch.addMessage(frame);
 
         // Send to static nodes.
         std::set<NodeAddress>::iterator itr = m_static_dsts.begin();
         for (; itr != m_static_dsts.end(); ++itr)
-        {
-          try
-          {
-            m_sock.write(m_bfr, rv, itr->getAddress(), itr->getPort());
-          }
-          catch (...)
-          { }
-        }
+          m_batch.addDestination(itr->getAddress(), itr->getPort());
 
         if (m_args.dynamic_nodes)
         {
           // Send to dynamic nodes.
-          m_node_table.send(m_sock, m_bfr, rv, msg->getId());
+          m_node_table.send(m_batch, msg->getId());
         }
+
+        if (m_batch.getSize() >= c_max_batch)
+          m_batch.flush(m_sock);
       }
 
       void
@@ -411,6 +430,9 @@ namespace Transports
         {
           waitForMessages(1.0);
 
+          // Send the messages consumed in this iteration.
+          m_batch.flush(m_sock);
+
           // Check if it's time to update the contact list.
           if (m_contacts_refresh_counter.overflow())
           {